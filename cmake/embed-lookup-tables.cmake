@@ -0,0 +1,146 @@
+# Copyright (c) 2024 Jakob Rühlow
+#
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+#
+# Converts csv lookup tables (in_angle,out_angle,gain_dB,phase_shift) into a C++ source holding
+# them as constant data, see IrsLookupTableIo::ReadEmbedded. Run as a script:
+#   cmake -DOUTPUT=<file.cc> -DTABLES=<a.csv|b.csv|...> -P embed-lookup-tables.cmake
+# Each table is named after its file without the .csv extension. The resolution, the frequency
+# and whether the rows are a complete grid in order are worked out here as well, so reading an
+# embedded table does not scan its rows.
+
+if(NOT OUTPUT)
+    message(FATAL_ERROR "OUTPUT is required")
+endif()
+string(REPLACE "|" ";" tables "${TABLES}")
+
+# Angle in thousandths of a degree, to check the grid with integer math
+function(irs_milli_degrees table value result)
+    if(NOT value MATCHES "^([0-9]*)(\\.([0-9]*))?$")
+        message(FATAL_ERROR "${table} has the angle ${value}, which is not a plain number")
+    endif()
+    set(whole "${CMAKE_MATCH_1}")
+    set(fraction "${CMAKE_MATCH_3}000")
+    string(SUBSTRING "${fraction}" 3 -1 rest)
+    if(NOT rest MATCHES "^0*$")
+        message(FATAL_ERROR "${table} has the angle ${value} finer than 0.001 degrees")
+    endif()
+    string(SUBSTRING "${fraction}" 0 3 fraction)
+    if(whole STREQUAL "")
+        set(whole 0)
+    endif()
+    math(EXPR milli "${whole} * 1000 + ${fraction}")
+    set(${result} ${milli} PARENT_SCOPE)
+endfunction()
+
+function(irs_gcd a b result)
+    while(NOT b EQUAL 0)
+        math(EXPR r "${a} % ${b}")
+        set(a ${b})
+        set(b ${r})
+    endwhile()
+    set(${result} ${a} PARENT_SCOPE)
+endfunction()
+
+set(source "// Generated by cmake/embed-lookup-tables.cmake, do not edit.\n\n")
+string(APPEND source "#include \"ns3/irs-lookup-table-io.h\"\n\n")
+string(APPEND source "namespace ns3\n{\n\nnamespace\n{\n\n")
+set(descriptors "")
+set(count 0)
+foreach(table IN LISTS tables)
+    if(table STREQUAL "")
+        continue()
+    endif()
+    get_filename_component(name "${table}" NAME_WLE)
+    file(READ "${table}" content)
+    string(REPLACE "\r" "" content "${content}")
+    # drop the header line, the rows must be plain numbers
+    string(REGEX REPLACE "^[^\n]*[A-Za-z_][^\n]*\n" "" content "${content}")
+    string(STRIP "${content}" content)
+    if(NOT content MATCHES "^[-+0-9.eE,\n]+$")
+        message(FATAL_ERROR "${table} is not a lookup table with numeric rows")
+    endif()
+    set(row "([^,\n]+),([^,\n]+),([^,\n]+),([^,\n]+)")
+    string(REGEX REPLACE "${row}" "{\\1, \\2}," angles "${content}")
+    string(REGEX REPLACE "${row}" "{\\3, \\4}," entries "${content}")
+    string(REGEX MATCHALL "\n" lines "${content}")
+    list(LENGTH lines rows)
+    math(EXPR rows "${rows} + 1")
+
+    # the grid step divides 180 degrees and every angle, as in IrsLookupTableIo::ReadCsv, so
+    # only the distinct angles are converted
+    string(REGEX REPLACE "${row}" "\\1" inColumn "${content}")
+    string(REGEX REPLACE "${row}" "\\2" outColumn "${content}")
+    string(REPLACE "\n" ";" values "${inColumn}\n${outColumn}")
+    list(REMOVE_DUPLICATES values)
+    set(divisor 180000)
+    set(sorted "")
+    foreach(value IN LISTS values)
+        irs_milli_degrees("${table}" "${value}" milli)
+        irs_gcd(${divisor} ${milli} divisor)
+        string(LENGTH "${milli}" digits)
+        math(EXPR padding "6 - ${digits}")
+        string(REPEAT "0" ${padding} zeros)
+        list(APPEND sorted "${zeros}${milli}:${value}")
+    endforeach()
+    list(SORT sorted)
+    # the coarsest step of at most one degree
+    set(steps 179)
+    set(remainder 1)
+    while(NOT remainder EQUAL 0)
+        math(EXPR steps "${steps} + 1")
+        math(EXPR step "180000 / ${steps}")
+        math(EXPR remainder "180000 % ${steps} + ${divisor} % ${step}")
+    endwhile()
+
+    # the rows are a complete grid in order if both columns match the grid row by row
+    list(LENGTH sorted numValues)
+    math(EXPR numAngles "${steps} + 1")
+    set(inGridOrder false)
+    if(numValues EQUAL numAngles)
+        set(gridIn "")
+        set(gridOut "")
+        set(k 0)
+        foreach(entry IN LISTS sorted)
+            string(REGEX REPLACE "^[0-9]+:" "" value "${entry}")
+            string(REGEX REPLACE ":.*$" "" milli "${entry}")
+            math(EXPR expected "${k} * ${step}")
+            if(NOT milli EQUAL expected)
+                break()
+            endif()
+            string(REPEAT "${value}\n" ${numAngles} repeated)
+            string(APPEND gridIn "${repeated}")
+            string(APPEND gridOut "${value}\n")
+            math(EXPR k "${k} + 1")
+        endforeach()
+        string(REPEAT "${gridOut}" ${numAngles} gridOut)
+        if(k EQUAL numAngles AND "${inColumn}\n" STREQUAL gridIn AND
+           "${outColumn}\n" STREQUAL gridOut)
+            set(inGridOrder true)
+        endif()
+    endif()
+
+    set(frequency 0)
+    if(name MATCHES "FREQ([0-9]+(\\.[0-9]+)?)GHz")
+        set(frequency "${CMAKE_MATCH_1}e9")
+    endif()
+
+    string(APPEND source "// ${name}\n")
+    string(APPEND source "const float kAngles${count}[][2] = {\n${angles}\n};\n")
+    string(APPEND source "const IrsEntry kEntries${count}[] = {\n${entries}\n};\n\n")
+    string(APPEND descriptors "    {\"${name}\", kAngles${count}, kEntries${count}, ${rows}, "
+                              "180.0 / ${steps}, ${frequency}, ${inGridOrder}},\n")
+    math(EXPR count "${count} + 1")
+endforeach()
+
+string(APPEND source "} // namespace\n\n")
+string(APPEND source "const IrsEmbeddedLookupTable g_irsEmbeddedLookupTables[] = {\n")
+string(APPEND source "${descriptors}    {nullptr, nullptr, nullptr, 0, 0, 0, false},\n};\n\n")
+string(APPEND source "} // namespace ns3\n")
+
+# only touch the output if it changed, so the library is not rebuilt needlessly
+file(WRITE "${OUTPUT}.tmp" "${source}")
+file(COPY_FILE "${OUTPUT}.tmp" "${OUTPUT}" ONLY_IF_DIFFERENT)
+file(REMOVE "${OUTPUT}.tmp")
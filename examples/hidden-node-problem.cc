@@ -114,8 +114,7 @@ RunSimulation(bool useIRS,
     {
         IrsLookupHelper irsHelper;
         irsHelper.SetDirection(Vector(0, 1, 0));
-        irsHelper.SetLookupTable(
-            "contrib/irs/examples/lookuptables/IRS_625_IN135_OUT90_FREQ5.15GHz_hidden_node.csv");
+        irsHelper.SetEmbeddedLookupTable("IRS_625_IN135_OUT90_FREQ5.15GHz_hidden_node");
         irsHelper.Install(irsNode);
 
         Ptr<LogDistancePropagationLossModel> irsModel =
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ * Description: Check that lookups of an IrsSpectrumModel do not allocate once its caches are
+ * warm. The heap allocations are counted by replacing the allocation functions of the whole
+ * program, which is why the check is a program of its own instead of a test case of the
+ * test-runner: the irs-allocation-check test suite runs it and compares its output with
+ * test/irs-allocation-check.reflog.
+ *
+ * With glibc, malloc, calloc, realloc, free and the aligned variants are replaced by counting
+ * wrappers around the allocator of glibc, so the allocations of Eigen are counted as well.
+ * Elsewhere, and with sanitizers that replace the allocator themselves, only operator new is
+ * counted.
+ */
+
+#include "ns3/angles.h"
+#include "ns3/command-line.h"
+#include "ns3/irs-lookup-table-generator.h"
+#include "ns3/irs-spectrum-model.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+using namespace ns3;
+
+/// Whether heap allocations are counted
+static std::atomic<bool> g_countAllocations{false};
+/// Number of heap allocations while counting
+static std::atomic<uint64_t> g_allocations{0};
+
+/**
+ * @brief Count a heap allocation if counting is enabled.
+ */
+static void
+CountAllocation()
+{
+    if (g_countAllocations.load(std::memory_order_relaxed))
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+/// Counts the allocations of Eigen, which call malloc directly
+#define IRS_COUNT_MALLOC
+
+// the allocator of glibc, which the replacements below forward to, so every block is allocated
+// and freed by the same heap
+extern "C" void* __libc_malloc(std::size_t size);
+extern "C" void* __libc_calloc(std::size_t count, std::size_t size);
+extern "C" void* __libc_realloc(void* p, std::size_t size);
+extern "C" void* __libc_memalign(std::size_t alignment, std::size_t size);
+extern "C" void __libc_free(void* p);
+
+extern "C" void*
+malloc(std::size_t size) noexcept
+{
+    CountAllocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void*
+calloc(std::size_t count, std::size_t size) noexcept
+{
+    CountAllocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void*
+realloc(void* p, std::size_t size) noexcept
+{
+    CountAllocation();
+    return __libc_realloc(p, size);
+}
+
+extern "C" void*
+memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    CountAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void*
+aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    CountAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int
+posix_memalign(void** p, std::size_t alignment, std::size_t size) noexcept
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return EINVAL;
+    }
+    CountAllocation();
+    void* block = __libc_memalign(alignment, size);
+    if (!block)
+    {
+        return ENOMEM;
+    }
+    *p = block;
+    return 0;
+}
+
+extern "C" void
+free(void* p) noexcept
+{
+    __libc_free(p);
+}
+#else
+void*
+operator new(std::size_t size)
+{
+    CountAllocation();
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#endif
+
+/**
+ * @brief Look up a sweep of direction pairs.
+ * @param irs The IRS
+ * @param offset Azimuth offset of the sweep in degrees, new directions for every offset
+ */
+static void
+Sweep(Ptr<IrsSpectrumModel> irs, double offset)
+{
+    double lambda = 299792458.0 / irs->GetFrequency();
+    for (uint32_t i = 0; i < 40; ++i)
+    {
+        Angles in(DegreesToRadians(offset + 0.5 + i), DegreesToRadians(10.5 + i % 7));
+        Angles out(DegreesToRadians(offset + 90.5 - i), DegreesToRadians(20.5 + i % 5));
+        irs->GetIrsEntry(in, out, lambda);
+        irs->GetIrsEntry(in, out, lambda);
+    }
+}
+
+/**
+ * @brief Count the heap allocations of a sweep and print them.
+ * @param name Name of the lookups
+ * @param irs The IRS
+ * @param offset Azimuth offset of the sweep in degrees
+ */
+static void
+CountSweep(const std::string& name, Ptr<IrsSpectrumModel> irs, double offset)
+{
+    g_allocations = 0;
+    g_countAllocations = true;
+    Sweep(irs, offset);
+    g_countAllocations = false;
+    std::cout << name << ": " << g_allocations.load() << " allocations" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    CommandLine cmd(__FILE__);
+    cmd.Parse(argc, argv);
+
+    // the counters must see the allocations of both the standard library and Eigen
+    g_allocations = 0;
+    g_countAllocations = true;
+    auto counted = std::make_unique<int>(1);
+    g_countAllocations = false;
+    if (g_allocations.load() == 0)
+    {
+        std::cerr << "operator new is not counted" << std::endl;
+        return 1;
+    }
+#ifdef IRS_COUNT_MALLOC
+    g_allocations = 0;
+    g_countAllocations = true;
+    Eigen::VectorXcd vector(100);
+    g_countAllocations = false;
+    if (g_allocations.load() == 0)
+    {
+        std::cerr << "malloc is not counted" << std::endl;
+        return 1;
+    }
+#endif
+
+    Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 20, 5.21e9);
+    IrsLookupTableGenerator::Steer(irs, 135, 45);
+    irs->SetSeparableEvaluation(false);
+    irs->SetCacheCapacity(16);
+
+    // the slots allocate their vectors when first filled, so the caches are warmed up first
+    Sweep(irs, 0);
+    uint64_t misses = irs->GetCacheMisses();
+    CountSweep("Cache evictions", irs, 100);
+    if (irs->GetCacheMisses() == misses || irs->GetCacheEvictions() == 0)
+    {
+        std::cerr << "Sweep did not evict" << std::endl;
+        return 1;
+    }
+
+    // stale slots are refilled in place
+    irs->SetRcoeffs(-irs->GetRcoeffs());
+    CountSweep("Stale slots", irs, 100);
+
+    // uncached lookups run the array response kernel, grid-anchored and separable lookups
+    // reuse their scratch vectors
+    irs->SetCacheCapacity(0);
+    CountSweep("Uncached lookups", irs, 200);
+    irs->SetCacheCapacity(16);
+    irs->SetGridResolution(0.5);
+    Sweep(irs, 200);
+    CountSweep("Grid-anchored lookups", irs, 250);
+    irs->SetGridResolution(0);
+    irs->SetSeparableEvaluation(true);
+    irs->SetRcoeffs(-irs->GetRcoeffs());
+    if (!irs->IsSeparable())
+    {
+        std::cerr << "Steered IRS not separable" << std::endl;
+        return 1;
+    }
+    CountSweep("Separable lookups", irs, 300);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ * Description: Microbenchmark for the uncached evaluation of an IrsSpectrumModel. The previous
+ * evaluation with two steering vectors and an element-wise product is compared against the
+ * IrsArrayResponseKernel on every instruction set this CPU supports, for surfaces of 10x10,
+ * 20x20 (as in irs-mobility.cc) and 64x64 elements.
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/irs-array-response-kernel.h"
+#include "ns3/irs-lookup-table-generator.h"
+#include "ns3/irs-spectrum-model.h"
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+using namespace std::chrono;
+
+/**
+ * Run the given evaluation for all direction pairs and print the average time per evaluation.
+ * @param name Name of the benchmarked evaluation
+ * @param directions Incoming and outgoing direction pairs
+ * @param evaluate Evaluation function, returning the complex response
+ */
+template <typename F>
+void
+RunBenchmark(const std::string& name,
+             const std::vector<std::pair<Angles, Angles>>& directions,
+             F evaluate)
+{
+    // accumulate the results, so the evaluations can not be optimized away
+    std::complex<double> checksum = 0;
+    auto start = high_resolution_clock::now();
+    for (const auto& [in, out] : directions)
+    {
+        checksum += evaluate(in, out);
+    }
+    auto stop = high_resolution_clock::now();
+    double ns = duration_cast<nanoseconds>(stop - start).count();
+
+    std::cout << "  " << name << ": " << ns / directions.size() << " ns/evaluation (checksum "
+              << checksum.real() + checksum.imag() << ")" << std::endl;
+}
+
+/**
+ * Get the sum of the wave vectors of a direction pair.
+ * @param in Incoming direction
+ * @param out Outgoing direction
+ * @param lambda Wavelength in meters
+ * @return The sum of both wave vectors
+ */
+Eigen::Vector3d
+CalcWaveVectorSum(Angles in, Angles out, double lambda)
+{
+    Eigen::Vector3d k = Eigen::Vector3d::Zero();
+    for (const Angles& angle : {in, out})
+    {
+        k += Eigen::Vector3d(std::cos(angle.GetInclination()) * std::cos(angle.GetAzimuth()),
+                             std::cos(angle.GetInclination()) * std::sin(angle.GetAzimuth()),
+                             std::sin(angle.GetInclination()));
+    }
+    return 2 * M_PI / lambda * k;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numEvaluations = 200000;
+    uint32_t seed = 2024;
+    double frequency = 5.21e9;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("evaluations", "Number of random direction pairs per surface", numEvaluations);
+    cmd.AddValue("seed", "Seed of the random direction pairs", seed);
+    cmd.AddValue("frequency", "Frequency of the IRS in Hz", frequency);
+    cmd.Parse(argc, argv);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> azimuth(-M_PI, M_PI);
+    std::uniform_real_distribution<double> inclination(-M_PI / 2, M_PI / 2);
+    std::vector<std::pair<Angles, Angles>> directions(numEvaluations);
+    for (auto& direction : directions)
+    {
+        Angles in(azimuth(rng), inclination(rng));
+        direction = {in, Angles(azimuth(rng), inclination(rng))};
+    }
+    double lambda = 299792458.0 / frequency;
+
+    std::cout << "IrsSpectrumModel uncached evaluation benchmark, " << numEvaluations
+              << " random direction pairs, widest instruction set "
+              << IrsArrayResponseKernel::GetIsaName(IrsArrayResponseKernel::GetBestIsa())
+              << std::endl;
+    for (uint16_t n : {10, 20, 64})
+    {
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(n, n, frequency);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        std::cout << n << "x" << n << " elements" << std::endl;
+
+        Eigen::MatrixX3d elementPos = irs->GetElementPos();
+        Eigen::VectorXcd rcoeffs = irs->GetRcoeffs();
+
+        // the evaluation CalcIrsEntry used previously
+        RunBenchmark("steering vectors",
+                     directions,
+                     [&irs, &elementPos, &rcoeffs, lambda](Angles in, Angles out) {
+                         Eigen::VectorXcd stvIn = irs->CalcSteeringvector(in, lambda, elementPos);
+                         Eigen::VectorXcd stvOut = irs->CalcSteeringvector(out, lambda, elementPos);
+                         return (stvIn.array() * rcoeffs.array() * stvOut.array()).sum();
+                     });
+
+        IrsArrayResponseKernel kernel;
+        kernel.SetElements(elementPos, rcoeffs);
+        for (auto isa : {IrsArrayResponseKernel::SCALAR,
+                         IrsArrayResponseKernel::AVX2,
+                         IrsArrayResponseKernel::AVX512})
+        {
+            if (!IrsArrayResponseKernel::IsSupported(isa))
+            {
+                std::cout << "  kernel " << IrsArrayResponseKernel::GetIsaName(isa)
+                          << ": not supported" << std::endl;
+                continue;
+            }
+            kernel.SetIsa(isa);
+            RunBenchmark("kernel " + IrsArrayResponseKernel::GetIsaName(isa),
+                         directions,
+                         [&kernel, lambda](Angles in, Angles out) {
+                             return kernel.Evaluate(CalcWaveVectorSum(in, out, lambda));
+                         });
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ * Description: Microbenchmark for IrsLookupTable lookups and loading. The dense angle-indexed
+ * storage is compared against the std::unordered_map storage the table used previously. Loading a
+ * 32k row csv table with the previous stringstream parser, with IrsLookupTableIo::ReadCsv, by
+ * memory-mapping the same table in binary format and from the copy embedded in the library are
+ * compared as well, and lookups in tables with quantized, low-rank and sparse storage. Only the
+ * csv loads read the table from the source tree, they are skipped if it is not found.
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/irs-lookup-table-io.h"
+#include "ns3/irs-lookup-table.h"
+#include "ns3/log.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+using namespace std::chrono;
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableBenchmark");
+
+/**
+ * Hash of the previous map based storage.
+ */
+struct hash_tuple
+{
+    std::size_t operator()(const std::pair<uint8_t, uint8_t>& p) const
+    {
+        uint16_t combined = (static_cast<uint16_t>(p.first) << 8) | static_cast<uint16_t>(p.second);
+        return std::hash<uint16_t>{}(combined);
+    }
+};
+
+typedef std::unordered_map<std::pair<uint8_t, uint8_t>, IrsEntry, hash_tuple> IrsLookupMap;
+
+/**
+ * The csv parser IrsLookupHelper used previously, one stringstream per line.
+ * @param filename Path to the csv file
+ * @return The lookup table
+ */
+Ptr<IrsLookupTable>
+ReadCsvStringstream(const std::string& filename)
+{
+    std::ifstream file(filename);
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line))
+    {
+        std::stringstream ss(line);
+        std::string item;
+        uint8_t in_angle, out_angle;
+        double gain, phase_shift;
+
+        std::getline(ss, item, ',');
+        in_angle = std::stoi(item);
+        std::getline(ss, item, ',');
+        out_angle = std::stoi(item);
+        std::getline(ss, item, ',');
+        gain = std::stod(item);
+        std::getline(ss, item, ',');
+        phase_shift = std::stod(item);
+
+        table->Insert(in_angle, out_angle, gain, phase_shift);
+    }
+    return table;
+}
+
+/**
+ * Run the given lookup function for all queries and print the average time per lookup.
+ * @param name Name of the benchmarked storage
+ * @param queries Angle pairs to look up
+ * @param lookup Lookup function
+ */
+template <typename F>
+void
+RunBenchmark(const std::string& name,
+             const std::vector<std::pair<uint8_t, uint8_t>>& queries,
+             F lookup)
+{
+    // accumulate the results, so the lookups can not be optimized away
+    double checksum = 0;
+    auto start = high_resolution_clock::now();
+    for (const auto& query : queries)
+    {
+        IrsEntry entry = lookup(query.first, query.second);
+        checksum += entry.gain + entry.phase_shift;
+    }
+    auto stop = high_resolution_clock::now();
+    double ns = duration_cast<nanoseconds>(stop - start).count();
+
+    std::cout << name << ": " << ns / queries.size() << " ns/lookup (checksum " << checksum << ")"
+              << std::endl;
+}
+
+/**
+ * Load the given table repeatedly and print the average load time.
+ * @param name Name of the benchmarked format
+ * @param repetitions Number of loads
+ * @param load Load function
+ */
+template <typename F>
+void
+RunLoadBenchmark(const std::string& name, uint32_t repetitions, F load)
+{
+    double checksum = 0;
+    auto start = high_resolution_clock::now();
+    for (uint32_t i = 0; i < repetitions; ++i)
+    {
+        Ptr<IrsLookupTable> table = load();
+        checksum += table->GetIrsEntry(90, 90).gain;
+    }
+    auto stop = high_resolution_clock::now();
+    double us = duration_cast<microseconds>(stop - start).count();
+
+    std::cout << name << ": " << us / 1000 / repetitions << " ms/load (checksum " << checksum
+              << ")" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t numQueries = 10000000;
+    uint32_t numLoads = 20;
+    uint32_t seed = 2024;
+    std::string name = "IRS_400_IN135_OUT89_FREQ5.15GHz_constructive";
+    std::string csv = "contrib/irs/examples/lookuptables/validation/" + name + ".csv";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("queries", "Number of random lookups per storage", numQueries);
+    cmd.AddValue("loads", "Number of loads per table format", numLoads);
+    cmd.AddValue("seed", "Seed of the random angle pairs", seed);
+    cmd.AddValue("table", "Embedded lookup table used for the storage and load benchmarks", name);
+    cmd.AddValue("csv", "csv file of the table, for the csv load benchmarks", csv);
+    cmd.Parse(argc, argv);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> value(-50, 50);
+    std::uniform_int_distribution<int> angle(0, IrsLookupTable::N_ANGLES - 1);
+
+    // fill both storages with the same full 181x181 grid
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    IrsLookupMap map;
+    for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+    {
+        for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+        {
+            IrsEntry entry{value(rng), value(rng) / 10};
+            table->Insert(in, out, entry.gain, entry.phase_shift);
+            map[{in, out}] = entry;
+        }
+    }
+
+    std::vector<std::pair<uint8_t, uint8_t>> queries(numQueries);
+    for (auto& query : queries)
+    {
+        query = {angle(rng), angle(rng)};
+    }
+
+    std::cout << "IrsLookupTable lookup benchmark, " << numQueries << " random lookups"
+              << std::endl;
+    RunBenchmark("unordered_map", queries, [&map](uint8_t in, uint8_t out) {
+        return map.find({in, out})->second;
+    });
+    RunBenchmark("IrsLookupTable", queries, [&table](uint8_t in, uint8_t out) {
+        return table->GetIrsEntry(in, out);
+    });
+    // fractional angles between the grid points
+    RunBenchmark("IrsLookupTable nearest", queries, [&table](uint8_t in, uint8_t out) {
+        return table->GetNearestIrsEntry(in + 0.3, out + 0.6);
+    });
+    RunBenchmark("IrsLookupTable interpolated", queries, [&table](uint8_t in, uint8_t out) {
+        return table->GetInterpolatedIrsEntry(in + 0.3, out + 0.6);
+    });
+    Ptr<IrsLookupTable> quantized = table->Convert(IrsLookupTable::QUANTIZED);
+    std::cout << "memory: dense " << table->GetMemoryUsage() / 1024 << " KiB, quantized "
+              << quantized->GetMemoryUsage() / 1024 << " KiB" << std::endl;
+    RunBenchmark("IrsLookupTable quantized", queries, [&quantized](uint8_t in, uint8_t out) {
+        return quantized->GetIrsEntry(in, out);
+    });
+    RunBenchmark("IrsLookupTable quantized interpolated",
+                 queries,
+                 [&quantized](uint8_t in, uint8_t out) {
+                     return quantized->GetInterpolatedIrsEntry(in + 0.3, out + 0.6);
+                 });
+    // random entries have full rank, use a real table for the low-rank storage
+    Ptr<IrsLookupTable> embedded = IrsLookupTableIo::ReadEmbedded(name);
+    Ptr<IrsLookupTable> lowRank = embedded->Convert(IrsLookupTable::LOW_RANK);
+    std::cout << "memory: low-rank " << lowRank->GetMemoryUsage() / 1024 << " KiB (rank "
+              << lowRank->GetFactorRank() << ")" << std::endl;
+    RunBenchmark("IrsLookupTable low-rank", queries, [&lowRank](uint8_t in, uint8_t out) {
+        return lowRank->GetIrsEntry(in, out);
+    });
+    Ptr<IrsLookupTable> sparse = embedded->Convert(IrsLookupTable::SPARSE);
+    std::cout << "memory: sparse " << sparse->GetMemoryUsage() / 1024 << " KiB ("
+              << sparse->GetNumSparseEntries() << " entries)" << std::endl;
+    RunBenchmark("IrsLookupTable sparse", queries, [&sparse](uint8_t in, uint8_t out) {
+        return sparse->GetIrsEntry(in, out);
+    });
+
+    std::string binary =
+        (std::filesystem::temp_directory_path() / "irs-lookup-table-benchmark.irslut").string();
+    IrsLookupTableIo::WriteBinary(embedded, binary);
+
+    std::cout << "IrsLookupTable load benchmark, " << name << std::endl;
+    if (std::filesystem::exists(csv))
+    {
+        RunLoadBenchmark("csv (stringstream)", numLoads, [&csv]() {
+            return ReadCsvStringstream(csv);
+        });
+        RunLoadBenchmark("csv (from_chars)", numLoads, [&csv]() {
+            return IrsLookupTableIo::ReadCsv(csv);
+        });
+    }
+    RunLoadBenchmark("binary", numLoads, [&binary]() {
+        return IrsLookupTableIo::ReadBinary(binary);
+    });
+    RunLoadBenchmark("embedded", numLoads, [&name]() {
+        return IrsLookupTableIo::ReadEmbedded(name);
+    });
+    std::filesystem::remove(binary);
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ * Description: Converts csv IRS lookup tables into the binary format, which can be memory-mapped
+ * by IrsLookupHelper::SetLookupTable without a parse step. 4D tables (six columns) are written
+ * in the quantized 4D format for IrsLookupHelper::SetLookupTable4D. With --storage=quantized, 2D
+ * tables are written with 16 bit entries as well (see IrsQuantizedEntry for the error bounds),
+ * with --storage=lowrank as a truncated SVD of their complex response (see --rank and
+ * --tolerance), with --storage=sparse keeping only the entries within --threshold dB of the
+ * strongest one (see --floor).
+ *
+ * Convert a single table:
+ *   ./ns3 run "irs-lookup-table-converter --input=table.csv --output=table.irslut"
+ * Convert every csv table below a directory (written next to the csv files):
+ *   ./ns3 run "irs-lookup-table-converter --input=contrib/irs/examples/lookuptables"
+ */
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/irs-lookup-table-io.h"
+#include "ns3/log.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableConverter");
+
+/**
+ * Convert a single csv table (2D or 4D) into the binary format.
+ * @param input Path to the csv table
+ * @param output Path to the binary table
+ * @param frequency Carrier frequency in Hz, taken from the file name if 0
+ * @param mode Storage mode of 2D tables
+ * @param rank Rank of low-rank tables, 0 to choose it by the tolerance
+ * @param tolerance Relative error of low-rank tables
+ * @param threshold Range below the strongest entry kept in sparse tables in dB
+ * @param floorGain Gain of the entries dropped from sparse tables in dB
+ */
+void
+Convert(const std::filesystem::path& input,
+        const std::filesystem::path& output,
+        double frequency,
+        IrsLookupTable::StorageMode mode,
+        uint32_t rank,
+        double tolerance,
+        double threshold,
+        double floorGain)
+{
+    if (frequency <= 0)
+    {
+        frequency = IrsLookupTableIo::FrequencyFromFilename(input.string());
+    }
+    if (IrsLookupTableIo::IsCsv4D(input.string()))
+    {
+        Ptr<IrsLookupTable4D> table = IrsLookupTableIo::ReadCsv4D(input.string());
+        table->SetFrequency(frequency);
+        IrsLookupTableIo::WriteBinary4D(table, output.string());
+    }
+    else
+    {
+        Ptr<IrsLookupTable> table = IrsLookupTableIo::ReadCsv(input.string());
+        table->SetFrequency(frequency);
+        table->SetRank(rank);
+        table->SetTolerance(tolerance);
+        table->SetSparseThreshold(threshold);
+        table->SetFloorGain(floorGain);
+        table->SetStorageMode(mode);
+        IrsLookupTableIo::WriteBinary(table, output.string());
+        if (mode == IrsLookupTable::LOW_RANK)
+        {
+            std::cout << input.string() << ": rank " << table->GetFactorRank() << ", "
+                      << table->GetMemoryUsage() / 1024 << " KiB" << std::endl;
+        }
+        else if (mode == IrsLookupTable::SPARSE)
+        {
+            std::cout << input.string() << ": " << table->GetNumSparseEntries() << " of "
+                      << table->GetNumAngles() * table->GetNumAngles() << " entries, "
+                      << table->GetMemoryUsage() / 1024 << " KiB" << std::endl;
+        }
+    }
+    std::cout << input.string() << " -> " << output.string() << " (" << frequency / 1e9 << " GHz)"
+              << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+    double frequency = 0;
+    std::string storage = "dense";
+    uint32_t rank = 0;
+    double tolerance = 1e-3;
+    double threshold = 30;
+    double floorGain = -100;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "csv lookup table or directory containing csv lookup tables", input);
+    cmd.AddValue("output", "binary output file (single table only, default: <input>.irslut)", output);
+    cmd.AddValue("frequency",
+                 "Carrier frequency of the table in Hz (default: parsed from the file name)",
+                 frequency);
+    cmd.AddValue("storage",
+                 "Storage of 2D tables: dense, quantized (16 bit gain and phase shift), lowrank "
+                 "(truncated SVD) or sparse (entries above a threshold only)",
+                 storage);
+    cmd.AddValue("rank", "Rank of lowrank tables (default: chosen by the tolerance)", rank);
+    cmd.AddValue("tolerance",
+                 "Maximum relative error of the complex response of lowrank tables",
+                 tolerance);
+    cmd.AddValue("threshold",
+                 "Range in dB below the strongest entry that sparse tables keep",
+                 threshold);
+    cmd.AddValue("floor", "Gain in dB of the entries dropped from sparse tables", floorGain);
+    cmd.Parse(argc, argv);
+
+    IrsLookupTable::StorageMode mode = IrsLookupTable::DENSE;
+    if (storage == "quantized")
+    {
+        mode = IrsLookupTable::QUANTIZED;
+    }
+    else if (storage == "lowrank")
+    {
+        mode = IrsLookupTable::LOW_RANK;
+    }
+    else if (storage == "sparse")
+    {
+        mode = IrsLookupTable::SPARSE;
+    }
+    else
+    {
+        NS_ABORT_MSG_IF(storage != "dense", "Unknown storage " << storage);
+    }
+
+    NS_ABORT_MSG_IF(input.empty(), "No input given, use --input=<csv file or directory>");
+
+    std::filesystem::path inputPath(input);
+    if (std::filesystem::is_directory(inputPath))
+    {
+        NS_ABORT_MSG_IF(!output.empty(), "--output can only be used for a single table");
+        for (const auto& file : std::filesystem::recursive_directory_iterator(inputPath))
+        {
+            if (file.is_regular_file() && file.path().extension() == ".csv")
+            {
+                Convert(file.path(),
+                        std::filesystem::path(file.path()).replace_extension(".irslut"),
+                        frequency,
+                        mode,
+                        rank,
+                        tolerance,
+                        threshold,
+                        floorGain);
+            }
+        }
+    }
+    else
+    {
+        Convert(inputPath,
+                output.empty() ? std::filesystem::path(inputPath).replace_extension(".irslut")
+                               : std::filesystem::path(output),
+                frequency,
+                mode,
+                rank,
+                tolerance,
+                threshold,
+                floorGain);
+    }
+
+    return 0;
+}
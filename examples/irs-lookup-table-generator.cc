@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ * Description: Generates IRS lookup tables without MATLAB, like
+ * matlab/generateIrsLookupTable.m. The IRS is steered from --in to --out (azimuth in degrees).
+ * Without --dApSta, only the steering is applied. With it, the reflection coefficients also
+ * shift the phase of the reflected path against the LOS path by --delta (0 for constructive,
+ * pi for destructive interference), scaled by --alpha and shared among --numIrs IRS. The table
+ * is written as csv (IRS_<N>_IN<in>_OUT<out>_FREQ<f>GHz[_<name>].csv, like the MATLAB script)
+ * and/or in the binary format. With --validate, the table is compared to an existing one.
+ * --patternOversampling generates the table from one FFT per input angle instead of evaluating
+ * every angle pair, which is faster for large IRS (e.g. --nr=64 --nc=64).
+ *
+ * Generate the constructive validation table:
+ *   ./ns3 run "irs-lookup-table-generator --in=135 --out=89 --frequency=5.15e9
+ *              --dApSta=50 --dApIrs=0.98995 --dIrsSta=49.30497 --name=constructive"
+ */
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/irs-lookup-table-generator.h"
+#include "ns3/irs-lookup-table-io.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableGeneratorExample");
+
+/**
+ * Print the largest deviation of a table from a reference table.
+ * @param table The generated table
+ * @param reference The reference table
+ * @param range Range in dB below the strongest reference entry that is compared
+ */
+void
+Validate(Ptr<const IrsLookupTable> table, Ptr<const IrsLookupTable> reference, double range)
+{
+    NS_ABORT_MSG_UNLESS(table->GetNumAngles() == reference->GetNumAngles(),
+                        "Reference table has a different resolution");
+    double resolution = table->GetResolution();
+    uint32_t n = table->GetNumAngles();
+    double floor = reference->GetMaxGain() - range;
+    double maxGain = 0;
+    double maxPhase = 0;
+    uint32_t compared = 0;
+    for (uint32_t in = 0; in < n; ++in)
+    {
+        for (uint32_t out = 0; out < n; ++out)
+        {
+            IrsEntry expected = reference->GetNearestIrsEntry(in * resolution, out * resolution);
+            if (expected.gain < floor)
+            {
+                continue;
+            }
+            IrsEntry entry = table->GetNearestIrsEntry(in * resolution, out * resolution);
+            double phase = std::remainder(entry.phase_shift - expected.phase_shift, 2 * M_PI);
+            maxGain = std::max(maxGain, std::abs(entry.gain - expected.gain));
+            maxPhase = std::max(maxPhase, std::abs(phase));
+            ++compared;
+        }
+    }
+    std::cout << "Compared " << compared << " entries within " << range
+              << " dB of the strongest: max gain deviation " << maxGain
+              << " dB, max phase shift deviation " << maxPhase << " rad" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    double in = 135;
+    double out = 89;
+    uint16_t nr = 20;
+    uint16_t nc = 20;
+    double frequency = 5.15e9;
+    double dApSta = 0;
+    double dApIrs = 0;
+    double dIrsSta = 0;
+    double delta = 0;
+    double alpha = 1;
+    uint32_t numIrs = 1;
+    double resolution = 1;
+    uint32_t threads = 0;
+    uint32_t patternOversampling = 0;
+    std::string name;
+    std::string directory = ".";
+    bool csv = true;
+    bool binary = false;
+    std::string validate;
+    double range = 30;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("in", "Azimuth in degrees the IRS is optimized for as input", in);
+    cmd.AddValue("out", "Azimuth in degrees the IRS is optimized for as output", out);
+    cmd.AddValue("nr", "Number of rows of the IRS", nr);
+    cmd.AddValue("nc", "Number of columns of the IRS", nc);
+    cmd.AddValue("frequency", "Carrier frequency in Hz", frequency);
+    cmd.AddValue("dApSta", "Length of the LOS path in m (default: no phase control)", dApSta);
+    cmd.AddValue("dApIrs", "Distance between AP and IRS in m", dApIrs);
+    cmd.AddValue("dIrsSta", "Distance between IRS and STA in m", dIrsSta);
+    cmd.AddValue("delta", "Phase shift to the LOS path: 0 constructive, pi destructive", delta);
+    cmd.AddValue("alpha", "Amplitude of the reflection coefficients", alpha);
+    cmd.AddValue("numIrs", "Number of IRS on the path sharing the phase shift", numIrs);
+    cmd.AddValue("resolution", "Grid step of the table in degrees", resolution);
+    cmd.AddValue("threads", "Number of threads (default: one per hardware thread)", threads);
+    cmd.AddValue("patternOversampling",
+                 "Oversampling of the FFT reflection patterns (default: direct evaluation)",
+                 patternOversampling);
+    cmd.AddValue("name", "Suffix of the file name", name);
+    cmd.AddValue("directory", "Directory the table is written to", directory);
+    cmd.AddValue("csv", "Write the table as csv", csv);
+    cmd.AddValue("binary", "Write the table in the binary format", binary);
+    cmd.AddValue("validate", "Table (csv or binary) to compare the generated table to", validate);
+    cmd.AddValue("range", "Range in dB below the strongest entry compared by --validate", range);
+    cmd.Parse(argc, argv);
+
+    Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(nr, nc, frequency);
+    if (dApSta > 0)
+    {
+        IrsLookupTableGenerator::Steer(irs,
+                                       in,
+                                       out,
+                                       dApSta,
+                                       dApIrs + dIrsSta,
+                                       delta,
+                                       alpha,
+                                       numIrs);
+    }
+    else
+    {
+        IrsLookupTableGenerator::Steer(irs, in, out);
+    }
+
+    Ptr<IrsLookupTableGenerator> generator = CreateObject<IrsLookupTableGenerator>();
+    generator->SetThreads(threads);
+    generator->SetResolution(resolution);
+    generator->SetPatternOversampling(patternOversampling);
+    auto start = std::chrono::steady_clock::now();
+    Ptr<IrsLookupTable> table = generator->Generate(irs);
+    auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    std::cout << "Generated " << table->GetNumAngles() * table->GetNumAngles() << " entries in "
+              << duration.count() << " s" << std::endl;
+
+    char stem[128];
+    std::snprintf(stem,
+                  sizeof(stem),
+                  "IRS_%d_IN%.0f_OUT%.0f_FREQ%.2fGHz",
+                  nr * nc,
+                  in,
+                  out,
+                  frequency / 1e9);
+    std::string filename = name.empty() ? std::string(stem) : std::string(stem) + "_" + name;
+    std::filesystem::path path = std::filesystem::path(directory) / filename;
+    if (csv)
+    {
+        IrsLookupTableIo::WriteCsv(table, path.string() + ".csv");
+        std::cout << "Table has been exported to " << path.string() << ".csv" << std::endl;
+    }
+    if (binary)
+    {
+        IrsLookupTableIo::WriteBinary(table, path.string() + ".irslut");
+        std::cout << "Table has been exported to " << path.string() << ".irslut" << std::endl;
+    }
+    if (!validate.empty())
+    {
+        Validate(table, IrsLookupTableIo::Read(validate), range);
+    }
+
+    return 0;
+}
@@ -34,39 +34,6 @@ struct SimulationResult
 
 std::vector<std::vector<SimulationResult>> allSimulationResults;
 
-const std::string irs_lookup_table[31] = {
-    "IRS_400_IN180_OUT86_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN153_OUT86_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN135_OUT86_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN124_OUT86_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN117_OUT86_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN112_OUT85_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN108_OUT85_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN106_OUT85_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN104_OUT85_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN103_OUT85_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN101_OUT84_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN100_OUT84_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN99_OUT84_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN99_OUT83_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN98_OUT83_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN98_OUT82_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN97_OUT82_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN97_OUT81_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN96_OUT81_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN96_OUT80_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN96_OUT79_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN95_OUT77_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN95_OUT76_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN95_OUT74_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN95_OUT72_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN95_OUT68_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN94_OUT63_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN94_OUT56_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN94_OUT45_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN94_OUT27_FREQ5.21GHz_constructive_changeRisPos.csv",
-    "IRS_400_IN94_OUT0_FREQ5.21GHz_constructive_changeRisPos.csv"};
-
 void
 writeResultsToCSV(const std::string& filename, const std::vector<SimulationResult>& averageResults)
 {
@@ -106,8 +73,10 @@ main(int argc, char* argv[])
     NodeContainer irsNode;
     irsNode.Create(1);
 
+    // one table per IRS position, loaded from the atlas index on first use
     IrsLookupHelper irsHelper;
     irsHelper.SetDirection(Vector(0, 1, 0));
+    irsHelper.SetAtlas("contrib/irs/examples/lookuptables/changeRisPos/atlas.csv");
 
     Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
     a->SetPosition(Vector(0, 0, 0));
@@ -115,35 +84,35 @@ main(int argc, char* argv[])
     b->SetPosition(Vector(15, 0, 0));
     Ptr<MobilityModel> irs = CreateObject<ConstantPositionMobilityModel>();
     irsNode.Get(0)->AggregateObject(irs);
+    irsHelper.Install(irsNode);
 
     Ptr<FriisPropagationLossModel> irsLossModel = CreateObject<FriisPropagationLossModel>();
     irsLossModel->SetFrequency(frequency);
     irsLossModel->SetSystemLoss(1);
 
+    Ptr<IrsPropagationLossModel> onlyIrsLossModel = CreateObject<IrsPropagationLossModel>();
+    onlyIrsLossModel->SetFrequency(frequency);
+    onlyIrsLossModel->SetIrsNodes(&irsNode);
+    onlyIrsLossModel->SetIrsPropagationModel(irsLossModel);
+
+    Ptr<IrsPropagationLossModel> lossModel = CreateObject<IrsPropagationLossModel>();
+    lossModel->SetFrequency(frequency);
+    lossModel->SetIrsNodes(&irsNode);
+    lossModel->SetIrsPropagationModel(irsLossModel);
+    lossModel->SetLosPropagationModel(irsLossModel);
+
     std::vector<SimulationResult> simulationResults;
-    int i = 0;
     for (double pos_irs = 0; pos_irs <= 15; pos_irs += 0.5)
     {
+        // moving the IRS selects the table of the new position
         irs->SetPosition(Vector(pos_irs, -1, 0));
-        irsHelper.SetLookupTable("contrib/irs/examples/lookuptables/changeRisPos/" +
-                                 irs_lookup_table[i]);
-        irsHelper.Install(irsNode);
-
-        Ptr<IrsPropagationLossModel> lossModel = CreateObject<IrsPropagationLossModel>();
-        lossModel->SetFrequency(frequency);
-        lossModel->SetIrsNodes(&irsNode);
-        lossModel->SetIrsPropagationModel(irsLossModel);
 
         SimulationResult result;
 
         result.irs_x = pos_irs;
-        result.only_irs = lossModel->CalcRxPower(txPowerDbm, a, b);
-
-        lossModel->SetLosPropagationModel(irsLossModel);
+        result.only_irs = onlyIrsLossModel->CalcRxPower(txPowerDbm, a, b);
         result.irs_los = lossModel->CalcRxPower(txPowerDbm, a, b);
         simulationResults.push_back(result);
-
-        i++;
     }
 
     writeResultsToCSV("contrib/irs/results_and_scripts/optimal_irs_placement_ns3.csv",
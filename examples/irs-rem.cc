@@ -34,8 +34,7 @@ RunScenario(std::string scenario)
 
     IrsLookupHelper irsHelper;
     irsHelper.SetDirection(Vector(1, 1, 0));
-    irsHelper.SetLookupTable(
-        "contrib/irs/examples/lookuptables/IRS_400_IN153_OUT27_FREQ1.50GHz_rem.csv");
+    irsHelper.SetEmbeddedLookupTable("IRS_400_IN153_OUT27_FREQ1.50GHz_rem");
     irsHelper.Install(irsNodes);
 
     if (scenario == "LOS")
@@ -206,8 +206,7 @@ RunScenario(std::string scenario, std::string wifiManager, uint16_t runNumber =
         irsNode.Create(1);
         IrsLookupHelper irsHelper;
         irsHelper.SetDirection(Vector(0, 1, 0));
-        irsHelper.SetLookupTable("contrib/irs/examples/lookuptables/validation/"
-                                 "IRS_400_IN135_OUT89_FREQ5.15GHz_constructive.csv");
+        irsHelper.SetEmbeddedLookupTable("IRS_400_IN135_OUT89_FREQ5.15GHz_constructive");
         irsHelper.Install(irsNode);
 
         Ptr<LogDistancePropagationLossModel> irsLossModel =
@@ -228,8 +227,7 @@ RunScenario(std::string scenario, std::string wifiManager, uint16_t runNumber =
         irsNode.Create(1);
         IrsLookupHelper irsHelper;
         irsHelper.SetDirection(Vector(0, 1, 0));
-        irsHelper.SetLookupTable("contrib/irs/examples/lookuptables/validation/"
-                                 "IRS_400_IN135_OUT89_FREQ5.15GHz_constructive.csv");
+        irsHelper.SetEmbeddedLookupTable("IRS_400_IN135_OUT89_FREQ5.15GHz_constructive");
         irsHelper.Install(irsNode);
 
         Ptr<LogDistancePropagationLossModel> irsLossModel =
@@ -255,8 +253,7 @@ RunScenario(std::string scenario, std::string wifiManager, uint16_t runNumber =
         irsNode.Create(1);
         IrsLookupHelper irsHelper;
         irsHelper.SetDirection(Vector(0, 1, 0));
-        irsHelper.SetLookupTable("contrib/irs/examples/lookuptables/validation/"
-                                 "IRS_400_IN139_OUT89_FREQ5.15GHz_destructive.csv");
+        irsHelper.SetEmbeddedLookupTable("IRS_400_IN139_OUT89_FREQ5.15GHz_destructive");
         irsHelper.Install(irsNode);
 
         Ptr<LogDistancePropagationLossModel> irsLossModel =
@@ -282,12 +279,10 @@ RunScenario(std::string scenario, std::string wifiManager, uint16_t runNumber =
         irsNode.Create(2);
         IrsLookupHelper irsHelper;
         irsHelper.SetDirection(Vector(0, -1, 0));
-        irsHelper.SetLookupTable("contrib/irs/examples/lookuptables/validation/"
-                                 "IRS_400_IN135_OUT88_FREQ5.15GHz_multiIrs1.csv");
+        irsHelper.SetEmbeddedLookupTable("IRS_400_IN135_OUT88_FREQ5.15GHz_multiIrs1");
         irsHelper.Install(irsNode.Get(0));
         irsHelper.SetDirection(Vector(0, 1, 0));
-        irsHelper.SetLookupTable("contrib/irs/examples/lookuptables/validation/"
-                                 "IRS_400_IN92_OUT45_FREQ5.15GHz_multiIrs2.csv");
+        irsHelper.SetEmbeddedLookupTable("IRS_400_IN92_OUT45_FREQ5.15GHz_multiIrs2");
         irsHelper.Install(irsNode.Get(1));
 
         Ptr<LogDistancePropagationLossModel> losLossModel =
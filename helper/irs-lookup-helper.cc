@@ -9,15 +9,17 @@
 
 #include "irs-lookup-helper.h"
 
+#include "irs-lookup-table-io.h"
+#include "irs-lookup-table-registry.h"
+
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/irs-lookup-model.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/object.h"
 #include "ns3/type-id.h"
 
-#include <fstream>
-#include <sstream>
 #include <stdint.h>
 
 namespace ns3
@@ -29,6 +31,8 @@ IrsLookupHelper::IrsLookupHelper()
 {
     m_irs.SetTypeId("ns3::IrsLookupModel");
     m_direction = Vector(1, 0, 0);
+    m_convertStorage = false;
+    m_storageMode = IrsLookupTable::DENSE;
 }
 
 IrsLookupHelper::~IrsLookupHelper()
@@ -40,6 +44,8 @@ IrsLookupHelper::Install(Ptr<Node> node) const
 {
     Ptr<Object> object = node;
     Ptr<IrsLookupModel> irs = object->GetObject<IrsLookupModel>();
+    NS_ABORT_MSG_IF(!irs && object->GetObject<IrsModel>(),
+                    "Node already has another IRS model, a node can only hold one.");
     if (!irs)
     {
         irs = m_irs.Create()->GetObject<IrsLookupModel>();
@@ -51,10 +57,25 @@ IrsLookupHelper::Install(Ptr<Node> node) const
     }
 
     NS_ABORT_MSG_IF(
-        !m_irsLookupTable,
+        !m_irsLookupTable && !m_irsLookupTable4D && !m_irsMultiFrequencyLookupTable && !m_atlas,
         "No Lookup Table for IRS set. Please set a Lookup Table before installing the IRS.");
 
-    irs->SetLookupTable(m_irsLookupTable);
+    if (m_irsLookupTable)
+    {
+        irs->SetLookupTable(m_irsLookupTable);
+    }
+    if (m_irsMultiFrequencyLookupTable)
+    {
+        irs->SetMultiFrequencyLookupTable(m_irsMultiFrequencyLookupTable);
+    }
+    if (m_irsLookupTable4D)
+    {
+        irs->SetLookupTable4D(m_irsLookupTable4D);
+    }
+    if (m_atlas)
+    {
+        irs->SetAtlas(m_atlas);
+    }
     irs->SetDirection(m_direction);
 }
 
@@ -83,46 +104,88 @@ IrsLookupHelper::InstallAll() const
 void
 IrsLookupHelper::SetLookupTable(std::string filename)
 {
-    // Load Lookup Table from csv file
-    std::ifstream file(filename);
-    NS_ABORT_MSG_IF(!file.is_open(), "IRS Lookup Table file not found.");
+    Ptr<IrsLookupTableRegistry> registry = IrsLookupTableRegistry::Get();
+    m_irsLookupTable = m_convertStorage ? registry->GetLookupTable(filename, m_storageMode)
+                                        : registry->GetLookupTable(filename);
+}
+
+void
+IrsLookupHelper::SetEmbeddedLookupTable(std::string name)
+{
+    Ptr<IrsLookupTableRegistry> registry = IrsLookupTableRegistry::Get();
+    m_irsLookupTable = m_convertStorage ? registry->GetEmbeddedLookupTable(name, m_storageMode)
+                                        : registry->GetEmbeddedLookupTable(name);
+}
 
-    // Create the lookup table
-    m_irsLookupTable = CreateObject<IrsLookupTable>();
+void
+IrsLookupHelper::SetLookupTable(Ptr<IrsLookupTable> table)
+{
+    m_irsLookupTable = ApplyStorageMode(table);
+}
 
-    std::string line;
-    // Skip the header
-    std::getline(file, line);
+void
+IrsLookupHelper::AddLookupTable(std::string filename)
+{
+    Ptr<IrsLookupTableRegistry> registry = IrsLookupTableRegistry::Get();
+    AddLookupTable(m_convertStorage ? registry->GetLookupTable(filename, m_storageMode)
+                                    : registry->GetLookupTable(filename));
+}
 
-    // Read the data
-    while (std::getline(file, line))
+void
+IrsLookupHelper::AddLookupTable(Ptr<IrsLookupTable> table)
+{
+    if (!m_irsMultiFrequencyLookupTable)
     {
-        std::stringstream ss(line);
-        std::string item;
-        uint8_t in_angle, out_angle;
-        double gain, phase_shift;
-
-        // Read each value separated by comma
-        std::getline(ss, item, ',');
-        in_angle = std::stoi(item);
-        std::getline(ss, item, ',');
-        out_angle = std::stoi(item);
-        std::getline(ss, item, ',');
-        gain = std::stod(item);
-        std::getline(ss, item, ',');
-        phase_shift = std::stod(item);
-
-        // Insert into the map
-        m_irsLookupTable->Insert(in_angle, out_angle, gain, phase_shift);
+        m_irsMultiFrequencyLookupTable = CreateObject<IrsMultiFrequencyLookupTable>();
     }
+    m_irsMultiFrequencyLookupTable->AddSlice(ApplyStorageMode(table));
+}
 
-    file.close();
+void
+IrsLookupHelper::SetLookupTable4D(std::string filename)
+{
+    m_irsLookupTable4D = IrsLookupTableRegistry::Get()->GetLookupTable4D(filename);
 }
 
 void
-IrsLookupHelper::SetLookupTable(Ptr<IrsLookupTable> table)
+IrsLookupHelper::SetLookupTable4D(Ptr<IrsLookupTable4D> table)
 {
-    m_irsLookupTable = table;
+    m_irsLookupTable4D = table;
+}
+
+IrsLookupTableGenerator::Deviation
+IrsLookupHelper::BakeSpectrumModel(Ptr<IrsSpectrumModel> irs,
+                                   double azimuthResolution,
+                                   double inclinationResolution)
+{
+    NS_ABORT_MSG_UNLESS(irs, "IRS to bake can not be null.");
+    Ptr<IrsLookupTableGenerator> generator = CreateObject<IrsLookupTableGenerator>();
+    generator->SetAzimuthResolution(azimuthResolution);
+    generator->SetInclinationResolution(inclinationResolution);
+    m_irsLookupTable4D = generator->Generate4D(irs);
+    m_direction = irs->GetDirection();
+
+    // measure with a model as it will be installed
+    Ptr<IrsLookupModel> model = m_irs.Create()->GetObject<IrsLookupModel>();
+    model->SetLookupTable4D(m_irsLookupTable4D);
+    model->SetDirection(m_direction);
+    IrsLookupTableGenerator::Deviation deviation = generator->CalcDeviation(irs, model);
+    NS_LOG_INFO("Baked IRS into a " << azimuthResolution << "x" << inclinationResolution
+                                    << " degree table, deviation up to " << deviation.gain
+                                    << " dB and " << deviation.phaseShift << " rad");
+    return deviation;
+}
+
+void
+IrsLookupHelper::SetAtlas(std::string filename)
+{
+    m_atlas = IrsLookupTableIo::ReadAtlas(filename);
+}
+
+void
+IrsLookupHelper::SetAtlas(Ptr<IrsLookupTableAtlas> atlas)
+{
+    m_atlas = atlas;
 }
 
 void
@@ -130,4 +193,41 @@ IrsLookupHelper::SetDirection(Vector direction)
 {
     m_direction = direction;
 }
+
+void
+IrsLookupHelper::SetInterpolate(bool interpolate)
+{
+    m_irs.Set("Interpolate", BooleanValue(interpolate));
+}
+
+void
+IrsLookupHelper::SetStorageMode(IrsLookupTable::StorageMode mode)
+{
+    m_convertStorage = true;
+    m_storageMode = mode;
+    if (m_irsLookupTable)
+    {
+        m_irsLookupTable = ApplyStorageMode(m_irsLookupTable);
+    }
+    if (m_irsMultiFrequencyLookupTable)
+    {
+        // rebuild, the old table may already be used by installed models
+        Ptr<IrsMultiFrequencyLookupTable> old = m_irsMultiFrequencyLookupTable;
+        m_irsMultiFrequencyLookupTable = CreateObject<IrsMultiFrequencyLookupTable>();
+        for (uint32_t i = 0; i < old->GetN(); ++i)
+        {
+            m_irsMultiFrequencyLookupTable->AddSlice(ApplyStorageMode(old->GetSlice(i)));
+        }
+    }
+}
+
+Ptr<IrsLookupTable>
+IrsLookupHelper::ApplyStorageMode(Ptr<IrsLookupTable> table) const
+{
+    if (!table || !m_convertStorage || table->GetStorageMode() == m_storageMode)
+    {
+        return table;
+    }
+    return table->Convert(m_storageMode);
+}
 } // namespace ns3
@@ -10,7 +10,11 @@
 #ifndef IRS_LOOKUP_HELPER_H
 #define IRS_LOOKUP_HELPER_H
 
+#include "irs-lookup-table-4d.h"
+#include "irs-lookup-table-atlas.h"
+#include "irs-lookup-table-generator.h"
 #include "irs-lookup-table.h"
+#include "irs-multi-frequency-lookup-table.h"
 
 #include "ns3/node-container.h"
 #include "ns3/node.h"
@@ -39,6 +43,10 @@ class IrsLookupHelper
     /**
      * @brief Installs an IRS model with the configured lookup table on a specific node.
      * @param node A pointer to the node where the IRS model will be installed
+     *
+     * A node that already holds an \c IrsLookupModel gets the configured tables. Any other IRS
+     * model on the node is a fatal error: aggregated objects can not be removed, so e.g. an
+     * \c IrsSpectrumModel aggregated to the node can not be replaced.
      */
     void Install(Ptr<Node> node) const;
 
@@ -60,27 +68,143 @@ class IrsLookupHelper
     void InstallAll() const;
 
     /**
-     * @brief Sets the IRS lookup table from a given csv file.
+     * @brief Sets the IRS lookup table from a given csv or binary file.
      * @param filename The file path containing the lookup table data
+     *
+     * Binary tables (see \c IrsLookupTableIo) are detected by their header and memory-mapped
+     * without parsing; all other files are read as csv. The table is obtained from the
+     * \c IrsLookupTableRegistry, so repeated calls with the same file share one read-only table.
      */
     void SetLookupTable(std::string filename);
 
+    /**
+     * @brief Sets the IRS lookup table from a table embedded in the library.
+     * @param name Name of the table, i.e. its csv file name without the extension (see
+     * \c IrsLookupTableIo::ReadEmbedded)
+     *
+     * Embedded tables are compiled into the library at build time, so no file is read or
+     * parsed and the working directory does not matter. Like \c SetLookupTable, the table is
+     * obtained from the \c IrsLookupTableRegistry.
+     */
+    void SetEmbeddedLookupTable(std::string name);
+
     /**
      * @brief Sets the IRS lookup table from a preloaded object.
      * @param table A pointer to an IRS lookup table object
      */
     void SetLookupTable(Ptr<IrsLookupTable> table);
 
+    /**
+     * @brief Adds a lookup table for one carrier frequency from a given csv or binary file.
+     * @param filename The file path containing the lookup table data
+     *
+     * The frequency is taken from the binary header or the \c FREQ<x>GHz part of the file
+     * name. Tables added this way form an \c IrsMultiFrequencyLookupTable, which interpolates
+     * between the frequencies, so one IRS model serves channels on any of them.
+     */
+    void AddLookupTable(std::string filename);
+
+    /**
+     * @brief Adds a preloaded lookup table for one carrier frequency.
+     * @param table A pointer to an IRS lookup table object with its frequency set
+     */
+    void AddLookupTable(Ptr<IrsLookupTable> table);
+
+    /**
+     * @brief Sets the 4D IRS lookup table (azimuth and inclination of both directions) from a
+     * given csv or binary file.
+     * @param filename The file path containing the lookup table data
+     *
+     * Like \c SetLookupTable, the table is obtained from the \c IrsLookupTableRegistry. IRS
+     * models with a 4D table are queried with the full 3D directions.
+     */
+    void SetLookupTable4D(std::string filename);
+
+    /**
+     * @brief Sets the 4D IRS lookup table from a preloaded object.
+     * @param table A pointer to a 4D IRS lookup table object
+     */
+    void SetLookupTable4D(Ptr<IrsLookupTable4D> table);
+
+    /**
+     * @brief Sets the 4D lookup table and direction by baking an \c IrsSpectrumModel.
+     * @param irs The IRS with its reflection coefficients and direction, not aggregated to any
+     * node
+     * @param azimuthResolution Azimuth step of the table in degrees, must divide 360 degrees
+     * @param inclinationResolution Inclination step of the table in degrees, must divide 90
+     * degrees
+     * @return The largest deviation of the installed models from the IRS, measured with the
+     * \c Interpolate setting of this helper
+     *
+     * The table is evaluated once on all hardware threads (see \c IrsLookupTableGenerator), so
+     * installed models answer with a table lookup instead of an evaluation over all elements of
+     * the IRS. Call \c SetInterpolate before to have the deviation reflect it.
+     *
+     * This does not replace an IRS on a node: the spectrum model is only read, and \c Install
+     * aborts on nodes that already hold it (see \c Install). Configure the IRS standalone, e.g.
+     * with \c IrsLookupTableGenerator::CreateIrs, and install the baked model on the nodes
+     * instead of aggregating the spectrum model.
+     */
+    IrsLookupTableGenerator::Deviation BakeSpectrumModel(Ptr<IrsSpectrumModel> irs,
+                                                         double azimuthResolution = 5,
+                                                         double inclinationResolution = 5);
+
+    /**
+     * @brief Sets the atlas of lookup tables indexed by IRS position from a given file.
+     * @param filename Path to a binary atlas or a csv atlas index (see \c IrsLookupTableIo)
+     *
+     * The atlas is read once and shared by all IRS models installed by this helper, its tables
+     * are loaded on first use. Installed models choose the table by the position of the IRS, so
+     * moving the IRS needs no new table. Tables of the atlas keep their storage mode.
+     */
+    void SetAtlas(std::string filename);
+
+    /**
+     * @brief Sets the atlas of lookup tables indexed by IRS position from a preloaded object.
+     * @param atlas A pointer to an atlas object
+     */
+    void SetAtlas(Ptr<IrsLookupTableAtlas> atlas);
+
     /**
      * @brief Sets the direction vector for IRS configuration.
      * @param direction A vector indicating the direction
      */
     void SetDirection(Vector direction);
 
+    /**
+     * @brief Sets whether installed IRS models interpolate between the grid points of the table.
+     * @param interpolate true for bilinear interpolation, false for the nearest grid point
+     */
+    void SetInterpolate(bool interpolate);
+
+    /**
+     * @brief Sets how the lookup tables of installed IRS models keep their entries in memory.
+     * @param mode The storage mode, e.g. \c IrsLookupTable::QUANTIZED for a quarter of the
+     * memory of dense tables
+     *
+     * Applies to tables set or added before and after this call, whether loaded from a file or
+     * preloaded. Tables in another storage mode are converted, preloaded tables are copied
+     * instead of being modified. Without this call tables keep the mode they were loaded in.
+     * 4D tables are always quantized and not affected.
+     */
+    void SetStorageMode(IrsLookupTable::StorageMode mode);
+
   private:
+    /**
+     * @brief Convert a table to the storage mode set by \c SetStorageMode, if any.
+     * @param table The table
+     * @return The table itself if no conversion is needed, otherwise a converted copy
+     */
+    Ptr<IrsLookupTable> ApplyStorageMode(Ptr<IrsLookupTable> table) const;
+
     ObjectFactory m_irs;
     Ptr<IrsLookupTable> m_irsLookupTable;
+    Ptr<IrsLookupTable4D> m_irsLookupTable4D;
+    Ptr<IrsMultiFrequencyLookupTable> m_irsMultiFrequencyLookupTable;
+    Ptr<IrsLookupTableAtlas> m_atlas;
     Vector m_direction;
+    bool m_convertStorage;
+    IrsLookupTable::StorageMode m_storageMode;
 };
 
 } // namespace ns3
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-lookup-table-4d.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(IrsLookupTable4D);
+
+TypeId
+IrsLookupTable4D::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::IrsLookupTable4D")
+            .SetParent<Object>()
+            .AddConstructor<IrsLookupTable4D>()
+            .AddAttribute("AzimuthResolution",
+                          "The azimuth step (in degrees) of the grid. Must divide 360 degrees and "
+                          "can only be changed on an empty table.",
+                          DoubleValue(5),
+                          MakeDoubleAccessor(&IrsLookupTable4D::SetAzimuthResolution,
+                                             &IrsLookupTable4D::GetAzimuthResolution),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("InclinationResolution",
+                          "The inclination step (in degrees) of the grid. Must divide 90 degrees "
+                          "and can only be changed on an empty table.",
+                          DoubleValue(5),
+                          MakeDoubleAccessor(&IrsLookupTable4D::SetInclinationResolution,
+                                             &IrsLookupTable4D::GetInclinationResolution),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("Frequency",
+                          "The carrier frequency (in Hz) the table was generated for. Zero if "
+                          "unknown.",
+                          DoubleValue(0),
+                          MakeDoubleAccessor(&IrsLookupTable4D::SetFrequency,
+                                             &IrsLookupTable4D::GetFrequency),
+                          MakeDoubleChecker<double>(0));
+    return tid;
+}
+
+IrsLookupTable4D::IrsLookupTable4D()
+    : m_entries(nullptr),
+      m_azimuthResolution(5),
+      m_inclinationResolution(5),
+      m_numAzimuths(72),
+      m_numInclinations(19),
+      m_frequency(0),
+      m_readOnly(false)
+{
+}
+
+IrsLookupTable4D::~IrsLookupTable4D()
+{
+    m_irsLookupTable.clear();
+}
+
+bool
+IrsLookupTable4D::GridIndex(double azimuth, double inclination, uint32_t& index) const
+{
+    double az = (azimuth + 180) / m_azimuthResolution;
+    double incl = inclination / m_inclinationResolution;
+    if (std::abs(az - std::round(az)) > 1e-6 || std::abs(incl - std::round(incl)) > 1e-6 ||
+        az < -1e-6 || az > m_numAzimuths + 1e-6 || incl < -1e-6 ||
+        incl > m_numInclinations - 1 + 1e-6)
+    {
+        return false;
+    }
+    // 180 degrees azimuth is the same grid point as -180
+    uint32_t a = static_cast<uint32_t>(std::round(az)) % m_numAzimuths;
+    index = a * m_numInclinations + static_cast<uint32_t>(std::round(incl));
+    return true;
+}
+
+uint32_t
+IrsLookupTable4D::DirectionIndex(const Angles& direction) const
+{
+    double az = (RadiansToDegrees(direction.GetAzimuth()) + 180) / m_azimuthResolution;
+    double incl = RadiansToDegrees(direction.GetInclination()) / m_inclinationResolution;
+    long a = std::lround(az) % static_cast<long>(m_numAzimuths);
+    if (a < 0)
+    {
+        a += m_numAzimuths;
+    }
+    long i = std::clamp<long>(std::lround(incl), 0, m_numInclinations - 1);
+    return a * m_numInclinations + i;
+}
+
+void
+IrsLookupTable4D::DirectionCorners(const Angles& direction,
+                                   uint32_t indices[4],
+                                   double weights[4]) const
+{
+    double az = (RadiansToDegrees(direction.GetAzimuth()) + 180) / m_azimuthResolution;
+    double incl = std::clamp(RadiansToDegrees(direction.GetInclination()) / m_inclinationResolution,
+                             0.0,
+                             m_numInclinations - 1.0);
+    double a = std::floor(az);
+    double fa = az - a;
+    // lower grid point, the last cell also covers the upper edge
+    uint32_t i = std::min(static_cast<uint32_t>(incl), m_numInclinations - 2);
+    double fi = incl - i;
+    long a0 = static_cast<long>(a) % static_cast<long>(m_numAzimuths);
+    if (a0 < 0)
+    {
+        a0 += m_numAzimuths;
+    }
+    uint32_t a1 = (a0 + 1) % m_numAzimuths;
+    indices[0] = a0 * m_numInclinations + i;
+    indices[1] = a0 * m_numInclinations + i + 1;
+    indices[2] = a1 * m_numInclinations + i;
+    indices[3] = a1 * m_numInclinations + i + 1;
+    weights[0] = (1 - fa) * (1 - fi);
+    weights[1] = (1 - fa) * fi;
+    weights[2] = fa * (1 - fi);
+    weights[3] = fa * fi;
+}
+
+void
+IrsLookupTable4D::Insert(double in_azimuth,
+                         double in_inclination,
+                         double out_azimuth,
+                         double out_inclination,
+                         double gain,
+                         double phase_shift)
+{
+    uint32_t in;
+    uint32_t out;
+    NS_ABORT_MSG_IF(!GridIndex(in_azimuth, in_inclination, in) ||
+                        !GridIndex(out_azimuth, out_inclination, out),
+                    "IrsLookupTable4D directions must lie on the "
+                        << m_azimuthResolution << "x" << m_inclinationResolution
+                        << " degree grid, got in: (" << in_azimuth << ", " << in_inclination
+                        << ") and out: (" << out_azimuth << ", " << out_inclination << ")");
+    NS_ABORT_MSG_IF(m_readOnly, "IrsLookupTable4D is read-only.");
+    IrsQuantizedEntry entry = IrsQuantizedEntry::Quantize(gain, phase_shift);
+    if (m_irsLookupTable.empty())
+    {
+        // allocate on the first insert, copying external storage if set
+        uint64_t size = static_cast<uint64_t>(GetNumDirections()) * GetNumDirections();
+        if (m_entries)
+        {
+            m_irsLookupTable.assign(m_entries, m_entries + size);
+        }
+        else
+        {
+            m_irsLookupTable.assign(size, {IrsQuantizedEntry::MISSING, 0});
+        }
+        m_entries = m_irsLookupTable.data();
+        m_owner.reset();
+    }
+    m_irsLookupTable[static_cast<uint64_t>(in) * GetNumDirections() + out] = entry;
+}
+
+IrsEntry
+IrsLookupTable4D::GetIrsEntry(Angles in, Angles out) const
+{
+    NS_ABORT_MSG_UNLESS(m_entries, "IrsLookupTable4D is empty.");
+    uint32_t inIndex = DirectionIndex(in);
+    uint32_t outIndex = DirectionIndex(out);
+    IrsQuantizedEntry entry =
+        m_entries[static_cast<uint64_t>(inIndex) * GetNumDirections() + outIndex];
+    if (entry.gain == IrsQuantizedEntry::MISSING)
+    {
+        NS_FATAL_ERROR("Entry in IrsLookupTable4D with in: " << in << " and out: " << out
+                                                             << " not Found.");
+    }
+    return entry.Dequantize();
+}
+
+IrsEntry
+IrsLookupTable4D::GetInterpolatedIrsEntry(Angles in, Angles out) const
+{
+    NS_ABORT_MSG_UNLESS(m_entries, "IrsLookupTable4D is empty.");
+    uint32_t inIndices[4];
+    double inWeights[4];
+    uint32_t outIndices[4];
+    double outWeights[4];
+    DirectionCorners(in, inIndices, inWeights);
+    DirectionCorners(out, outIndices, outWeights);
+
+    double weight = 0;
+    IrsEntry blended{0, 0};
+    for (int k = 0; k < 4; ++k)
+    {
+        for (int l = 0; l < 4; ++l)
+        {
+            double w = inWeights[k] * outWeights[l];
+            IrsQuantizedEntry quantized =
+                m_entries[static_cast<uint64_t>(inIndices[k]) * GetNumDirections() +
+                          outIndices[l]];
+            if (w == 0 || quantized.gain == IrsQuantizedEntry::MISSING)
+            {
+                continue;
+            }
+            weight += w;
+            blended = BlendIrsEntries(blended, quantized.Dequantize(), w / weight);
+        }
+    }
+    if (weight == 0)
+    {
+        NS_FATAL_ERROR("No entry in IrsLookupTable4D around in: " << in << " and out: " << out);
+    }
+    return blended;
+}
+
+void
+IrsLookupTable4D::SetExternalStorage(const IrsQuantizedEntry* entries,
+                                     std::shared_ptr<const void> owner)
+{
+    NS_ABORT_MSG_UNLESS(entries, "External storage of IrsLookupTable4D can not be null.");
+    m_owner = owner;
+    m_entries = entries;
+    m_irsLookupTable.clear();
+    m_irsLookupTable.shrink_to_fit();
+}
+
+const IrsQuantizedEntry*
+IrsLookupTable4D::GetEntries() const
+{
+    return m_entries;
+}
+
+void
+IrsLookupTable4D::CheckEmpty() const
+{
+    NS_ABORT_MSG_IF(m_entries, "IrsLookupTable4D resolution can only be set on an empty table.");
+}
+
+void
+IrsLookupTable4D::SetAzimuthResolution(double resolution)
+{
+    double steps = 360.0 / resolution;
+    NS_ABORT_MSG_IF(!(resolution > 0) || resolution > 360 ||
+                        std::abs(steps - std::round(steps)) > 1e-9 * steps,
+                    "IrsLookupTable4D azimuth resolution must divide 360 degrees, got "
+                        << resolution);
+    CheckEmpty();
+    m_azimuthResolution = resolution;
+    m_numAzimuths = static_cast<uint32_t>(std::round(steps));
+}
+
+double
+IrsLookupTable4D::GetAzimuthResolution() const
+{
+    return m_azimuthResolution;
+}
+
+void
+IrsLookupTable4D::SetInclinationResolution(double resolution)
+{
+    double steps = 90.0 / resolution;
+    NS_ABORT_MSG_IF(!(resolution > 0) || resolution > 90 ||
+                        std::abs(steps - std::round(steps)) > 1e-9 * steps,
+                    "IrsLookupTable4D inclination resolution must divide 90 degrees, got "
+                        << resolution);
+    CheckEmpty();
+    m_inclinationResolution = resolution;
+    m_numInclinations = static_cast<uint32_t>(std::round(steps)) + 1;
+}
+
+double
+IrsLookupTable4D::GetInclinationResolution() const
+{
+    return m_inclinationResolution;
+}
+
+uint32_t
+IrsLookupTable4D::GetNumAzimuths() const
+{
+    return m_numAzimuths;
+}
+
+uint32_t
+IrsLookupTable4D::GetNumInclinations() const
+{
+    return m_numInclinations;
+}
+
+uint32_t
+IrsLookupTable4D::GetNumDirections() const
+{
+    return m_numAzimuths * m_numInclinations;
+}
+
+void
+IrsLookupTable4D::SetFrequency(double frequency)
+{
+    NS_ABORT_MSG_IF(frequency < 0, "Frequency can not be negative (in Hz).");
+    m_frequency = frequency;
+}
+
+double
+IrsLookupTable4D::GetFrequency() const
+{
+    return m_frequency;
+}
+
+void
+IrsLookupTable4D::SetReadOnly()
+{
+    m_readOnly = true;
+}
+
+bool
+IrsLookupTable4D::IsReadOnly() const
+{
+    return m_readOnly;
+}
+
+uint64_t
+IrsLookupTable4D::GetMemoryUsage() const
+{
+    return static_cast<uint64_t>(GetNumDirections()) * GetNumDirections() *
+           sizeof(IrsQuantizedEntry);
+}
+
+} // namespace ns3
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_LOOKUP_TABLE_4D_H
+#define IRS_LOOKUP_TABLE_4D_H
+
+#include "irs-lookup-table.h"
+
+#include "ns3/angles.h"
+#include "ns3/object.h"
+#include "ns3/type-id.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @class IrsLookupTable4D
+ * @brief Lookup table for IRS entries indexed by azimuth and inclination of both directions.
+ *
+ * Unlike \c IrsLookupTable, which only knows the angle between each direction and the IRS
+ * normal, this table keeps the full 3D directions as given by
+ * \c IrsPropagationLossModel::CalcAngles3D: the azimuth over [-180, 180) degrees and the
+ * inclination from the IRS normal over [0, 90] degrees, each in steps of a configurable
+ * resolution. Directions behind the IRS (inclination above 90 degrees) are clamped to the edge
+ * of the grid.
+ *
+ * The number of entries grows with the fourth power of the resolution, so entries are stored as
+ * two 16 bit values (\c IrsQuantizedEntry), a quarter of the size of \c IrsEntry. A lookup
+ * snaps both directions to the nearest grid point and reads a single entry.
+ */
+class IrsLookupTable4D : public Object
+{
+  public:
+    /**
+     * @brief Get the TypeId of this class.
+     * @return the TypeId
+     */
+    static TypeId GetTypeId();
+    IrsLookupTable4D();
+    ~IrsLookupTable4D() override;
+
+    /**
+     * @brief Inserts an IRS entry into the lookup table.
+     * @param in_azimuth Azimuth of the incoming direction in degrees
+     * @param in_inclination Inclination of the incoming direction in degrees
+     * @param out_azimuth Azimuth of the outgoing direction in degrees
+     * @param out_inclination Inclination of the outgoing direction in degrees
+     * @param gain Gain in dB, quantized to IrsQuantizedEntry::GAIN_STEP
+     * @param phase_shift Phase shift in radians
+     *
+     * All angles must lie on the grid.
+     */
+    void Insert(double in_azimuth,
+                double in_inclination,
+                double out_azimuth,
+                double out_inclination,
+                double gain,
+                double phase_shift);
+
+    /**
+     * @brief Retrieves the IRS entry of the grid point nearest to the given directions.
+     * @param in Incoming direction (azimuth and inclination in radians)
+     * @param out Outgoing direction (azimuth and inclination in radians)
+     * @return The dequantized IRS entry
+     */
+    IrsEntry GetIrsEntry(Angles in, Angles out) const;
+
+    /**
+     * @brief Retrieves the IRS entry interpolated between the grid points around the given
+     * directions.
+     * @param in Incoming direction (azimuth and inclination in radians)
+     * @param out Outgoing direction (azimuth and inclination in radians)
+     * @return The IRS entry
+     *
+     * Gain (in dB) and phase shift are interpolated multilinearly between the 16 grid points
+     * around both directions, see \c BlendIrsEntries. The azimuth wraps around at +-180
+     * degrees, the inclination is clamped to [0, 90] degrees. Missing grid points are left out.
+     */
+    IrsEntry GetInterpolatedIrsEntry(Angles in, Angles out) const;
+
+    /**
+     * @brief Use external read-only memory as storage for the table entries.
+     * @param entries Row-major array of GetNumDirections() * GetNumDirections() entries
+     * @param owner Keeps the memory behind \p entries alive as long as the table uses it, may be
+     * null for static memory
+     */
+    void SetExternalStorage(const IrsQuantizedEntry* entries, std::shared_ptr<const void> owner);
+
+    /**
+     * @brief Get the raw table entries.
+     * @return Row-major array indexed by [in direction][out direction], null for an empty table
+     */
+    const IrsQuantizedEntry* GetEntries() const;
+
+    /**
+     * @brief Set the azimuth resolution of the grid.
+     * @param resolution Grid step in degrees, must divide 360 degrees
+     */
+    void SetAzimuthResolution(double resolution);
+
+    /**
+     * @brief Get the azimuth resolution of the grid.
+     * @return Grid step in degrees
+     */
+    double GetAzimuthResolution() const;
+
+    /**
+     * @brief Set the inclination resolution of the grid.
+     * @param resolution Grid step in degrees, must divide 90 degrees
+     */
+    void SetInclinationResolution(double resolution);
+
+    /**
+     * @brief Get the inclination resolution of the grid.
+     * @return Grid step in degrees
+     */
+    double GetInclinationResolution() const;
+
+    /**
+     * @brief Get the number of azimuth grid points.
+     * @return 360 / azimuth resolution
+     */
+    uint32_t GetNumAzimuths() const;
+
+    /**
+     * @brief Get the number of inclination grid points.
+     * @return 90 / inclination resolution + 1
+     */
+    uint32_t GetNumInclinations() const;
+
+    /**
+     * @brief Get the number of directions on the grid.
+     * @return GetNumAzimuths() * GetNumInclinations()
+     */
+    uint32_t GetNumDirections() const;
+
+    /**
+     * @brief Set the carrier frequency the table was generated for.
+     * @param frequency Frequency in Hz, 0 if unknown
+     */
+    void SetFrequency(double frequency);
+
+    /**
+     * @brief Get the carrier frequency the table was generated for.
+     * @return Frequency in Hz, 0 if unknown
+     */
+    double GetFrequency() const;
+
+    /**
+     * @brief Mark the table as read-only. Any further \c Insert aborts.
+     */
+    void SetReadOnly();
+
+    /**
+     * @brief Check whether the table is read-only.
+     * @return true if \c Insert is not allowed
+     */
+    bool IsReadOnly() const;
+
+    /**
+     * @brief Get the memory held by the table entries.
+     * @return Size of the entry storage in bytes
+     */
+    uint64_t GetMemoryUsage() const;
+
+  private:
+    /**
+     * @brief Get the index of the grid point nearest to a direction.
+     * @param direction Azimuth and inclination in radians
+     * @return Index of the direction
+     */
+    uint32_t DirectionIndex(const Angles& direction) const;
+
+    /**
+     * @brief Get the four grid points around a direction and their bilinear weights.
+     * @param direction Azimuth and inclination in radians
+     * @param indices Indices of the directions
+     * @param weights Weights of the directions, summing up to 1
+     */
+    void DirectionCorners(const Angles& direction, uint32_t indices[4], double weights[4]) const;
+
+    /**
+     * @brief Get the index of a direction on the grid.
+     * @param azimuth Azimuth in degrees
+     * @param inclination Inclination in degrees
+     * @param index The index, set if the direction lies on the grid
+     * @return true if the direction lies on the grid
+     */
+    bool GridIndex(double azimuth, double inclination, uint32_t& index) const;
+
+    /**
+     * @brief Abort unless the table holds no entries yet.
+     */
+    void CheckEmpty() const;
+
+    std::vector<IrsQuantizedEntry> m_irsLookupTable; //!< Owned storage, empty until first Insert
+    const IrsQuantizedEntry* m_entries;              //!< Row-major [in direction][out direction]
+    std::shared_ptr<const void> m_owner;             //!< Keeps external storage alive
+    double m_azimuthResolution;                      //!< Azimuth grid step in degrees
+    double m_inclinationResolution;                  //!< Inclination grid step in degrees
+    uint32_t m_numAzimuths;                          //!< Azimuth grid points
+    uint32_t m_numInclinations;                      //!< Inclination grid points
+    double m_frequency;                              //!< Carrier frequency in Hz, 0 if unknown
+    bool m_readOnly;                                 //!< Whether Insert is allowed
+};
+
+} // namespace ns3
+
+#endif // IRS_LOOKUP_TABLE_4D_H
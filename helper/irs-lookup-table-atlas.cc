@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-lookup-table-atlas.h"
+
+#include "irs-lookup-table-registry.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableAtlas");
+
+NS_OBJECT_ENSURE_REGISTERED(IrsLookupTableAtlas);
+
+TypeId
+IrsLookupTableAtlas::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::IrsLookupTableAtlas")
+            .SetParent<Object>()
+            .AddConstructor<IrsLookupTableAtlas>()
+            .AddAttribute("Interpolate",
+                          "Blend the tables of the two nearest slices for positions between "
+                          "them instead of using the nearest one.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&IrsLookupTableAtlas::SetInterpolate,
+                                              &IrsLookupTableAtlas::GetInterpolate),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+IrsLookupTableAtlas::IrsLookupTableAtlas()
+    : m_interpolate(false)
+{
+}
+
+IrsLookupTableAtlas::~IrsLookupTableAtlas()
+{
+    m_slices.clear();
+    m_tables.clear();
+}
+
+uint32_t
+IrsLookupTableAtlas::AddTable(Ptr<IrsLookupTable> table)
+{
+    NS_ABORT_MSG_UNLESS(table, "Lookup table can not be null.");
+    for (uint32_t i = 0; i < m_tables.size(); ++i)
+    {
+        if (m_tables[i].table == table)
+        {
+            return i;
+        }
+    }
+    m_tables.push_back({table, nullptr, ""});
+    return m_tables.size() - 1;
+}
+
+uint32_t
+IrsLookupTableAtlas::AddTable(const std::string& filename)
+{
+    for (uint32_t i = 0; i < m_tables.size(); ++i)
+    {
+        if (m_tables[i].filename == filename)
+        {
+            return i;
+        }
+    }
+    m_tables.push_back(
+        {nullptr,
+         [filename]() { return IrsLookupTableRegistry::Get()->GetLookupTable(filename); },
+         filename});
+    return m_tables.size() - 1;
+}
+
+uint32_t
+IrsLookupTableAtlas::AddTable(std::function<Ptr<IrsLookupTable>()> loader)
+{
+    NS_ABORT_MSG_UNLESS(loader, "Loader of a lookup table can not be null.");
+    m_tables.push_back({nullptr, std::move(loader), ""});
+    return m_tables.size() - 1;
+}
+
+uint32_t
+IrsLookupTableAtlas::AddSlice(const Vector& position, uint32_t table)
+{
+    return AddSlice(position, Vector(0, 0, 0), table);
+}
+
+uint32_t
+IrsLookupTableAtlas::AddSlice(const Vector& position, const Vector& direction, uint32_t table)
+{
+    NS_ABORT_MSG_UNLESS(table < m_tables.size(),
+                        "Table " << table << " of IrsLookupTableAtlas does not exist.");
+    double m = direction.GetLength();
+    Vector normalized = m > 0 ? Vector(direction.x / m, direction.y / m, direction.z / m)
+                              : Vector(0, 0, 0);
+    m_slices.push_back({position, normalized, table});
+    return m_slices.size() - 1;
+}
+
+uint32_t
+IrsLookupTableAtlas::GetN() const
+{
+    return m_slices.size();
+}
+
+uint32_t
+IrsLookupTableAtlas::GetNTables() const
+{
+    return m_tables.size();
+}
+
+uint32_t
+IrsLookupTableAtlas::GetNLoadedTables() const
+{
+    return std::count_if(m_tables.begin(), m_tables.end(), [](const Table& table) {
+        return static_cast<bool>(table.table);
+    });
+}
+
+Vector
+IrsLookupTableAtlas::GetSlicePosition(uint32_t slice) const
+{
+    NS_ABORT_MSG_UNLESS(slice < m_slices.size(), "Slice " << slice << " does not exist.");
+    return m_slices[slice].position;
+}
+
+Vector
+IrsLookupTableAtlas::GetSliceDirection(uint32_t slice) const
+{
+    NS_ABORT_MSG_UNLESS(slice < m_slices.size(), "Slice " << slice << " does not exist.");
+    return m_slices[slice].direction;
+}
+
+uint32_t
+IrsLookupTableAtlas::GetSliceTable(uint32_t slice) const
+{
+    NS_ABORT_MSG_UNLESS(slice < m_slices.size(), "Slice " << slice << " does not exist.");
+    return m_slices[slice].table;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableAtlas::GetTable(uint32_t table) const
+{
+    NS_ABORT_MSG_UNLESS(table < m_tables.size(),
+                        "Table " << table << " of IrsLookupTableAtlas does not exist.");
+    Table& entry = m_tables[table];
+    if (!entry.table)
+    {
+        entry.table = entry.loader();
+        NS_ABORT_MSG_UNLESS(entry.table,
+                            "Could not load table " << table << " of IrsLookupTableAtlas.");
+        entry.loader = nullptr;
+        NS_LOG_DEBUG("Loaded table " << table << " " << entry.filename);
+    }
+    return entry.table;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableAtlas::GetSliceLookupTable(uint32_t slice) const
+{
+    return GetTable(GetSliceTable(slice));
+}
+
+IrsLookupTableAtlas::Selection
+IrsLookupTableAtlas::Select(const Vector& position, const Vector& direction) const
+{
+    NS_ABORT_MSG_IF(m_slices.empty(), "IrsLookupTableAtlas has no slices.");
+    double length = direction.GetLength();
+    // cosine between the orientations, a slice for any orientation ranks like a perpendicular one
+    auto match = [&](const Slice& slice) {
+        if (length == 0)
+        {
+            return 1.0;
+        }
+        return slice.direction * direction / length;
+    };
+    double bestMatch = -std::numeric_limits<double>::infinity();
+    for (const auto& slice : m_slices)
+    {
+        bestMatch = std::max(bestMatch, match(slice));
+    }
+
+    // nearest slice of the best matching orientation
+    uint32_t nearest = 0;
+    double nearestDistance = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < m_slices.size(); ++i)
+    {
+        double distance = CalculateDistance(position, m_slices[i].position);
+        if (match(m_slices[i]) >= bestMatch - 1e-9 && distance < nearestDistance)
+        {
+            nearest = i;
+            nearestDistance = distance;
+        }
+    }
+    Selection selection{nearest, nearest, 0};
+    if (!m_interpolate || nearestDistance == 0)
+    {
+        return selection;
+    }
+
+    // blend in the second nearest slice if the position lies between the two
+    const Vector& a = m_slices[nearest].position;
+    double secondDistance = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < m_slices.size(); ++i)
+    {
+        double distance = CalculateDistance(position, m_slices[i].position);
+        if (match(m_slices[i]) >= bestMatch - 1e-9 && distance < secondDistance &&
+            CalculateDistance(a, m_slices[i].position) > 0)
+        {
+            Vector ab = m_slices[i].position - a;
+            double t = (position - a) * ab / (ab * ab);
+            if (t > 0 && t < 1)
+            {
+                selection.upper = i;
+                selection.weight = t;
+                secondDistance = distance;
+            }
+        }
+    }
+    return selection;
+}
+
+IrsEntry
+IrsLookupTableAtlas::GetSliceEntry(uint32_t slice,
+                                   double in_angle,
+                                   double out_angle,
+                                   bool interpolateAngles) const
+{
+    const Table& entry = m_tables[m_slices[slice].table];
+    const IrsLookupTable* table =
+        entry.table ? PeekPointer(entry.table) : PeekPointer(GetTable(m_slices[slice].table));
+    return interpolateAngles ? table->GetInterpolatedIrsEntry(in_angle, out_angle)
+                             : table->GetNearestIrsEntry(in_angle, out_angle);
+}
+
+IrsEntry
+IrsLookupTableAtlas::GetIrsEntry(const Selection& selection,
+                                 double in_angle,
+                                 double out_angle,
+                                 bool interpolateAngles) const
+{
+    NS_ABORT_MSG_UNLESS(selection.lower < m_slices.size() && selection.upper < m_slices.size(),
+                        "Invalid selection of IrsLookupTableAtlas slices.");
+    IrsEntry low = GetSliceEntry(selection.lower, in_angle, out_angle, interpolateAngles);
+    if (selection.weight == 0 ||
+        m_slices[selection.lower].table == m_slices[selection.upper].table)
+    {
+        return low;
+    }
+    IrsEntry high = GetSliceEntry(selection.upper, in_angle, out_angle, interpolateAngles);
+    return BlendIrsEntries(low, high, selection.weight);
+}
+
+double
+IrsLookupTableAtlas::GetMaxGain(const Selection& selection) const
+{
+    // blending never exceeds the larger of both slices
+    double bound = GetSliceLookupTable(selection.lower)->GetMaxGain();
+    if (selection.weight > 0)
+    {
+        bound = std::max(bound, GetSliceLookupTable(selection.upper)->GetMaxGain());
+    }
+    return bound;
+}
+
+double
+IrsLookupTableAtlas::GetMaxGain(const Selection& selection,
+                                double in_angle,
+                                double out_angle) const
+{
+    double bound = GetSliceLookupTable(selection.lower)->GetMaxGain(in_angle, out_angle);
+    if (selection.weight > 0)
+    {
+        bound = std::max(bound,
+                         GetSliceLookupTable(selection.upper)->GetMaxGain(in_angle, out_angle));
+    }
+    return bound;
+}
+
+void
+IrsLookupTableAtlas::SetInterpolate(bool interpolate)
+{
+    m_interpolate = interpolate;
+}
+
+bool
+IrsLookupTableAtlas::GetInterpolate() const
+{
+    return m_interpolate;
+}
+
+} // namespace ns3
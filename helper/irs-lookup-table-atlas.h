@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_LOOKUP_TABLE_ATLAS_H
+#define IRS_LOOKUP_TABLE_ATLAS_H
+
+#include "irs-lookup-table.h"
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @class IrsLookupTableAtlas
+ * @brief Collection of lookup tables indexed by the position (and optionally the orientation)
+ * of the IRS.
+ *
+ * Lookup tables depend on where the IRS is placed relative to the nodes it was optimized for. An
+ * atlas holds one slice per IRS position, so a mobile IRS or a placement sweep uses the table of
+ * the current position without any file I/O per step. Each slice references one of the tables
+ * of the atlas; slices with unchanged tables reference the same table, which is loaded once.
+ *
+ * Tables are loaded lazily on their first use: tables added by file name go through the
+ * \c IrsLookupTableRegistry, tables of an atlas file (see \c IrsLookupTableIo::ReadAtlas) are
+ * mapped from the file.
+ *
+ * \c Select picks the slice nearest to a position, among the slices with the orientation closest
+ * to the given direction. Slices for any orientation rank below slices facing less than 90
+ * degrees away from the direction. With the \c Interpolate attribute, positions between the two
+ * nearest slices are blended linearly, with gain (in dB) and phase shift interpolated by
+ * \c BlendIrsEntries like in \c IrsMultiFrequencyLookupTable.
+ */
+class IrsLookupTableAtlas : public Object
+{
+  public:
+    /**
+     * @brief Get the TypeId of this class.
+     * @return the TypeId
+     */
+    static TypeId GetTypeId();
+    IrsLookupTableAtlas();
+    ~IrsLookupTableAtlas() override;
+
+    /// The slices to use for a position, see \c Select
+    struct Selection
+    {
+        uint32_t lower; //!< Index of the nearest slice
+        uint32_t upper; //!< Index of the slice blended in, equal to lower if none
+        double weight;  //!< Weight of the upper slice in [0, 1)
+    };
+
+    /**
+     * @brief Add a table that is already loaded.
+     * @param table The lookup table
+     * @return Index of the table, the same for a table added before
+     */
+    uint32_t AddTable(Ptr<IrsLookupTable> table);
+
+    /**
+     * @brief Add a table that is loaded from a csv or binary file on first use.
+     * @param filename Path to the file
+     * @return Index of the table, the same for a file added before
+     */
+    uint32_t AddTable(const std::string& filename);
+
+    /**
+     * @brief Add a table that is loaded by a function on first use.
+     * @param loader Function returning the table, called at most once
+     * @return Index of the table
+     */
+    uint32_t AddTable(std::function<Ptr<IrsLookupTable>()> loader);
+
+    /**
+     * @brief Add a slice valid for any orientation.
+     * @param position Position of the IRS
+     * @param table Index of the table of the slice
+     * @return Index of the slice
+     */
+    uint32_t AddSlice(const Vector& position, uint32_t table);
+
+    /**
+     * @brief Add a slice for one orientation of the IRS.
+     * @param position Position of the IRS
+     * @param direction Direction of the IRS, a zero vector for any orientation
+     * @param table Index of the table of the slice
+     * @return Index of the slice
+     */
+    uint32_t AddSlice(const Vector& position, const Vector& direction, uint32_t table);
+
+    /**
+     * @brief Get the number of slices.
+     * @return Number of slices
+     */
+    uint32_t GetN() const;
+
+    /**
+     * @brief Get the number of distinct tables.
+     * @return Number of tables referenced by the slices
+     */
+    uint32_t GetNTables() const;
+
+    /**
+     * @brief Get the number of tables loaded so far.
+     * @return Number of tables that were used or added preloaded
+     */
+    uint32_t GetNLoadedTables() const;
+
+    /**
+     * @brief Get the position of a slice.
+     * @param slice Index of the slice
+     * @return Position of the IRS
+     */
+    Vector GetSlicePosition(uint32_t slice) const;
+
+    /**
+     * @brief Get the orientation of a slice.
+     * @param slice Index of the slice
+     * @return Normalized direction of the IRS, a zero vector for any orientation
+     */
+    Vector GetSliceDirection(uint32_t slice) const;
+
+    /**
+     * @brief Get the table index of a slice.
+     * @param slice Index of the slice
+     * @return Index of the table
+     */
+    uint32_t GetSliceTable(uint32_t slice) const;
+
+    /**
+     * @brief Get a table, loading it if needed.
+     * @param table Index of the table
+     * @return The lookup table
+     */
+    Ptr<IrsLookupTable> GetTable(uint32_t table) const;
+
+    /**
+     * @brief Get the table of a slice, loading it if needed.
+     * @param slice Index of the slice
+     * @return The lookup table
+     */
+    Ptr<IrsLookupTable> GetSliceLookupTable(uint32_t slice) const;
+
+    /**
+     * @brief Select the slices for an IRS position and orientation.
+     * @param position Position of the IRS
+     * @param direction Direction of the IRS
+     * @return The nearest slice, and with \c Interpolate the neighbouring slice to blend in
+     */
+    Selection Select(const Vector& position, const Vector& direction) const;
+
+    /**
+     * @brief Get an IRS entry of selected slices.
+     * @param selection Slices as returned by \c Select
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @param interpolateAngles Whether to interpolate between the grid points of each table
+     * @return The IRS entry
+     */
+    IrsEntry GetIrsEntry(const Selection& selection,
+                         double in_angle,
+                         double out_angle,
+                         bool interpolateAngles) const;
+
+    /**
+     * @brief Get an upper bound of the gain of selected slices.
+     * @param selection Slices as returned by \c Select
+     * @return Largest gain in dB over all angles
+     */
+    double GetMaxGain(const Selection& selection) const;
+
+    /**
+     * @brief Get an upper bound of the gain of selected slices around a pair of angles.
+     * @param selection Slices as returned by \c Select
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @return Largest gain in dB of the table sectors a lookup at the angles reads
+     */
+    double GetMaxGain(const Selection& selection, double in_angle, double out_angle) const;
+
+    /**
+     * @brief Set whether positions between slices are interpolated.
+     * @param interpolate true to blend the two nearest slices, false for the nearest one
+     */
+    void SetInterpolate(bool interpolate);
+
+    /**
+     * @brief Get whether positions between slices are interpolated.
+     * @return true if the two nearest slices are blended
+     */
+    bool GetInterpolate() const;
+
+  private:
+    /**
+     * @brief Look up an entry in one table.
+     * @param slice Index of the slice
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @param interpolateAngles Whether to interpolate between grid points
+     * @return The IRS entry of the table of the slice
+     */
+    IrsEntry GetSliceEntry(uint32_t slice,
+                           double in_angle,
+                           double out_angle,
+                           bool interpolateAngles) const;
+
+    /// A table of the atlas, loaded on first use
+    struct Table
+    {
+        Ptr<IrsLookupTable> table;                   //!< The table, null until loaded
+        std::function<Ptr<IrsLookupTable>()> loader; //!< Loads the table, null once loaded
+        std::string filename;                        //!< File of the table, empty if none
+    };
+
+    /// A position of the IRS
+    struct Slice
+    {
+        Vector position;  //!< Position of the IRS
+        Vector direction; //!< Normalized direction of the IRS, zero for any orientation
+        uint32_t table;   //!< Index of the table
+    };
+
+    mutable std::vector<Table> m_tables; //!< Tables referenced by the slices
+    std::vector<Slice> m_slices;         //!< Slices in the order they were added
+    bool m_interpolate;                  //!< Whether to blend the two nearest slices
+};
+
+} // namespace ns3
+
+#endif /* IRS_LOOKUP_TABLE_ATLAS_H */
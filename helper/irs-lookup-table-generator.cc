@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-lookup-table-generator.h"
+
+#include "ns3/abort.h"
+#include "ns3/angles.h"
+#include "ns3/double.h"
+#include "ns3/irs-reflection-pattern.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED(IrsLookupTableGenerator);
+
+namespace
+{
+/// Speed of light in vacuum in m/s
+constexpr double SPEED_OF_LIGHT = 299792458.0;
+
+/// Lowest gain stored in generated 4D tables in dB, within the range of IrsQuantizedEntry
+constexpr double MIN_GAIN_4D = -300;
+
+/**
+ * Abort unless a grid step divides a range of angles.
+ * @param resolution Grid step in degrees
+ * @param range Range of the angles in degrees
+ */
+void
+CheckResolution(double resolution, double range)
+{
+    double steps = range / resolution;
+    NS_ABORT_MSG_IF(!(resolution > 0) || resolution > range ||
+                        std::abs(steps - std::round(steps)) > 1e-9 * steps,
+                    "IrsLookupTableGenerator resolution must divide " << range
+                                                                      << " degrees, got "
+                                                                      << resolution);
+}
+} // namespace
+
+TypeId
+IrsLookupTableGenerator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::IrsLookupTableGenerator")
+            .SetParent<Object>()
+            .AddConstructor<IrsLookupTableGenerator>()
+            .AddAttribute("Threads",
+                          "Number of worker threads, 0 for one per hardware thread.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&IrsLookupTableGenerator::SetThreads,
+                                               &IrsLookupTableGenerator::GetThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Resolution",
+                          "Grid step of generated tables in degrees, must divide 180 degrees.",
+                          DoubleValue(1),
+                          MakeDoubleAccessor(&IrsLookupTableGenerator::SetResolution,
+                                             &IrsLookupTableGenerator::GetResolution),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("AzimuthResolution",
+                          "Azimuth step of generated 4D tables in degrees, must divide 360 "
+                          "degrees.",
+                          DoubleValue(5),
+                          MakeDoubleAccessor(&IrsLookupTableGenerator::SetAzimuthResolution,
+                                             &IrsLookupTableGenerator::GetAzimuthResolution),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("InclinationResolution",
+                          "Inclination step of generated 4D tables in degrees, must divide 90 "
+                          "degrees.",
+                          DoubleValue(5),
+                          MakeDoubleAccessor(&IrsLookupTableGenerator::SetInclinationResolution,
+                                             &IrsLookupTableGenerator::GetInclinationResolution),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("DeviationRange",
+                          "Range in dB below the largest gain of the IRS in which CalcDeviation "
+                          "compares a model to the IRS. Deep nulls outside of it are ignored.",
+                          DoubleValue(30),
+                          MakeDoubleAccessor(&IrsLookupTableGenerator::m_deviationRange),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("PatternOversampling",
+                          "Grid points per element along each axis of the IrsReflectionPattern "
+                          "that computes all outgoing directions of an incoming direction with "
+                          "one FFT. 0 evaluates every direction pair directly instead.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&IrsLookupTableGenerator::SetPatternOversampling,
+                                               &IrsLookupTableGenerator::GetPatternOversampling),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+IrsLookupTableGenerator::IrsLookupTableGenerator()
+    : m_threads(0),
+      m_resolution(1),
+      m_azimuthResolution(5),
+      m_inclinationResolution(5),
+      m_deviationRange(30),
+      m_patternOversampling(0)
+{
+}
+
+IrsLookupTableGenerator::~IrsLookupTableGenerator()
+{
+}
+
+Ptr<IrsSpectrumModel>
+IrsLookupTableGenerator::CreateIrs(uint16_t nr, uint16_t nc, double frequency)
+{
+    NS_ABORT_MSG_UNLESS(frequency > 0, "Frequency should be greater zero (in Hz).");
+    double spacing = 0.5 * SPEED_OF_LIGHT / frequency;
+    Ptr<IrsSpectrumModel> irs = CreateObject<IrsSpectrumModel>();
+    irs->SetN({nr, nc});
+    irs->SetSpacing({spacing, spacing});
+    irs->SetFrequency(frequency);
+    return irs;
+}
+
+void
+IrsLookupTableGenerator::Steer(Ptr<IrsSpectrumModel> irs, double inAngle, double outAngle)
+{
+    irs->CalcRCoeffs(Angles(DegreesToRadians(inAngle), 0), Angles(DegreesToRadians(outAngle), 0));
+}
+
+void
+IrsLookupTableGenerator::Steer(Ptr<IrsSpectrumModel> irs,
+                               double inAngle,
+                               double outAngle,
+                               double dApSta,
+                               double dApIrsSta,
+                               double delta,
+                               double alpha,
+                               uint32_t numIrs)
+{
+    NS_ABORT_MSG_UNLESS(numIrs > 0, "Number of IRS on the path should be greater zero.");
+    Steer(irs, inAngle, outAngle);
+    double shift = irs->CalcPhaseShift(dApSta, dApIrsSta, delta) / numIrs;
+    irs->SetRcoeffs(alpha * std::polar(1.0, shift) * irs->GetRcoeffs());
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableGenerator::Generate(Ptr<const IrsSpectrumModel> irs) const
+{
+    NS_ABORT_MSG_UNLESS(irs, "IRS of the IrsLookupTableGenerator can not be null.");
+    NS_ABORT_MSG_UNLESS(irs->GetRcoeffs().size() > 0,
+                        "Reflection coefficients must be calculated before use.");
+
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    table->SetResolution(m_resolution);
+    table->SetFrequency(irs->GetFrequency());
+    uint32_t n = table->GetNumAngles();
+
+    // input and output use the same grid, so every steering vector serves both
+    double lambda = SPEED_OF_LIGHT / irs->GetFrequency();
+    std::vector<Angles> directions;
+    std::vector<Eigen::VectorXcd> stv(m_patternOversampling > 0 ? 0 : n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        directions.emplace_back(DegreesToRadians(i * m_resolution), 0);
+        if (m_patternOversampling == 0)
+        {
+            stv[i] = irs->CalcSteeringvector(directions[i], lambda);
+        }
+    }
+
+    NS_LOG_DEBUG("Generating " << n << "x" << n << " entries");
+    std::vector<IrsEntry> entries(n * n);
+    ParallelFor(n, [&](uint32_t in) {
+        if (m_patternOversampling > 0)
+        {
+            IrsReflectionPattern pattern(m_patternOversampling);
+            pattern.Compute(*irs, directions[in], lambda);
+            for (uint32_t out = 0; out < n; ++out)
+            {
+                entries[in * n + out] = pattern.GetIrsEntry(directions[out]);
+            }
+            return;
+        }
+        for (uint32_t out = 0; out < n; ++out)
+        {
+            entries[in * n + out] = irs->CalcIrsEntry(stv[in], stv[out]);
+        }
+    });
+
+    for (uint32_t in = 0; in < n; ++in)
+    {
+        for (uint32_t out = 0; out < n; ++out)
+        {
+            const IrsEntry& entry = entries[in * n + out];
+            table->InsertAt(in * m_resolution, out * m_resolution, entry.gain, entry.phase_shift);
+        }
+    }
+    return table;
+}
+
+Ptr<IrsLookupTable4D>
+IrsLookupTableGenerator::Generate4D(Ptr<const IrsSpectrumModel> irs) const
+{
+    NS_ABORT_MSG_UNLESS(irs, "IRS of the IrsLookupTableGenerator can not be null.");
+    NS_ABORT_MSG_UNLESS(irs->GetRcoeffs().size() > 0,
+                        "Reflection coefficients must be calculated before use.");
+
+    Ptr<IrsLookupTable4D> table = CreateObject<IrsLookupTable4D>();
+    table->SetAzimuthResolution(m_azimuthResolution);
+    table->SetInclinationResolution(m_inclinationResolution);
+    table->SetFrequency(irs->GetFrequency());
+    uint32_t numInclinations = table->GetNumInclinations();
+    uint32_t n = table->GetNumDirections();
+
+    // directions are ordered like the rows of IrsLookupTable4D, azimuth from -180 degrees
+    double lambda = SPEED_OF_LIGHT / irs->GetFrequency();
+    std::vector<Angles> directions;
+    std::vector<Eigen::VectorXcd> stv(m_patternOversampling > 0 ? 0 : n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        double azimuth = (i / numInclinations) * m_azimuthResolution - 180;
+        double inclination = (i % numInclinations) * m_inclinationResolution;
+        directions.emplace_back(DegreesToRadians(azimuth), DegreesToRadians(inclination));
+        if (m_patternOversampling == 0)
+        {
+            stv[i] = irs->CalcSteeringvector(directions[i], lambda);
+        }
+    }
+
+    // the entries are quantized by the workers and handed to the table as its storage
+    NS_LOG_DEBUG("Generating " << n << "x" << n << " 4D entries");
+    auto entries = std::make_shared<std::vector<IrsQuantizedEntry>>(static_cast<uint64_t>(n) * n);
+    ParallelFor(n, [&](uint32_t in) {
+        IrsReflectionPattern pattern(std::max(m_patternOversampling, 1U));
+        if (m_patternOversampling > 0)
+        {
+            pattern.Compute(*irs, directions[in], lambda);
+        }
+        for (uint32_t out = 0; out < n; ++out)
+        {
+            IrsEntry entry = m_patternOversampling > 0 ? pattern.GetIrsEntry(directions[out])
+                                                       : irs->CalcIrsEntry(stv[in], stv[out]);
+            (*entries)[static_cast<uint64_t>(in) * n + out] =
+                IrsQuantizedEntry::Quantize(std::max(entry.gain, MIN_GAIN_4D), entry.phase_shift);
+        }
+    });
+    table->SetExternalStorage(entries->data(), entries);
+    return table;
+}
+
+Ptr<IrsLookupModel>
+IrsLookupTableGenerator::Bake(Ptr<const IrsSpectrumModel> irs,
+                              bool interpolate,
+                              Deviation* deviation) const
+{
+    Ptr<IrsLookupModel> model = CreateObject<IrsLookupModel>();
+    model->SetLookupTable4D(Generate4D(irs));
+    model->SetDirection(irs->GetDirection());
+    model->SetInterpolate(interpolate);
+    if (deviation)
+    {
+        *deviation = CalcDeviation(irs, model);
+        NS_LOG_INFO("Baked IRS with a deviation of up to "
+                    << deviation->gain << " dB and " << deviation->phaseShift << " rad over "
+                    << deviation->samples << " directions");
+    }
+    return model;
+}
+
+IrsLookupTableGenerator::Deviation
+IrsLookupTableGenerator::CalcDeviation(Ptr<const IrsSpectrumModel> irs,
+                                       Ptr<const IrsLookupModel> model) const
+{
+    NS_ABORT_MSG_UNLESS(irs && model, "IRS and model of the deviation can not be null.");
+    // the 4D lookups only read the table, so the workers can share the model
+    NS_ABORT_MSG_UNLESS(model->GetLookupTable4D(),
+                        "Deviation can only be measured for models with a 4D lookup table.");
+
+    // centers of the grid cells, the farthest points from the grid in every dimension
+    uint32_t numAzimuths = static_cast<uint32_t>(std::round(360 / m_azimuthResolution));
+    uint32_t numInclinations = static_cast<uint32_t>(std::round(90 / m_inclinationResolution));
+    uint32_t n = numAzimuths * numInclinations;
+    double lambda = SPEED_OF_LIGHT / irs->GetFrequency();
+    std::vector<Angles> directions;
+    std::vector<Eigen::VectorXcd> stv(n);
+    directions.reserve(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        double azimuth = (i / numInclinations + 0.5) * m_azimuthResolution - 180;
+        double inclination = (i % numInclinations + 0.5) * m_inclinationResolution;
+        directions.emplace_back(DegreesToRadians(azimuth), DegreesToRadians(inclination));
+        stv[i] = irs->CalcSteeringvector(directions.back(), lambda);
+    }
+
+    /// Comparison of one direction pair
+    struct Sample
+    {
+        float gain;           //!< Gain of the IRS in dB
+        float gainDeviation;  //!< Absolute gain deviation of the model in dB
+        float phaseDeviation; //!< Absolute phase shift deviation of the model in radians
+    };
+
+    std::vector<Sample> samples(static_cast<uint64_t>(n) * n);
+    ParallelFor(n, [&](uint32_t in) {
+        for (uint32_t out = 0; out < n; ++out)
+        {
+            IrsEntry expected = irs->CalcIrsEntry(stv[in], stv[out]);
+            IrsEntry entry = model->GetIrsEntry(directions[in], directions[out], lambda);
+            double phase = std::remainder(entry.phase_shift - expected.phase_shift, 2 * M_PI);
+            samples[static_cast<uint64_t>(in) * n + out] = {
+                static_cast<float>(expected.gain),
+                static_cast<float>(std::abs(entry.gain - expected.gain)),
+                static_cast<float>(std::abs(phase))};
+        }
+    });
+
+    float maxGain = -std::numeric_limits<float>::infinity();
+    for (const auto& sample : samples)
+    {
+        maxGain = std::max(maxGain, sample.gain);
+    }
+    Deviation deviation{0, 0, 0, 0, 0, 0, 0};
+    for (uint64_t i = 0; i < samples.size(); ++i)
+    {
+        const Sample& sample = samples[i];
+        if (sample.gain < maxGain - m_deviationRange)
+        {
+            continue;
+        }
+        ++deviation.samples;
+        deviation.phaseShift = std::max<double>(deviation.phaseShift, sample.phaseDeviation);
+        if (sample.gainDeviation > deviation.gain)
+        {
+            deviation.gain = sample.gainDeviation;
+            deviation.inAzimuth = RadiansToDegrees(directions[i / n].GetAzimuth());
+            deviation.inInclination = RadiansToDegrees(directions[i / n].GetInclination());
+            deviation.outAzimuth = RadiansToDegrees(directions[i % n].GetAzimuth());
+            deviation.outInclination = RadiansToDegrees(directions[i % n].GetInclination());
+        }
+    }
+    return deviation;
+}
+
+void
+IrsLookupTableGenerator::ParallelFor(uint32_t rows,
+                                     const std::function<void(uint32_t)>& body) const
+{
+    uint32_t threads = m_threads > 0 ? m_threads : std::thread::hardware_concurrency();
+    threads = std::clamp<uint32_t>(threads, 1, std::max<uint32_t>(rows, 1));
+
+    // rows are handed out one by one, so threads finishing early take over the remaining rows
+    std::atomic<uint32_t> nextRow{0};
+    auto work = [&]() {
+        for (uint32_t row = nextRow++; row < rows; row = nextRow++)
+        {
+            body(row);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < threads; ++i)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void
+IrsLookupTableGenerator::SetThreads(uint32_t threads)
+{
+    m_threads = threads;
+}
+
+uint32_t
+IrsLookupTableGenerator::GetThreads() const
+{
+    return m_threads;
+}
+
+void
+IrsLookupTableGenerator::SetPatternOversampling(uint32_t oversampling)
+{
+    m_patternOversampling = oversampling;
+}
+
+uint32_t
+IrsLookupTableGenerator::GetPatternOversampling() const
+{
+    return m_patternOversampling;
+}
+
+void
+IrsLookupTableGenerator::SetResolution(double resolution)
+{
+    CheckResolution(resolution, 180);
+    m_resolution = resolution;
+}
+
+double
+IrsLookupTableGenerator::GetResolution() const
+{
+    return m_resolution;
+}
+
+void
+IrsLookupTableGenerator::SetAzimuthResolution(double resolution)
+{
+    CheckResolution(resolution, 360);
+    m_azimuthResolution = resolution;
+}
+
+double
+IrsLookupTableGenerator::GetAzimuthResolution() const
+{
+    return m_azimuthResolution;
+}
+
+void
+IrsLookupTableGenerator::SetInclinationResolution(double resolution)
+{
+    CheckResolution(resolution, 90);
+    m_inclinationResolution = resolution;
+}
+
+double
+IrsLookupTableGenerator::GetInclinationResolution() const
+{
+    return m_inclinationResolution;
+}
+
+} // namespace ns3
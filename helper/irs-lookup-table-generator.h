@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_LOOKUP_TABLE_GENERATOR_H
+#define IRS_LOOKUP_TABLE_GENERATOR_H
+
+#include "irs-lookup-table-4d.h"
+#include "irs-lookup-table.h"
+
+#include "ns3/irs-lookup-model.h"
+#include "ns3/irs-spectrum-model.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+
+#include <cstdint>
+#include <functional>
+
+namespace ns3
+{
+
+/**
+ * @class IrsLookupTableGenerator
+ * @brief Generates lookup tables from an \c IrsSpectrumModel, replacing
+ * \c matlab/generateIrsLookupTable.m.
+ *
+ * Every grid point of the table is the response of the IRS to a signal arriving from the input
+ * azimuth and leaving towards the output azimuth (both with an elevation of 0), as computed by
+ * \c IrsSpectrumModel::CalcIrsEntry. The steering vectors of all grid angles are computed once,
+ * the rows of the table are then spread over \c Threads worker threads.
+ *
+ * \c CreateIrs and \c Steer set up an IRS like the MATLAB script: elements spaced by half a
+ * wavelength, and reflection coefficients steering from the input to the output angle, with or
+ * without a phase shift towards the LOS path.
+ *
+ * \c Bake turns a configured IRS into an \c IrsLookupModel with an \c IrsLookupTable4D, which
+ * the \c IrsPropagationLossModel queries with the same 3D angles as the \c IrsSpectrumModel. A
+ * lookup then costs a table read instead of an evaluation over all elements of the IRS. The
+ * error of the table is measured in the centers of the grid cells, the worst case for both
+ * nearest and interpolated lookups, see \c CalcDeviation.
+ *
+ * With \c PatternOversampling set, each incoming direction takes one FFT over the elements
+ * (\c IrsReflectionPattern) instead of one evaluation per outgoing direction. This pays off for
+ * large surfaces and fine grids, at the cost of the interpolation error of the pattern.
+ */
+class IrsLookupTableGenerator : public Object
+{
+  public:
+    /**
+     * @brief Get the TypeId of this class.
+     * @return the TypeId
+     */
+    static TypeId GetTypeId();
+    IrsLookupTableGenerator();
+    ~IrsLookupTableGenerator() override;
+
+    /// Largest deviation of a baked model from the IRS it was generated from
+    struct Deviation
+    {
+        double gain;           //!< Largest gain deviation in dB
+        double phaseShift;     //!< Largest phase shift deviation in radians
+        double inAzimuth;      //!< Input azimuth of the largest gain deviation in degrees
+        double inInclination;  //!< Input inclination of the largest gain deviation in degrees
+        double outAzimuth;     //!< Output azimuth of the largest gain deviation in degrees
+        double outInclination; //!< Output inclination of the largest gain deviation in degrees
+        uint64_t samples;      //!< Number of direction pairs compared
+    };
+
+    /**
+     * @brief Create an IRS with elements spaced by half a wavelength.
+     * @param nr Number of rows
+     * @param nc Number of columns
+     * @param frequency Operating frequency in Hz
+     * @return The IRS, without reflection coefficients
+     */
+    static Ptr<IrsSpectrumModel> CreateIrs(uint16_t nr, uint16_t nc, double frequency);
+
+    /**
+     * @brief Steer an IRS from an input to an output angle, without phase control.
+     * @param irs The IRS
+     * @param inAngle Optimal input azimuth in degrees
+     * @param outAngle Optimal output azimuth in degrees
+     */
+    static void Steer(Ptr<IrsSpectrumModel> irs, double inAngle, double outAngle);
+
+    /**
+     * @brief Steer an IRS from an input to an output angle, with a phase shift relative to the
+     * LOS path.
+     * @param irs The IRS
+     * @param inAngle Optimal input azimuth in degrees
+     * @param outAngle Optimal output azimuth in degrees
+     * @param dApSta Length of the LOS path in meters
+     * @param dApIrsSta Length of the path over the IRS in meters
+     * @param delta Phase shift to the LOS path in radians: 0 for constructive, pi for
+     * destructive interference
+     * @param alpha Amplitude of the reflection coefficients (gain control)
+     * @param numIrs Number of IRS on the path sharing the phase shift
+     */
+    static void Steer(Ptr<IrsSpectrumModel> irs,
+                      double inAngle,
+                      double outAngle,
+                      double dApSta,
+                      double dApIrsSta,
+                      double delta,
+                      double alpha = 1,
+                      uint32_t numIrs = 1);
+
+    /**
+     * @brief Generate the lookup table of an IRS.
+     * @param irs The IRS, with reflection coefficients
+     * @return A dense table on the \c Resolution grid, for the frequency of the IRS
+     *
+     * The IRS is only read, so it may be shared with a running simulation.
+     */
+    Ptr<IrsLookupTable> Generate(Ptr<const IrsSpectrumModel> irs) const;
+
+    /**
+     * @brief Generate the 4D lookup table of an IRS.
+     * @param irs The IRS, with reflection coefficients
+     * @return A table on the \c AzimuthResolution x \c InclinationResolution grid, indexed like
+     * the queries of the \c IrsPropagationLossModel to the \c IrsSpectrumModel
+     *
+     * Gains below -300 dB (deep nulls) are stored as -300 dB.
+     */
+    Ptr<IrsLookupTable4D> Generate4D(Ptr<const IrsSpectrumModel> irs) const;
+
+    /**
+     * @brief Replace an IRS by an equivalent lookup model.
+     * @param irs The IRS, with reflection coefficients
+     * @param interpolate Whether the model interpolates between the grid points
+     * @param deviation If not null, set to the deviation of the model from the IRS
+     * @return A lookup model with the table of \c Generate4D and the direction of the IRS
+     */
+    Ptr<IrsLookupModel> Bake(Ptr<const IrsSpectrumModel> irs,
+                             bool interpolate,
+                             Deviation* deviation = nullptr) const;
+
+    /**
+     * @brief Measure how far a baked model deviates from an IRS.
+     * @param irs The IRS, with reflection coefficients
+     * @param model The model replacing it, with a 4D table
+     * @return The largest deviation in the centers of the cells of the 4D grid, among the
+     * directions where the IRS is within \c DeviationRange of its largest gain
+     *
+     * Both are read from several threads at once. Only the 4D table of the model is read, other
+     * models (e.g. an \c IrsSpectrumModel with its caches or an atlas loading tables lazily)
+     * are not safe to share between threads.
+     */
+    Deviation CalcDeviation(Ptr<const IrsSpectrumModel> irs,
+                            Ptr<const IrsLookupModel> model) const;
+
+    /**
+     * @brief Set the number of worker threads.
+     * @param threads Number of threads, 0 for one per hardware thread
+     */
+    void SetThreads(uint32_t threads);
+
+    /**
+     * @brief Get the number of worker threads.
+     * @return Number of threads, 0 for one per hardware thread
+     */
+    uint32_t GetThreads() const;
+
+    /**
+     * @brief Set the oversampling of the reflection patterns the tables are generated from.
+     * @param oversampling Grid points per element along each axis, 0 to evaluate every
+     * direction pair directly
+     */
+    void SetPatternOversampling(uint32_t oversampling);
+
+    /**
+     * @brief Get the oversampling of the reflection patterns the tables are generated from.
+     * @return Grid points per element along each axis, 0 if every pair is evaluated directly
+     */
+    uint32_t GetPatternOversampling() const;
+
+    /**
+     * @brief Set the angular resolution of generated tables.
+     * @param resolution Grid step in degrees, must divide 180 degrees
+     */
+    void SetResolution(double resolution);
+
+    /**
+     * @brief Get the angular resolution of generated tables.
+     * @return Grid step in degrees
+     */
+    double GetResolution() const;
+
+    /**
+     * @brief Set the azimuth resolution of generated 4D tables.
+     * @param resolution Grid step in degrees, must divide 360 degrees
+     */
+    void SetAzimuthResolution(double resolution);
+
+    /**
+     * @brief Get the azimuth resolution of generated 4D tables.
+     * @return Grid step in degrees
+     */
+    double GetAzimuthResolution() const;
+
+    /**
+     * @brief Set the inclination resolution of generated 4D tables.
+     * @param resolution Grid step in degrees, must divide 90 degrees
+     */
+    void SetInclinationResolution(double resolution);
+
+    /**
+     * @brief Get the inclination resolution of generated 4D tables.
+     * @return Grid step in degrees
+     */
+    double GetInclinationResolution() const;
+
+  private:
+    /**
+     * @brief Run a function for every row on the worker threads.
+     * @param rows Number of rows
+     * @param body Function called once per row index, from several threads at once
+     */
+    void ParallelFor(uint32_t rows, const std::function<void(uint32_t)>& body) const;
+
+    uint32_t m_threads;             //!< Number of worker threads, 0 for one per hardware thread
+    double m_resolution;            //!< Grid step of generated tables in degrees
+    double m_azimuthResolution;     //!< Azimuth grid step of generated 4D tables in degrees
+    double m_inclinationResolution; //!< Inclination grid step of generated 4D tables in degrees
+    double m_deviationRange;        //!< Range below the largest gain compared in dB
+    uint32_t m_patternOversampling; //!< Oversampling of the FFT patterns, 0 for direct
+};
+
+} // namespace ns3
+
+#endif /* IRS_LOOKUP_TABLE_GENERATOR_H */
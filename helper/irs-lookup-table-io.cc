@@ -0,0 +1,1056 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-lookup-table-io.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IRS_HAVE_MMAP
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableIo");
+
+namespace
+{
+/// Entry format of binary tables holding two doubles per entry
+const uint16_t ENTRY_FORMAT_DOUBLE = 0;
+
+/// Entry format of binary tables holding two int16 per entry, see IrsQuantizedEntry
+const uint16_t ENTRY_FORMAT_INT16 = 1;
+
+/// Entry format of binary tables holding a low-rank factorization
+const uint16_t ENTRY_FORMAT_LOW_RANK = 2;
+
+/**
+ * Size of the payload of a low-rank binary table.
+ * @param numAngles Number of grid points per angle axis
+ * @param rank Rank of the factorization
+ * @return Size in bytes of the rank, the present mask and both factor matrices
+ */
+uint64_t
+LowRankPayloadSize(uint64_t numAngles, uint64_t rank)
+{
+    return sizeof(uint64_t) + (numAngles * numAngles + 63) / 64 * sizeof(uint64_t) +
+           2 * numAngles * rank * sizeof(std::complex<float>);
+}
+
+/// Entry format of binary tables holding only the entries of a sparse table
+const uint16_t ENTRY_FORMAT_SPARSE = 3;
+
+/**
+ * Size of the payload of a sparse binary table.
+ * @param numAngles Number of grid points per angle axis
+ * @param count Number of stored entries
+ * @return Size in bytes of the count, the floor gain, the present mask and the stored entries
+ */
+uint64_t
+SparsePayloadSize(uint64_t numAngles, uint64_t count)
+{
+    return sizeof(uint64_t) + sizeof(double) +
+           (numAngles * numAngles + 63) / 64 * sizeof(uint64_t) + count * sizeof(IrsEntry);
+}
+
+/// Magic at the start of every binary lookup table file
+const char IRS_LUT_MAGIC[8] = {'I', 'R', 'S', 'L', 'U', 'T', '\0', '\0'};
+
+/// Magic at the start of every binary 4D lookup table file
+const char IRS_LUT_4D_MAGIC[8] = {'I', 'R', 'S', 'L', 'U', 'T', '4', 'D'};
+
+/// Magic at the start of every binary lookup table atlas file
+const char IRS_ATLAS_MAGIC[8] = {'I', 'R', 'S', 'A', 'T', 'L', 'A', 'S'};
+
+/**
+ * Read a whole file with a single allocation.
+ * @param filename Path to the file
+ * @return The file content
+ */
+std::string
+ReadFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    NS_ABORT_MSG_IF(!file.is_open(), "IRS Lookup Table file not found.");
+    std::string buffer(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+    NS_ABORT_MSG_IF(!file, "Could not read IRS Lookup Table: " << filename);
+    return buffer;
+}
+
+/**
+ * Parse a csv table with N numbers per line. A non-numeric first line (the header) and empty
+ * lines are skipped.
+ * @param filename Path to the file
+ * @param valid Checks the range of the values of a line
+ * @return The values of all lines
+ */
+template <std::size_t N, typename Valid>
+std::vector<std::array<double, N>>
+ParseCsv(const std::string& filename, Valid valid)
+{
+    std::string buffer = ReadFile(filename);
+    std::vector<std::array<double, N>> rows;
+    rows.reserve(std::count(buffer.begin(), buffer.end(), '\n') + 1);
+
+    const char* pos = buffer.data();
+    const char* end = pos + buffer.size();
+    uint32_t lineNumber = 0;
+    while (pos < end)
+    {
+        const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (!eol)
+        {
+            eol = end;
+        }
+        const char* lineEnd = (eol > pos && *(eol - 1) == '\r') ? eol - 1 : eol;
+        const char* line = pos;
+        pos = eol + 1;
+        ++lineNumber;
+
+        if (line == lineEnd)
+        {
+            // skip empty lines, e.g. at the end of the file
+            continue;
+        }
+        if (lineNumber == 1 && !std::isdigit(static_cast<unsigned char>(*line)) && *line != '-')
+        {
+            // skip the header, e.g. in_angle,out_angle,gain_dB,phase_shift
+            continue;
+        }
+
+        // Parse the values separated by comma in place
+        std::array<double, N> row;
+        const char* cursor = line;
+        bool parsed = true;
+        for (std::size_t i = 0; i < N && parsed; ++i)
+        {
+            auto [ptr, ec] = std::from_chars(cursor, lineEnd, row[i]);
+            bool last = i + 1 == N;
+            parsed = ec == std::errc() &&
+                     (last ? ptr == lineEnd : ptr != lineEnd && *ptr == ',');
+            cursor = ptr + 1;
+        }
+        NS_ABORT_MSG_UNLESS(parsed && valid(row),
+                            "Malformed line " << lineNumber << " in IRS Lookup Table " << filename
+                                              << ": \"" << std::string(line, lineEnd) << "\"");
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+/**
+ * Find the coarsest grid step of the form span / k, k >= span / maxStep, that contains all
+ * angles of a csv table.
+ * @param angles All angles of one axis in degrees
+ * @param origin First angle of the grid in degrees
+ * @param span Width of the grid in degrees
+ * @param maxStep Largest grid step considered in degrees
+ * @param filename Path to the file, for error messages
+ * @return The grid step in degrees
+ */
+double
+InferResolution(std::vector<double> angles,
+                double origin,
+                double span,
+                double maxStep,
+                const std::string& filename)
+{
+    std::sort(angles.begin(), angles.end());
+    angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+    for (auto k = static_cast<uint32_t>(std::ceil(span / maxStep)); k <= span * 1000; ++k)
+    {
+        double step = span / k;
+        bool fits = std::all_of(angles.begin(), angles.end(), [origin, step](double angle) {
+            double steps = (angle - origin) / step;
+            return std::abs(steps - std::round(steps)) < 1e-6;
+        });
+        if (fits)
+        {
+            return step;
+        }
+    }
+    NS_FATAL_ERROR("Could not infer the angle resolution of IRS Lookup Table " << filename);
+}
+
+/**
+ * Find an embedded lookup table.
+ * @param name Name of the table, a directory and a .csv extension are ignored
+ * @return The table, null if it is not embedded
+ */
+const IrsEmbeddedLookupTable*
+LookupEmbedded(const std::string& name)
+{
+    std::filesystem::path path(name);
+    std::string stem = path.extension() == ".csv" ? path.stem().string()
+                                                  : path.filename().string();
+    for (const IrsEmbeddedLookupTable* table = g_irsEmbeddedLookupTables; table->name; ++table)
+    {
+        if (stem == table->name)
+        {
+            return table;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Map a whole file into memory, read-only.
+ * @param filename Path to the file
+ * @param fileSize Set to the size of the file in bytes
+ * @return The file content, unmapped once the last reference is gone
+ */
+std::shared_ptr<const void>
+MapFile(const std::string& filename, uint64_t& fileSize)
+{
+#ifdef IRS_HAVE_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, "IRS Lookup Table file not found.");
+    struct stat st;
+    NS_ABORT_MSG_IF(fstat(fd, &st) != 0 || st.st_size == 0,
+                    "Truncated IRS Lookup Table: " << filename);
+    fileSize = st.st_size;
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(mapping == MAP_FAILED, "Could not map IRS Lookup Table: " << filename);
+    return std::shared_ptr<const void>(mapping, [size = fileSize](const void* p) {
+        munmap(const_cast<void*>(p), size);
+    });
+#else
+    // no mmap available: read the file into memory
+    auto buffer = std::make_shared<std::string>(ReadFile(filename));
+    fileSize = buffer->size();
+    return std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+}
+
+/**
+ * Write header and payload of a binary table. The file is written under a temporary name and
+ * renamed, so tables still mapping an old version of the file stay intact.
+ * @param filename Path to the file
+ * @param header The header
+ * @param headerSize Size of the header in bytes
+ * @param payload The payload
+ * @param payloadSize Size of the payload in bytes
+ */
+void
+WriteFile(const std::string& filename,
+          const void* header,
+          uint64_t headerSize,
+          const void* payload,
+          uint64_t payloadSize)
+{
+    std::string tmpFilename = filename + ".tmp";
+    std::ofstream file(tmpFilename, std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!file.is_open(), "Could not open IRS Lookup Table for writing: " << filename);
+    file.write(static_cast<const char*>(header), headerSize);
+    file.write(static_cast<const char*>(payload), payloadSize);
+    file.close();
+    NS_ABORT_MSG_IF(!file, "Could not write IRS Lookup Table: " << filename);
+    NS_ABORT_MSG_IF(std::rename(tmpFilename.c_str(), filename.c_str()) != 0,
+                    "Could not write IRS Lookup Table: " << filename);
+}
+
+/**
+ * Check whether a file starts with the given magic.
+ * @param filename Path to the file
+ * @param expected The magic
+ * @return true if the file starts with the magic
+ */
+bool
+HasMagic(const std::string& filename, const char (&expected)[8])
+{
+    std::ifstream file(filename, std::ios::binary);
+    char magic[8];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, expected, sizeof(magic)) == 0;
+}
+
+/**
+ * Check the header of a binary file against the layout supported by \c IrsLookupTable.
+ * @param header The file header
+ * @param fileSize Size of the whole file in bytes
+ * @param filename Path to the file, for error messages
+ */
+void
+CheckHeader(const IrsLookupTableFileHeader& header, uint64_t fileSize, const std::string& filename)
+{
+    NS_ABORT_MSG_IF(std::memcmp(header.magic, IRS_LUT_MAGIC, sizeof(IRS_LUT_MAGIC)) != 0,
+                    "Not a binary IRS Lookup Table: " << filename);
+    NS_ABORT_MSG_IF(header.version != IrsLookupTableIo::VERSION,
+                    "Unsupported IRS Lookup Table version " << header.version << ": " << filename);
+    NS_ABORT_MSG_IF(header.entryFormat != ENTRY_FORMAT_DOUBLE &&
+                        header.entryFormat != ENTRY_FORMAT_INT16 &&
+                        header.entryFormat != ENTRY_FORMAT_LOW_RANK &&
+                        header.entryFormat != ENTRY_FORMAT_SPARSE,
+                    "Unsupported IRS Lookup Table entry format " << header.entryFormat << ": "
+                                                                 << filename);
+    NS_ABORT_MSG_IF(header.headerSize < sizeof(IrsLookupTableFileHeader) ||
+                        header.headerSize % alignof(IrsEntry) != 0,
+                    "Invalid IRS Lookup Table header size: " << filename);
+    NS_ABORT_MSG_IF(header.numInAngles < 2 || header.numInAngles != header.numOutAngles ||
+                        header.inAngleMin != 0 || header.inAngleMax != 180 ||
+                        header.outAngleMin != 0 || header.outAngleMax != 180 ||
+                        !(header.resolution > 0) ||
+                        std::abs((header.numInAngles - 1) * header.resolution - 180) > 1e-6,
+                    "Unsupported IRS Lookup Table angle grid: " << filename);
+    // the size of a low-rank or sparse payload depends on the rank or number of entries stored
+    // in it, see ReadBinary
+    bool variableSize = header.entryFormat == ENTRY_FORMAT_LOW_RANK ||
+                        header.entryFormat == ENTRY_FORMAT_SPARSE;
+    uint64_t numEntries = static_cast<uint64_t>(header.numInAngles) * header.numOutAngles;
+    uint64_t payloadSize = header.entryFormat == ENTRY_FORMAT_LOW_RANK
+                               ? LowRankPayloadSize(header.numInAngles, 0)
+                           : header.entryFormat == ENTRY_FORMAT_SPARSE
+                               ? SparsePayloadSize(header.numInAngles, 0)
+                           : header.entryFormat == ENTRY_FORMAT_INT16
+                               ? numEntries * sizeof(IrsQuantizedEntry)
+                               : numEntries * sizeof(IrsEntry);
+    NS_ABORT_MSG_IF((variableSize ? header.payloadSize < payloadSize
+                                  : header.payloadSize != payloadSize) ||
+                        fileSize < header.headerSize + header.payloadSize,
+                    "Truncated IRS Lookup Table: " << filename);
+}
+
+/**
+ * Check the header of a binary 4D file against the layout supported by \c IrsLookupTable4D.
+ * @param header The file header
+ * @param fileSize Size of the whole file in bytes
+ * @param filename Path to the file, for error messages
+ */
+void
+CheckHeader4D(const IrsLookupTable4DFileHeader& header,
+              uint64_t fileSize,
+              const std::string& filename)
+{
+    NS_ABORT_MSG_IF(std::memcmp(header.magic, IRS_LUT_4D_MAGIC, sizeof(IRS_LUT_4D_MAGIC)) != 0,
+                    "Not a binary 4D IRS Lookup Table: " << filename);
+    NS_ABORT_MSG_IF(header.version != IrsLookupTableIo::VERSION,
+                    "Unsupported IRS Lookup Table version " << header.version << ": " << filename);
+    NS_ABORT_MSG_IF(header.entryFormat != ENTRY_FORMAT_INT16 ||
+                        header.gainStep != IrsQuantizedEntry::GAIN_STEP,
+                    "Unsupported IRS Lookup Table entry format " << header.entryFormat << ": "
+                                                                 << filename);
+    NS_ABORT_MSG_IF(header.headerSize < sizeof(IrsLookupTable4DFileHeader) ||
+                        header.headerSize % alignof(IrsQuantizedEntry) != 0,
+                    "Invalid IRS Lookup Table header size: " << filename);
+    NS_ABORT_MSG_IF(!(header.azimuthResolution > 0) || !(header.inclinationResolution > 0) ||
+                        std::abs(header.numAzimuths * header.azimuthResolution - 360) > 1e-6 ||
+                        std::abs((header.numInclinations - 1.0) * header.inclinationResolution -
+                                 90) > 1e-6,
+                    "Unsupported IRS Lookup Table angle grid: " << filename);
+    uint64_t numDirections = static_cast<uint64_t>(header.numAzimuths) * header.numInclinations;
+    NS_ABORT_MSG_IF(header.payloadSize !=
+                            numDirections * numDirections * sizeof(IrsQuantizedEntry) ||
+                        fileSize < header.headerSize + header.payloadSize,
+                    "Truncated IRS Lookup Table: " << filename);
+}
+
+/**
+ * Create a lookup table referencing a binary table image in memory.
+ * @param data Start of the image, i.e. of its \c IrsLookupTableFileHeader
+ * @param size Size of the memory available at \p data in bytes
+ * @param owner Keeps the memory behind \p data alive
+ * @param filename Name of the image, for error messages
+ * @param verifyChecksum Whether to verify the payload checksum
+ * @return The lookup table, which uses the storage mode of the entry format
+ */
+Ptr<IrsLookupTable>
+ReadBinaryImage(const char* data,
+                uint64_t size,
+                std::shared_ptr<const void> owner,
+                const std::string& filename,
+                bool verifyChecksum)
+{
+    IrsLookupTableFileHeader header;
+    NS_ABORT_MSG_IF(size < sizeof(header), "Truncated IRS Lookup Table: " << filename);
+    std::memcpy(&header, data, sizeof(header));
+    CheckHeader(header, size, filename);
+    const char* payload = data + header.headerSize;
+    NS_ABORT_MSG_IF(verifyChecksum &&
+                        IrsLookupTableIo::Checksum(payload, header.payloadSize) != header.checksum,
+                    "Checksum mismatch in IRS Lookup Table: " << filename);
+
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    table->SetFrequency(header.frequency);
+    table->SetResolution(header.resolution);
+    if (header.entryFormat == ENTRY_FORMAT_LOW_RANK)
+    {
+        uint64_t rank;
+        std::memcpy(&rank, payload, sizeof(rank));
+        NS_ABORT_MSG_IF(rank > header.numInAngles ||
+                            header.payloadSize != LowRankPayloadSize(header.numInAngles, rank),
+                        "Truncated IRS Lookup Table: " << filename);
+        auto present = reinterpret_cast<const uint64_t*>(payload + sizeof(rank));
+        auto inFactors = reinterpret_cast<const std::complex<float>*>(
+            present + (static_cast<uint64_t>(header.numInAngles) * header.numInAngles + 63) / 64);
+        table->SetExternalStorage(rank,
+                                  present,
+                                  inFactors,
+                                  inFactors + static_cast<uint64_t>(header.numInAngles) * rank,
+                                  owner);
+    }
+    else if (header.entryFormat == ENTRY_FORMAT_SPARSE)
+    {
+        uint64_t count;
+        double floorGain;
+        std::memcpy(&count, payload, sizeof(count));
+        std::memcpy(&floorGain, payload + sizeof(count), sizeof(floorGain));
+        uint64_t numEntries = static_cast<uint64_t>(header.numInAngles) * header.numInAngles;
+        NS_ABORT_MSG_IF(count > numEntries ||
+                            header.payloadSize != SparsePayloadSize(header.numInAngles, count),
+                        "Truncated IRS Lookup Table: " << filename);
+        auto present =
+            reinterpret_cast<const uint64_t*>(payload + sizeof(count) + sizeof(floorGain));
+        auto entries = reinterpret_cast<const IrsEntry*>(present + (numEntries + 63) / 64);
+        table->SetFloorGain(floorGain);
+        table->SetExternalStorage(present, entries, owner);
+        NS_ABORT_MSG_IF(table->GetNumSparseEntries() != count,
+                        "Corrupt IRS Lookup Table: " << filename);
+    }
+    else if (header.entryFormat == ENTRY_FORMAT_INT16)
+    {
+        table->SetExternalStorage(reinterpret_cast<const IrsQuantizedEntry*>(payload), owner);
+    }
+    else
+    {
+        table->SetExternalStorage(reinterpret_cast<const IrsEntry*>(payload), owner);
+    }
+    return table;
+}
+
+/**
+ * Build the header and payload of a binary table.
+ * @param table The lookup table, encoded with the entry format of its storage mode
+ * @param header Set to the header
+ * @param assembledPayload Holds the payload if it is not contiguous in the table
+ * @return The payload of header.payloadSize bytes
+ */
+const void*
+EncodeBinary(Ptr<const IrsLookupTable> table,
+             IrsLookupTableFileHeader& header,
+             std::vector<char>& assembledPayload)
+{
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, IRS_LUT_MAGIC, sizeof(IRS_LUT_MAGIC));
+    header.version = IrsLookupTableIo::VERSION;
+    header.entryFormat = ENTRY_FORMAT_DOUBLE;
+    header.headerSize = sizeof(header);
+    header.numInAngles = table->GetNumAngles();
+    header.numOutAngles = table->GetNumAngles();
+    header.inAngleMin = 0;
+    header.inAngleMax = 180;
+    header.outAngleMin = 0;
+    header.outAngleMax = 180;
+    header.resolution = table->GetResolution();
+    header.frequency = table->GetFrequency();
+    uint64_t numEntries = static_cast<uint64_t>(header.numInAngles) * header.numOutAngles;
+    header.payloadSize = numEntries * sizeof(IrsEntry);
+    const void* payload = table->GetEntries();
+    IrsLookupTable::StorageMode mode = table->GetStorageMode();
+    if (mode == IrsLookupTable::QUANTIZED)
+    {
+        header.entryFormat = ENTRY_FORMAT_INT16;
+        header.payloadSize = numEntries * sizeof(IrsQuantizedEntry);
+        payload = table->GetQuantizedEntries();
+    }
+    else if (mode == IrsLookupTable::LOW_RANK)
+    {
+        // rank, present mask and factors are not contiguous in memory
+        header.entryFormat = ENTRY_FORMAT_LOW_RANK;
+        uint64_t rank = table->GetFactorRank();
+        uint64_t factorSize = header.numInAngles * rank * sizeof(std::complex<float>);
+        header.payloadSize = LowRankPayloadSize(header.numInAngles, rank);
+        assembledPayload.resize(header.payloadSize);
+        char* out = assembledPayload.data();
+        std::memcpy(out, &rank, sizeof(rank));
+        out += sizeof(rank);
+        uint64_t maskSize = header.payloadSize - sizeof(rank) - 2 * factorSize;
+        std::memcpy(out, table->GetPresentMask(), maskSize);
+        out += maskSize;
+        if (rank > 0)
+        {
+            std::memcpy(out, table->GetInFactors(), factorSize);
+            std::memcpy(out + factorSize, table->GetOutFactors(), factorSize);
+        }
+        payload = assembledPayload.data();
+    }
+    else if (mode == IrsLookupTable::SPARSE)
+    {
+        // count, floor gain, present mask and entries are not contiguous in memory either
+        header.entryFormat = ENTRY_FORMAT_SPARSE;
+        uint64_t count = table->GetNumSparseEntries();
+        double floorGain = table->GetFloorGain();
+        uint64_t maskSize = (numEntries + 63) / 64 * sizeof(uint64_t);
+        header.payloadSize = SparsePayloadSize(header.numInAngles, count);
+        assembledPayload.resize(header.payloadSize);
+        char* out = assembledPayload.data();
+        std::memcpy(out, &count, sizeof(count));
+        std::memcpy(out + sizeof(count), &floorGain, sizeof(floorGain));
+        out += sizeof(count) + sizeof(floorGain);
+        std::memcpy(out, table->GetPresentMask(), maskSize);
+        if (count > 0)
+        {
+            std::memcpy(out + maskSize, table->GetSparseEntries(), count * sizeof(IrsEntry));
+        }
+        payload = assembledPayload.data();
+    }
+    header.checksum = IrsLookupTableIo::Checksum(payload, header.payloadSize);
+    return payload;
+}
+
+/**
+ * Add the slices of a csv atlas index to an atlas. Table files are resolved relative to the
+ * directory of the index and loaded on first use.
+ * @param filename Path to the index
+ * @param atlas The atlas
+ */
+void
+ReadAtlasIndex(const std::string& filename, Ptr<IrsLookupTableAtlas> atlas)
+{
+    std::string buffer = ReadFile(filename);
+    std::filesystem::path directory = std::filesystem::path(filename).parent_path();
+    auto trim = [](std::string_view field) {
+        std::size_t begin = field.find_first_not_of(" \t\r");
+        std::size_t end = field.find_last_not_of(" \t\r");
+        return begin == std::string_view::npos ? std::string_view()
+                                               : field.substr(begin, end - begin + 1);
+    };
+
+    std::string_view rest(buffer);
+    for (uint32_t lineNumber = 1; !rest.empty(); ++lineNumber)
+    {
+        std::size_t newline = rest.find('\n');
+        std::string_view line = trim(rest.substr(0, newline));
+        rest = newline == std::string_view::npos ? std::string_view() : rest.substr(newline + 1);
+        if (line.empty())
+        {
+            continue;
+        }
+
+        // all fields but the last one, the table file, are numbers
+        std::vector<double> values;
+        bool numeric = true;
+        std::size_t comma;
+        while ((comma = line.find(',')) != std::string_view::npos)
+        {
+            std::string_view field = trim(line.substr(0, comma));
+            double value;
+            auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+            numeric = numeric && !field.empty() && result.ec == std::errc() &&
+                      result.ptr == field.data() + field.size();
+            values.push_back(value);
+            line = line.substr(comma + 1);
+        }
+        if (!numeric && lineNumber == 1)
+        {
+            // header
+            continue;
+        }
+        std::filesystem::path table(trim(line));
+        NS_ABORT_MSG_IF(!numeric || (values.size() != 3 && values.size() != 6) || table.empty(),
+                        "Invalid line " << lineNumber
+                                        << " in IRS Lookup Table atlas: " << filename);
+        if (table.is_relative())
+        {
+            table = directory / table;
+        }
+        Vector position(values[0], values[1], values[2]);
+        Vector direction =
+            values.size() == 6 ? Vector(values[3], values[4], values[5]) : Vector(0, 0, 0);
+        atlas->AddSlice(position, direction, atlas->AddTable(table.string()));
+    }
+    NS_ABORT_MSG_IF(atlas->GetN() == 0, "IRS Lookup Table atlas has no slices: " << filename);
+}
+
+} // namespace
+
+uint64_t
+IrsLookupTableIo::Checksum(const void* data, uint64_t size)
+{
+    // 64-bit FNV-1a, consuming 8 bytes per step
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash ^= word;
+        hash *= 0x100000001b3ULL;
+    }
+    for (; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableIo::ReadCsv(const std::string& filename, double resolution)
+{
+    // Parse all rows first, the angle grid is only known once every angle was seen
+    auto rows = ParseCsv<4>(filename, [](const std::array<double, 4>& row) {
+        return row[0] >= 0 && row[0] <= 180 && row[1] >= 0 && row[1] <= 180 &&
+               !std::isnan(row[2]);
+    });
+    if (resolution <= 0)
+    {
+        std::vector<double> angles;
+        angles.reserve(2 * rows.size());
+        for (const auto& row : rows)
+        {
+            angles.push_back(row[0]);
+            angles.push_back(row[1]);
+        }
+        resolution = InferResolution(std::move(angles), 0, 180, 1, filename);
+    }
+
+    // Create the lookup table, its dense storage is allocated once for all rows of the file
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    table->SetFrequency(FrequencyFromFilename(filename));
+    table->SetResolution(resolution);
+    for (const auto& row : rows)
+    {
+        table->InsertAt(row[0], row[1], row[2], row[3]);
+    }
+
+    NS_LOG_DEBUG("Read " << rows.size() << " entries with a resolution of "
+                         << table->GetResolution() << " degrees from IRS Lookup Table "
+                         << filename);
+    return table;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableIo::ReadEmbedded(const std::string& name)
+{
+    const IrsEmbeddedLookupTable* embedded = LookupEmbedded(name);
+    NS_ABORT_MSG_UNLESS(embedded,
+                        "IRS Lookup Table " << name << " is not embedded in the library, add it "
+                                            << "to NS3_IRS_EMBEDDED_LOOKUP_TABLES.");
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    table->SetFrequency(embedded->frequency);
+    table->SetResolution(embedded->resolution);
+
+    // a complete table in grid order is used in place, like a memory-mapped binary table
+    if (embedded->inGridOrder)
+    {
+        table->SetExternalStorage(embedded->entries, nullptr);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < embedded->numRows; ++i)
+        {
+            table->InsertAt(embedded->angles[i][0],
+                            embedded->angles[i][1],
+                            embedded->entries[i].gain,
+                            embedded->entries[i].phase_shift);
+        }
+    }
+
+    NS_LOG_DEBUG("Using embedded IRS Lookup Table " << embedded->name << " with "
+                                                    << embedded->numRows << " entries"
+                                                    << (embedded->inGridOrder ? " in place" : ""));
+    return table;
+}
+
+std::string
+IrsLookupTableIo::GetEmbeddedName(const std::string& name)
+{
+    const IrsEmbeddedLookupTable* embedded = LookupEmbedded(name);
+    return embedded ? embedded->name : "";
+}
+
+std::vector<std::string>
+IrsLookupTableIo::GetEmbeddedNames()
+{
+    std::vector<std::string> names;
+    for (const IrsEmbeddedLookupTable* table = g_irsEmbeddedLookupTables; table->name; ++table)
+    {
+        names.emplace_back(table->name);
+    }
+    return names;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableIo::ReadBinary(const std::string& filename, bool verifyChecksum)
+{
+    uint64_t fileSize;
+    std::shared_ptr<const void> owner = MapFile(filename, fileSize);
+    Ptr<IrsLookupTable> table = ReadBinaryImage(static_cast<const char*>(owner.get()),
+                                                fileSize,
+                                                owner,
+                                                filename,
+                                                verifyChecksum);
+    NS_LOG_DEBUG("Mapped binary IRS Lookup Table " << filename);
+    return table;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableIo::Read(const std::string& filename)
+{
+    if (IsBinary(filename))
+    {
+        return ReadBinary(filename);
+    }
+    return ReadCsv(filename);
+}
+
+void
+IrsLookupTableIo::WriteBinary(Ptr<const IrsLookupTable> table, const std::string& filename)
+{
+    NS_ABORT_MSG_UNLESS(table, "Lookup table can not be null.");
+    IrsLookupTableFileHeader header;
+    std::vector<char> assembledPayload;
+    const void* payload = EncodeBinary(table, header, assembledPayload);
+    WriteFile(filename, &header, sizeof(header), payload, header.payloadSize);
+}
+
+void
+IrsLookupTableIo::WriteCsv(Ptr<const IrsLookupTable> table, const std::string& filename)
+{
+    NS_ABORT_MSG_UNLESS(table, "Lookup table can not be null.");
+    std::ofstream file(filename, std::ios::trunc);
+    NS_ABORT_MSG_IF(!file.is_open(), "Could not open IRS Lookup Table for writing: " << filename);
+    file << "in_angle,out_angle,gain_dB,phase_shift\n";
+    file.precision(15);
+    Ptr<const IrsLookupTable> dense = table;
+    if (table->GetStorageMode() != IrsLookupTable::DENSE)
+    {
+        dense = table->Convert(IrsLookupTable::DENSE);
+    }
+    const IrsEntry* entries = dense->GetEntries();
+    uint32_t n = table->GetNumAngles();
+    double resolution = table->GetResolution();
+    for (uint32_t in = 0; in < n; ++in)
+    {
+        for (uint32_t out = 0; out < n; ++out)
+        {
+            const IrsEntry& entry = entries[in * n + out];
+            if (std::isnan(entry.gain))
+            {
+                continue; // missing entry
+            }
+            file << in * resolution << ',' << out * resolution << ',' << entry.gain << ','
+                 << entry.phase_shift << '\n';
+        }
+    }
+    file.close();
+    NS_ABORT_MSG_IF(!file, "Could not write IRS Lookup Table: " << filename);
+    NS_LOG_DEBUG("Wrote IRS Lookup Table " << filename);
+}
+
+bool
+IrsLookupTableIo::IsBinary(const std::string& filename)
+{
+    return HasMagic(filename, IRS_LUT_MAGIC);
+}
+
+Ptr<IrsLookupTableAtlas>
+IrsLookupTableIo::ReadAtlas(const std::string& filename)
+{
+    Ptr<IrsLookupTableAtlas> atlas = CreateObject<IrsLookupTableAtlas>();
+    if (!IsBinaryAtlas(filename))
+    {
+        ReadAtlasIndex(filename, atlas);
+        NS_LOG_DEBUG("Read IRS Lookup Table atlas index " << filename << " with "
+                                                          << atlas->GetN() << " slices and "
+                                                          << atlas->GetNTables() << " tables");
+        return atlas;
+    }
+
+    uint64_t fileSize;
+    std::shared_ptr<const void> owner = MapFile(filename, fileSize);
+    const char* data = static_cast<const char*>(owner.get());
+    IrsLookupTableAtlasFileHeader header;
+    NS_ABORT_MSG_IF(fileSize < sizeof(header), "Truncated IRS Lookup Table atlas: " << filename);
+    std::memcpy(&header, data, sizeof(header));
+    NS_ABORT_MSG_IF(header.version != VERSION,
+                    "Unsupported IRS Lookup Table atlas version " << header.version << ": "
+                                                                  << filename);
+    NS_ABORT_MSG_IF(header.headerSize < sizeof(header) ||
+                        header.headerSize % alignof(IrsLookupTableAtlasSliceRecord) != 0,
+                    "Invalid IRS Lookup Table atlas header size: " << filename);
+    uint64_t recordsSize =
+        static_cast<uint64_t>(header.numSlices) * sizeof(IrsLookupTableAtlasSliceRecord) +
+        static_cast<uint64_t>(header.numTables) * sizeof(IrsLookupTableAtlasTableRecord);
+    NS_ABORT_MSG_IF(fileSize < header.headerSize + recordsSize,
+                    "Truncated IRS Lookup Table atlas: " << filename);
+    NS_ABORT_MSG_IF(Checksum(data + header.headerSize, recordsSize) != header.checksum,
+                    "Checksum mismatch in IRS Lookup Table atlas: " << filename);
+
+    auto slices =
+        reinterpret_cast<const IrsLookupTableAtlasSliceRecord*>(data + header.headerSize);
+    auto tables =
+        reinterpret_cast<const IrsLookupTableAtlasTableRecord*>(slices + header.numSlices);
+    for (uint32_t i = 0; i < header.numTables; ++i)
+    {
+        IrsLookupTableAtlasTableRecord record = tables[i];
+        NS_ABORT_MSG_IF(record.offset % alignof(IrsEntry) != 0 || record.offset > fileSize ||
+                            record.size > fileSize - record.offset,
+                        "Truncated IRS Lookup Table atlas: " << filename);
+        // the tables share the mapping of the atlas, each is checked on its first use
+        std::string name = filename + ":" + std::to_string(i);
+        atlas->AddTable([owner, record, name]() {
+            return ReadBinaryImage(static_cast<const char*>(owner.get()) + record.offset,
+                                   record.size,
+                                   owner,
+                                   name,
+                                   true);
+        });
+    }
+    for (uint32_t i = 0; i < header.numSlices; ++i)
+    {
+        const IrsLookupTableAtlasSliceRecord& slice = slices[i];
+        NS_ABORT_MSG_IF(slice.table >= header.numTables,
+                        "Corrupt IRS Lookup Table atlas: " << filename);
+        atlas->AddSlice(Vector(slice.position[0], slice.position[1], slice.position[2]),
+                        Vector(slice.direction[0], slice.direction[1], slice.direction[2]),
+                        slice.table);
+    }
+    NS_LOG_DEBUG("Mapped IRS Lookup Table atlas " << filename << " with " << header.numSlices
+                                                  << " slices and " << header.numTables
+                                                  << " tables");
+    return atlas;
+}
+
+void
+IrsLookupTableIo::WriteAtlas(Ptr<const IrsLookupTableAtlas> atlas, const std::string& filename)
+{
+    NS_ABORT_MSG_UNLESS(atlas, "Lookup table atlas can not be null.");
+
+    // encode every table, identical tables are stored only once
+    std::vector<std::vector<char>> images;
+    std::vector<uint64_t> tableRecords(atlas->GetNTables());
+    for (uint32_t i = 0; i < atlas->GetNTables(); ++i)
+    {
+        IrsLookupTableFileHeader tableHeader;
+        std::vector<char> assembledPayload;
+        const void* payload = EncodeBinary(atlas->GetTable(i), tableHeader, assembledPayload);
+        std::vector<char> image(sizeof(tableHeader) + tableHeader.payloadSize);
+        std::memcpy(image.data(), &tableHeader, sizeof(tableHeader));
+        std::memcpy(image.data() + sizeof(tableHeader), payload, tableHeader.payloadSize);
+        auto it = std::find(images.begin(), images.end(), image);
+        tableRecords[i] = std::distance(images.begin(), it);
+        if (it == images.end())
+        {
+            images.push_back(std::move(image));
+        }
+    }
+
+    IrsLookupTableAtlasFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, IRS_ATLAS_MAGIC, sizeof(IRS_ATLAS_MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(header);
+    header.numSlices = atlas->GetN();
+    header.numTables = images.size();
+
+    // records first, then the tables at offsets aligned to 8 bytes
+    std::vector<IrsLookupTableAtlasSliceRecord> slices(header.numSlices);
+    for (uint32_t i = 0; i < header.numSlices; ++i)
+    {
+        Vector position = atlas->GetSlicePosition(i);
+        Vector direction = atlas->GetSliceDirection(i);
+        slices[i] = {{position.x, position.y, position.z},
+                     {direction.x, direction.y, direction.z},
+                     tableRecords[atlas->GetSliceTable(i)]};
+    }
+    std::vector<IrsLookupTableAtlasTableRecord> tables(header.numTables);
+    uint64_t recordsSize = slices.size() * sizeof(IrsLookupTableAtlasSliceRecord) +
+                           tables.size() * sizeof(IrsLookupTableAtlasTableRecord);
+    uint64_t offset = header.headerSize + recordsSize;
+    for (uint32_t i = 0; i < header.numTables; ++i)
+    {
+        offset = (offset + 7) / 8 * 8;
+        tables[i] = {offset, images[i].size()};
+        offset += images[i].size();
+    }
+
+    std::vector<char> body(offset - header.headerSize, 0);
+    std::memcpy(body.data(), slices.data(), slices.size() * sizeof(IrsLookupTableAtlasSliceRecord));
+    std::memcpy(body.data() + slices.size() * sizeof(IrsLookupTableAtlasSliceRecord),
+                tables.data(),
+                tables.size() * sizeof(IrsLookupTableAtlasTableRecord));
+    for (uint32_t i = 0; i < header.numTables; ++i)
+    {
+        std::memcpy(body.data() + tables[i].offset - header.headerSize,
+                    images[i].data(),
+                    images[i].size());
+    }
+    header.checksum = Checksum(body.data(), recordsSize);
+
+    WriteFile(filename, &header, sizeof(header), body.data(), body.size());
+    NS_LOG_DEBUG("Wrote IRS Lookup Table atlas " << filename << " with " << header.numSlices
+                                                 << " slices and " << header.numTables
+                                                 << " tables");
+}
+
+bool
+IrsLookupTableIo::IsBinaryAtlas(const std::string& filename)
+{
+    return HasMagic(filename, IRS_ATLAS_MAGIC);
+}
+
+Ptr<IrsLookupTable4D>
+IrsLookupTableIo::ReadCsv4D(const std::string& filename,
+                            double azimuthResolution,
+                            double inclinationResolution)
+{
+    auto rows = ParseCsv<6>(filename, [](const std::array<double, 6>& row) {
+        return row[0] >= -180 && row[0] <= 180 && row[1] >= 0 && row[1] <= 90 &&
+               row[2] >= -180 && row[2] <= 180 && row[3] >= 0 && row[3] <= 90 &&
+               !std::isnan(row[4]);
+    });
+    if (azimuthResolution <= 0 || inclinationResolution <= 0)
+    {
+        std::vector<double> azimuths;
+        std::vector<double> inclinations;
+        for (const auto& row : rows)
+        {
+            azimuths.push_back(row[0]);
+            azimuths.push_back(row[2]);
+            inclinations.push_back(row[1]);
+            inclinations.push_back(row[3]);
+        }
+        if (azimuthResolution <= 0)
+        {
+            azimuthResolution = InferResolution(std::move(azimuths), -180, 360, 360, filename);
+        }
+        if (inclinationResolution <= 0)
+        {
+            inclinationResolution = InferResolution(std::move(inclinations), 0, 90, 90, filename);
+        }
+    }
+
+    Ptr<IrsLookupTable4D> table = CreateObject<IrsLookupTable4D>();
+    table->SetFrequency(FrequencyFromFilename(filename));
+    table->SetAzimuthResolution(azimuthResolution);
+    table->SetInclinationResolution(inclinationResolution);
+    for (const auto& row : rows)
+    {
+        table->Insert(row[0], row[1], row[2], row[3], row[4], row[5]);
+    }
+
+    NS_LOG_DEBUG("Read " << rows.size() << " entries on a " << azimuthResolution << "x"
+                         << inclinationResolution << " degree grid from IRS Lookup Table "
+                         << filename);
+    return table;
+}
+
+Ptr<IrsLookupTable4D>
+IrsLookupTableIo::ReadBinary4D(const std::string& filename, bool verifyChecksum)
+{
+    uint64_t fileSize;
+    std::shared_ptr<const void> owner = MapFile(filename, fileSize);
+    IrsLookupTable4DFileHeader header;
+    NS_ABORT_MSG_IF(fileSize < sizeof(header), "Truncated IRS Lookup Table: " << filename);
+    std::memcpy(&header, owner.get(), sizeof(header));
+    CheckHeader4D(header, fileSize, filename);
+    auto entries = reinterpret_cast<const IrsQuantizedEntry*>(
+        static_cast<const char*>(owner.get()) + header.headerSize);
+    NS_ABORT_MSG_IF(verifyChecksum && Checksum(entries, header.payloadSize) != header.checksum,
+                    "Checksum mismatch in IRS Lookup Table: " << filename);
+
+    Ptr<IrsLookupTable4D> table = CreateObject<IrsLookupTable4D>();
+    table->SetFrequency(header.frequency);
+    table->SetAzimuthResolution(header.azimuthResolution);
+    table->SetInclinationResolution(header.inclinationResolution);
+    table->SetExternalStorage(entries, owner);
+    NS_LOG_DEBUG("Mapped binary 4D IRS Lookup Table " << filename);
+    return table;
+}
+
+Ptr<IrsLookupTable4D>
+IrsLookupTableIo::Read4D(const std::string& filename)
+{
+    if (IsBinary4D(filename))
+    {
+        return ReadBinary4D(filename);
+    }
+    return ReadCsv4D(filename);
+}
+
+void
+IrsLookupTableIo::WriteBinary4D(Ptr<const IrsLookupTable4D> table, const std::string& filename)
+{
+    NS_ABORT_MSG_UNLESS(table, "Lookup table can not be null.");
+    NS_ABORT_MSG_UNLESS(table->GetEntries(), "Can not write an empty IRS Lookup Table.");
+
+    IrsLookupTable4DFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, IRS_LUT_4D_MAGIC, sizeof(IRS_LUT_4D_MAGIC));
+    header.version = VERSION;
+    header.entryFormat = ENTRY_FORMAT_INT16;
+    header.headerSize = sizeof(header);
+    header.numAzimuths = table->GetNumAzimuths();
+    header.numInclinations = table->GetNumInclinations();
+    header.azimuthResolution = table->GetAzimuthResolution();
+    header.inclinationResolution = table->GetInclinationResolution();
+    header.gainStep = IrsQuantizedEntry::GAIN_STEP;
+    header.frequency = table->GetFrequency();
+    uint64_t numDirections = table->GetNumDirections();
+    header.payloadSize = numDirections * numDirections * sizeof(IrsQuantizedEntry);
+    header.checksum = Checksum(table->GetEntries(), header.payloadSize);
+
+    WriteFile(filename, &header, sizeof(header), table->GetEntries(), header.payloadSize);
+}
+
+bool
+IrsLookupTableIo::IsBinary4D(const std::string& filename)
+{
+    return HasMagic(filename, IRS_LUT_4D_MAGIC);
+}
+
+bool
+IrsLookupTableIo::IsCsv4D(const std::string& filename)
+{
+    std::ifstream file(filename);
+    std::string line;
+    return std::getline(file, line) && std::count(line.begin(), line.end(), ',') == 5;
+}
+
+double
+IrsLookupTableIo::FrequencyFromFilename(const std::string& filename)
+{
+    std::smatch match;
+    static const std::regex freq("FREQ([0-9]+(\\.[0-9]+)?)GHz");
+    std::string name = std::filesystem::path(filename).filename().string();
+    if (std::regex_search(name, match, freq))
+    {
+        return std::stod(match[1]) * 1e9;
+    }
+    return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_LOOKUP_TABLE_IO_H
+#define IRS_LOOKUP_TABLE_IO_H
+
+#include "irs-lookup-table-4d.h"
+#include "irs-lookup-table-atlas.h"
+#include "irs-lookup-table.h"
+
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @brief Header of a binary IRS lookup table file.
+ *
+ * The header is followed by numInAngles * numOutAngles entries (row-major by incoming angle,
+ * host byte order) on a grid from 0 to 180 degrees in steps of the resolution. Entry format 0
+ * stores \c IrsEntry values (two doubles each, missing entries hold a NaN gain), entry format 1
+ * stores \c IrsQuantizedEntry values (two int16 each) of a \c QUANTIZED table. Entry format 2
+ * stores the factorization of a \c LOW_RANK table instead: the rank as uint64, the bit mask of
+ * present entries ((numInAngles^2 + 63) / 64 uint64 words) and the incoming and outgoing factor
+ * matrices (numInAngles x rank complex floats each, row-major). Entry format 3 stores a
+ * \c SPARSE table: the number of stored entries as uint64, the floor gain as double, the bit
+ * mask of stored entries (like for format 2) and the stored \c IrsEntry values in row-major
+ * order. The checksum is a 64-bit FNV-1a hash over the payload, taken in 8 byte words.
+ */
+struct IrsLookupTableFileHeader
+{
+    char magic[8];         //!< "IRSLUT" padded with zeros
+    uint16_t version;      //!< File format version
+    uint16_t entryFormat;  //!< Layout of the entries, 0 to 3 as described above
+    uint32_t headerSize;   //!< Size of this header in bytes, offset of the payload
+    uint32_t numInAngles;  //!< Number of incoming angle grid points
+    uint32_t numOutAngles; //!< Number of outgoing angle grid points
+    double inAngleMin;     //!< First incoming angle in degrees
+    double inAngleMax;     //!< Last incoming angle in degrees
+    double outAngleMin;    //!< First outgoing angle in degrees
+    double outAngleMax;    //!< Last outgoing angle in degrees
+    double resolution;     //!< Grid resolution in degrees
+    double frequency;      //!< Carrier frequency in Hz, 0 if unknown
+    uint64_t payloadSize;  //!< Size of the entry payload in bytes
+    uint64_t checksum;     //!< FNV-1a hash of the payload
+};
+
+/**
+ * @brief Header of a binary 4D IRS lookup table file.
+ *
+ * The header is followed by (numAzimuths * numInclinations)^2 \c IrsQuantizedEntry values (two
+ * int16 each, row-major by incoming direction, host byte order). A direction is indexed by
+ * azimuth * numInclinations + inclination, the azimuth grid starts at -180 degrees and the
+ * inclination grid at 0 degrees. The checksum is computed like for \c IrsLookupTableFileHeader.
+ */
+struct IrsLookupTable4DFileHeader
+{
+    char magic[8];                //!< "IRSLUT4D"
+    uint16_t version;             //!< File format version
+    uint16_t entryFormat;         //!< Layout of the entries, 1 = int16 gain and phase shift
+    uint32_t headerSize;          //!< Size of this header in bytes, offset of the payload
+    uint32_t numAzimuths;         //!< Number of azimuth grid points
+    uint32_t numInclinations;     //!< Number of inclination grid points
+    double azimuthResolution;     //!< Azimuth grid step in degrees
+    double inclinationResolution; //!< Inclination grid step in degrees
+    double gainStep;              //!< Quantization step of the gain in dB
+    double frequency;             //!< Carrier frequency in Hz, 0 if unknown
+    uint64_t payloadSize;         //!< Size of the entry payload in bytes
+    uint64_t checksum;            //!< FNV-1a hash of the payload
+};
+
+/**
+ * @brief Header of a binary IRS lookup table atlas file.
+ *
+ * The header is followed by numSlices \c IrsLookupTableAtlasSliceRecord and numTables
+ * \c IrsLookupTableAtlasTableRecord values. Each table record points to a complete binary
+ * lookup table (\c IrsLookupTableFileHeader and payload) embedded in the file at an offset
+ * aligned to 8 bytes. Identical tables are stored only once. The checksum is computed like for
+ * \c IrsLookupTableFileHeader over the slice and table records, the embedded tables carry
+ * their own checksums.
+ */
+struct IrsLookupTableAtlasFileHeader
+{
+    char magic[8];       //!< "IRSATLAS"
+    uint16_t version;    //!< File format version
+    uint16_t reserved;   //!< Zero
+    uint32_t headerSize; //!< Size of this header in bytes, offset of the slice records
+    uint32_t numSlices;  //!< Number of slice records
+    uint32_t numTables;  //!< Number of table records
+    uint64_t checksum;   //!< FNV-1a hash of the slice and table records
+};
+
+/// A slice of a binary IRS lookup table atlas file
+struct IrsLookupTableAtlasSliceRecord
+{
+    double position[3];  //!< Position of the IRS
+    double direction[3]; //!< Normalized direction of the IRS, zero for any orientation
+    uint64_t table;      //!< Index of the table record
+};
+
+/// A table of a binary IRS lookup table atlas file
+struct IrsLookupTableAtlasTableRecord
+{
+    uint64_t offset; //!< Offset of the embedded table from the start of the file
+    uint64_t size;   //!< Size of the embedded table in bytes
+};
+
+/**
+ * @brief A lookup table compiled into the library.
+ *
+ * The rows of the csv file, converted by \c cmake/embed-lookup-tables.cmake at build time along
+ * with the resolution and frequency \c ReadCsv would infer. The tables listed in the
+ * \c NS3_IRS_EMBEDDED_LOOKUP_TABLES CMake variable are embedded.
+ */
+struct IrsEmbeddedLookupTable
+{
+    const char* name;         //!< Name of the csv file without the extension
+    const float (*angles)[2]; //!< Input and output angle of every row in degrees
+    const IrsEntry* entries;  //!< Gain and phase shift of every row
+    uint32_t numRows;         //!< Number of rows
+    double resolution;        //!< Angle resolution in degrees
+    double frequency;         //!< Frequency in Hz from the file name, 0 if it has none
+    bool inGridOrder;         //!< Whether the rows are every grid point in storage order
+};
+
+/// The embedded lookup tables, terminated by an entry with a null name
+extern const IrsEmbeddedLookupTable g_irsEmbeddedLookupTables[];
+
+/**
+ * @class IrsLookupTableIo
+ * @brief Reads and writes IRS lookup tables in csv and binary format.
+ *
+ * The csv format has the header \c in_angle,out_angle,gain_dB,phase_shift followed by one line
+ * per entry. Angles may be fractional, e.g. for tables with a resolution of 0.25 degrees. The
+ * binary format (\c IrsLookupTableFileHeader) is memory-mapped read-only and used by the table
+ * without any parse step.
+ *
+ * Atlases of tables indexed by IRS position (\c IrsLookupTableAtlas) are either a binary file
+ * (\c IrsLookupTableAtlasFileHeader) holding all tables, or a csv index with the header
+ * \c x,y,z,table or \c x,y,z,dx,dy,dz,table and one line per slice, naming a table file
+ * relative to the index.
+ *
+ * 4D tables (\c IrsLookupTable4D) use the csv header
+ * \c in_azimuth,in_inclination,out_azimuth,out_inclination,gain_dB,phase_shift with angles in
+ * degrees, and the quantized binary format \c IrsLookupTable4DFileHeader.
+ */
+class IrsLookupTableIo
+{
+  public:
+    /// Current binary file format version
+    static constexpr uint16_t VERSION = 1;
+
+    /**
+     * @brief Read a lookup table from a csv file.
+     * @param filename Path to the csv file
+     * @param resolution Grid step of the table in degrees, 0 to infer the coarsest grid of at
+     * most 1 degree that holds all angles of the file
+     * @return The lookup table, with the frequency taken from the file name if it contains one
+     */
+    static Ptr<IrsLookupTable> ReadCsv(const std::string& filename, double resolution = 0);
+
+    /**
+     * @brief Get a lookup table embedded in the library, without any I/O or parsing.
+     * @param name Name of the table, i.e. its csv file name without the extension. A directory
+     * or a .csv extension is ignored, so the path of the csv file can be given as well.
+     * @return The table. A complete table in row-major grid order uses the embedded entries
+     * directly, other tables are inserted into owned storage.
+     */
+    static Ptr<IrsLookupTable> ReadEmbedded(const std::string& name);
+
+    /**
+     * @brief Find a lookup table embedded in the library.
+     * @param name Name of the table, like for \c ReadEmbedded
+     * @return The name the table is embedded with, empty if \c ReadEmbedded does not find it
+     */
+    static std::string GetEmbeddedName(const std::string& name);
+
+    /**
+     * @brief Get the names of all lookup tables embedded in the library.
+     * @return The names in the order they were embedded
+     */
+    static std::vector<std::string> GetEmbeddedNames();
+
+    /**
+     * @brief Read a lookup table from a binary file by memory-mapping it.
+     * @param filename Path to the binary file
+     * @param verifyChecksum Whether to verify the payload checksum
+     * @return The lookup table, which references the mapped file and uses the storage mode of
+     * its entry format
+     */
+    static Ptr<IrsLookupTable> ReadBinary(const std::string& filename, bool verifyChecksum = true);
+
+    /**
+     * @brief Read a lookup table from a csv or binary file, detected by the file content.
+     * @param filename Path to the file
+     * @return The lookup table
+     */
+    static Ptr<IrsLookupTable> Read(const std::string& filename);
+
+    /**
+     * @brief Write a lookup table to a binary file.
+     * @param table The lookup table, written with the entry format of its storage mode
+     * @param filename Path to the binary file
+     */
+    static void WriteBinary(Ptr<const IrsLookupTable> table, const std::string& filename);
+
+    /**
+     * @brief Write a lookup table to a csv file.
+     * @param table The lookup table, every grid point holding an entry is written
+     * @param filename Path to the csv file
+     */
+    static void WriteCsv(Ptr<const IrsLookupTable> table, const std::string& filename);
+
+    /**
+     * @brief Check whether a file starts with the binary lookup table magic.
+     * @param filename Path to the file
+     * @return true if the file is a binary lookup table
+     */
+    static bool IsBinary(const std::string& filename);
+
+    /**
+     * @brief Compute the checksum used by the binary format.
+     * @param data Pointer to the data
+     * @param size Size of the data in bytes
+     * @return 64-bit FNV-1a hash over 8 byte words
+     */
+    static uint64_t Checksum(const void* data, uint64_t size);
+
+    /**
+     * @brief Read an atlas from a binary atlas file or a csv index.
+     * @param filename Path to the file
+     * @return The atlas, its tables are loaded on first use
+     *
+     * Binary atlas files are memory-mapped once, each embedded table is checked and used in
+     * place on its first use. Tables named by a csv index are loaded through the
+     * \c IrsLookupTableRegistry, so slices naming the same file share one table.
+     */
+    static Ptr<IrsLookupTableAtlas> ReadAtlas(const std::string& filename);
+
+    /**
+     * @brief Write an atlas to a binary atlas file, loading all of its tables.
+     * @param atlas The atlas, its tables are written with the entry format of their storage mode
+     * @param filename Path to the binary file
+     */
+    static void WriteAtlas(Ptr<const IrsLookupTableAtlas> atlas, const std::string& filename);
+
+    /**
+     * @brief Check whether a file starts with the binary atlas magic.
+     * @param filename Path to the file
+     * @return true if the file is a binary atlas
+     */
+    static bool IsBinaryAtlas(const std::string& filename);
+
+    /**
+     * @brief Read a 4D lookup table from a csv file.
+     * @param filename Path to the csv file
+     * @param azimuthResolution Azimuth grid step in degrees, 0 to infer the coarsest grid that
+     * holds all azimuths of the file
+     * @param inclinationResolution Inclination grid step in degrees, 0 to infer it
+     * @return The lookup table
+     */
+    static Ptr<IrsLookupTable4D> ReadCsv4D(const std::string& filename,
+                                           double azimuthResolution = 0,
+                                           double inclinationResolution = 0);
+
+    /**
+     * @brief Read a 4D lookup table from a binary file by memory-mapping it.
+     * @param filename Path to the binary file
+     * @param verifyChecksum Whether to verify the payload checksum
+     * @return The lookup table, which references the mapped file
+     */
+    static Ptr<IrsLookupTable4D> ReadBinary4D(const std::string& filename,
+                                              bool verifyChecksum = true);
+
+    /**
+     * @brief Read a 4D lookup table from a csv or binary file, detected by the file content.
+     * @param filename Path to the file
+     * @return The lookup table
+     */
+    static Ptr<IrsLookupTable4D> Read4D(const std::string& filename);
+
+    /**
+     * @brief Write a 4D lookup table to a binary file.
+     * @param table The lookup table
+     * @param filename Path to the binary file
+     */
+    static void WriteBinary4D(Ptr<const IrsLookupTable4D> table, const std::string& filename);
+
+    /**
+     * @brief Check whether a file starts with the binary 4D lookup table magic.
+     * @param filename Path to the file
+     * @return true if the file is a binary 4D lookup table
+     */
+    static bool IsBinary4D(const std::string& filename);
+
+    /**
+     * @brief Check whether a csv file holds a 4D lookup table, i.e. six values per line.
+     * @param filename Path to the file
+     * @return true if the file is a 4D csv table
+     */
+    static bool IsCsv4D(const std::string& filename);
+
+    /**
+     * @brief Parse the carrier frequency from a table name like
+     * IRS_400_IN135_OUT89_FREQ5.15GHz_[...].csv
+     * @param filename Name of or path to the table
+     * @return Frequency in Hz, 0 if the name does not contain a frequency
+     */
+    static double FrequencyFromFilename(const std::string& filename);
+};
+
+} // namespace ns3
+
+#endif /* IRS_LOOKUP_TABLE_IO_H */
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-lookup-table-registry.h"
+
+#include "irs-lookup-table-io.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <filesystem>
+#include <system_error>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableRegistry");
+
+NS_OBJECT_ENSURE_REGISTERED(IrsLookupTableRegistry);
+
+TypeId
+IrsLookupTableRegistry::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::IrsLookupTableRegistry")
+            .SetParent<Object>()
+            .AddConstructor<IrsLookupTableRegistry>()
+            .AddAttribute("MaxMemory",
+                          "Maximum memory (in bytes) of all lookup tables held by the registry. "
+                          "Zero disables sharing, every request loads the table again.",
+                          UintegerValue(256 * 1024 * 1024),
+                          MakeUintegerAccessor(&IrsLookupTableRegistry::SetMaxMemory,
+                                               &IrsLookupTableRegistry::GetMaxMemory),
+                          MakeUintegerChecker<uint64_t>());
+    return tid;
+}
+
+IrsLookupTableRegistry::IrsLookupTableRegistry()
+    : m_maxMemory(0),
+      m_memoryUsage(0),
+      m_useCounter(0)
+{
+}
+
+IrsLookupTableRegistry::~IrsLookupTableRegistry()
+{
+    m_tables.clear();
+}
+
+Ptr<IrsLookupTableRegistry>
+IrsLookupTableRegistry::Get()
+{
+    static Ptr<IrsLookupTableRegistry> registry = CreateObject<IrsLookupTableRegistry>();
+    return registry;
+}
+
+IrsLookupTableRegistry::Key
+IrsLookupTableRegistry::MakeKey(const std::string& filename, int variant)
+{
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::canonical(filename, ec);
+    NS_ABORT_MSG_IF(ec, "IRS Lookup Table file not found.");
+    uint64_t size = std::filesystem::file_size(path, ec);
+    NS_ABORT_MSG_IF(ec, "IRS Lookup Table file not found.");
+    int64_t mtime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+    NS_ABORT_MSG_IF(ec, "IRS Lookup Table file not found.");
+    return Key(path.string(), size, mtime, variant);
+}
+
+IrsLookupTableRegistry::Key
+IrsLookupTableRegistry::MakeEmbeddedKey(const std::string& name, int variant)
+{
+    std::string embeddedName = IrsLookupTableIo::GetEmbeddedName(name);
+    NS_ABORT_MSG_IF(embeddedName.empty(),
+                    "IRS Lookup Table " << name << " is not embedded in the library.");
+    return Key(embeddedName, 0, -1, variant);
+}
+
+Ptr<Object>
+IrsLookupTableRegistry::Find(const Key& key)
+{
+    auto it = m_tables.find(key);
+    if (it == m_tables.end())
+    {
+        return nullptr;
+    }
+    NS_LOG_DEBUG("Reusing IRS Lookup Table " << std::get<0>(key));
+    it->second.lastUse = ++m_useCounter;
+    return it->second.table;
+}
+
+void
+IrsLookupTableRegistry::Add(const Key& key, Ptr<Object> table, uint64_t memoryUsage)
+{
+    if (m_maxMemory == 0)
+    {
+        return;
+    }
+    NS_LOG_DEBUG("Loaded IRS Lookup Table " << std::get<0>(key));
+    auto it = m_tables.find(key);
+    if (it != m_tables.end())
+    {
+        m_memoryUsage -= it->second.memoryUsage;
+    }
+    m_tables[key] = {table, memoryUsage, ++m_useCounter};
+    m_memoryUsage += memoryUsage;
+    Evict();
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableRegistry::GetLookupTable(const std::string& filename)
+{
+    Key key = MakeKey(filename);
+    Ptr<IrsLookupTable> table = DynamicCast<IrsLookupTable>(Find(key));
+    if (!table)
+    {
+        table = IrsLookupTableIo::Read(std::get<0>(key));
+        table->SetReadOnly();
+        Add(key, table, table->GetMemoryUsage());
+    }
+    return table;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableRegistry::GetLookupTable(const std::string& filename,
+                                       IrsLookupTable::StorageMode mode)
+{
+    Key key = MakeKey(filename, mode + 1);
+    Ptr<IrsLookupTable> table = DynamicCast<IrsLookupTable>(Find(key));
+    if (!table)
+    {
+        table = IrsLookupTableIo::Read(std::get<0>(key));
+        if (table->GetStorageMode() != mode)
+        {
+            table = table->Convert(mode);
+        }
+        table->SetReadOnly();
+        Add(key, table, table->GetMemoryUsage());
+    }
+    return table;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableRegistry::GetEmbeddedLookupTable(const std::string& name)
+{
+    Key key = MakeEmbeddedKey(name);
+    Ptr<IrsLookupTable> table = DynamicCast<IrsLookupTable>(Find(key));
+    if (!table)
+    {
+        table = IrsLookupTableIo::ReadEmbedded(std::get<0>(key));
+        table->SetReadOnly();
+        Add(key, table, table->GetMemoryUsage());
+    }
+    return table;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTableRegistry::GetEmbeddedLookupTable(const std::string& name,
+                                               IrsLookupTable::StorageMode mode)
+{
+    Key key = MakeEmbeddedKey(name, mode + 1);
+    Ptr<IrsLookupTable> table = DynamicCast<IrsLookupTable>(Find(key));
+    if (!table)
+    {
+        table = IrsLookupTableIo::ReadEmbedded(std::get<0>(key));
+        if (table->GetStorageMode() != mode)
+        {
+            table = table->Convert(mode);
+        }
+        table->SetReadOnly();
+        Add(key, table, table->GetMemoryUsage());
+    }
+    return table;
+}
+
+Ptr<IrsLookupTable4D>
+IrsLookupTableRegistry::GetLookupTable4D(const std::string& filename)
+{
+    Key key = MakeKey(filename);
+    Ptr<IrsLookupTable4D> table = DynamicCast<IrsLookupTable4D>(Find(key));
+    if (!table)
+    {
+        table = IrsLookupTableIo::Read4D(std::get<0>(key));
+        table->SetReadOnly();
+        Add(key, table, table->GetMemoryUsage());
+    }
+    return table;
+}
+
+void
+IrsLookupTableRegistry::Evict()
+{
+    while (m_memoryUsage > m_maxMemory && !m_tables.empty())
+    {
+        // prefer tables no one else references, then the least recently used
+        auto victim = m_tables.begin();
+        for (auto it = m_tables.begin(); it != m_tables.end(); ++it)
+        {
+            bool unused = it->second.table->GetReferenceCount() == 1;
+            bool victimUnused = victim->second.table->GetReferenceCount() == 1;
+            if ((unused && !victimUnused) ||
+                (unused == victimUnused && it->second.lastUse < victim->second.lastUse))
+            {
+                victim = it;
+            }
+        }
+        NS_LOG_DEBUG("Dropping IRS Lookup Table " << std::get<0>(victim->first)
+                                                  << " from the registry");
+        m_memoryUsage -= victim->second.memoryUsage;
+        m_tables.erase(victim);
+    }
+}
+
+void
+IrsLookupTableRegistry::Clear()
+{
+    m_tables.clear();
+    m_memoryUsage = 0;
+}
+
+uint32_t
+IrsLookupTableRegistry::GetN() const
+{
+    return m_tables.size();
+}
+
+uint64_t
+IrsLookupTableRegistry::GetMemoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+void
+IrsLookupTableRegistry::SetMaxMemory(uint64_t bytes)
+{
+    m_maxMemory = bytes;
+    Evict();
+}
+
+uint64_t
+IrsLookupTableRegistry::GetMaxMemory() const
+{
+    return m_maxMemory;
+}
+
+} // namespace ns3
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_LOOKUP_TABLE_REGISTRY_H
+#define IRS_LOOKUP_TABLE_REGISTRY_H
+
+#include "irs-lookup-table-4d.h"
+#include "irs-lookup-table.h"
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+
+namespace ns3
+{
+
+/**
+ * @class IrsLookupTableRegistry
+ * @brief Process-wide cache of lookup tables (\c IrsLookupTable and \c IrsLookupTable4D) loaded
+ * from files or embedded in the library.
+ *
+ * Tables are keyed by the canonical path, size and modification time of their file, so every
+ * file is parsed only once per process, no matter how often a simulation is set up. Embedded
+ * tables are keyed by their name. The tables
+ * handed out are shared and therefore read-only. When the memory held by the registry exceeds
+ * \c MaxMemory, the least recently used tables are dropped from the registry; users still
+ * holding such a table keep it alive.
+ */
+class IrsLookupTableRegistry : public Object
+{
+  public:
+    /**
+     * @brief Get the TypeId of this class.
+     * @return the TypeId
+     */
+    static TypeId GetTypeId();
+    IrsLookupTableRegistry();
+    ~IrsLookupTableRegistry() override;
+
+    /**
+     * @brief Get the process-wide registry.
+     * @return The registry, created with the default attribute values on first use
+     */
+    static Ptr<IrsLookupTableRegistry> Get();
+
+    /**
+     * @brief Get the lookup table stored in a csv or binary file.
+     * @param filename Path to the file
+     * @return The shared, read-only table, loaded if the file was not seen before or changed
+     */
+    Ptr<IrsLookupTable> GetLookupTable(const std::string& filename);
+
+    /**
+     * @brief Get the lookup table stored in a csv or binary file, converted to a storage mode.
+     * @param filename Path to the file
+     * @param mode Storage mode of the table
+     * @return The shared, read-only table. Each storage mode of a file is held separately.
+     */
+    Ptr<IrsLookupTable> GetLookupTable(const std::string& filename,
+                                       IrsLookupTable::StorageMode mode);
+
+    /**
+     * @brief Get a lookup table embedded in the library (see \c IrsLookupTableIo::ReadEmbedded).
+     * @param name Name of the table
+     * @return The shared, read-only table
+     */
+    Ptr<IrsLookupTable> GetEmbeddedLookupTable(const std::string& name);
+
+    /**
+     * @brief Get a lookup table embedded in the library, converted to a storage mode.
+     * @param name Name of the table
+     * @param mode Storage mode of the table
+     * @return The shared, read-only table. Each storage mode of a table is held separately.
+     */
+    Ptr<IrsLookupTable> GetEmbeddedLookupTable(const std::string& name,
+                                               IrsLookupTable::StorageMode mode);
+
+    /**
+     * @brief Get the 4D lookup table stored in a csv or binary file.
+     * @param filename Path to the file
+     * @return The shared, read-only table, loaded if the file was not seen before or changed
+     */
+    Ptr<IrsLookupTable4D> GetLookupTable4D(const std::string& filename);
+
+    /**
+     * @brief Drop all tables from the registry.
+     */
+    void Clear();
+
+    /**
+     * @brief Get the number of tables held by the registry.
+     * @return Number of tables
+     */
+    uint32_t GetN() const;
+
+    /**
+     * @brief Get the memory held by the tables in the registry.
+     * @return Size in bytes
+     */
+    uint64_t GetMemoryUsage() const;
+
+    /**
+     * @brief Set the memory bound of the registry.
+     * @param bytes Maximum size of all tables held in bytes, 0 disables the registry
+     */
+    void SetMaxMemory(uint64_t bytes);
+
+    /**
+     * @brief Get the memory bound of the registry.
+     * @return Maximum size of all tables held in bytes
+     */
+    uint64_t GetMaxMemory() const;
+
+  private:
+    /// Canonical path, file size and modification time of a table file (or the name of an
+    /// embedded table), and the variant of the table loaded from it (storage mode + 1, 0 for
+    /// the table as stored)
+    typedef std::tuple<std::string, uint64_t, int64_t, int> Key;
+
+    /**
+     * @brief Identify the current version of a file.
+     * @param filename Path to the file
+     * @param variant Variant of the table loaded from the file
+     * @return The key of the file
+     */
+    static Key MakeKey(const std::string& filename, int variant = 0);
+
+    /**
+     * @brief Identify a table embedded in the library.
+     * @param name Name of the table
+     * @param variant Variant of the table loaded from it
+     * @return The key of the table, with a size of 0 and a modification time of -1
+     */
+    static Key MakeEmbeddedKey(const std::string& name, int variant = 0);
+
+    /**
+     * @brief Look up a table and mark it as used.
+     * @param key The key of the file
+     * @return The table, null if the registry does not hold it
+     */
+    Ptr<Object> Find(const Key& key);
+
+    /**
+     * @brief Add a freshly loaded table, unless the registry is disabled.
+     * @param key The key of the file
+     * @param table The table
+     * @param memoryUsage Size of the table in bytes
+     */
+    void Add(const Key& key, Ptr<Object> table, uint64_t memoryUsage);
+
+    /**
+     * @brief Drop least recently used tables until the memory bound holds.
+     *
+     * Tables without users apart from the registry are dropped first.
+     */
+    void Evict();
+
+    /// A table held by the registry
+    struct Entry
+    {
+        Ptr<Object> table;    //!< The shared table
+        uint64_t memoryUsage; //!< Size of the table in bytes
+        uint64_t lastUse;     //!< Value of m_useCounter at the last request
+    };
+
+    std::map<Key, Entry> m_tables; //!< Tables by file
+    uint64_t m_maxMemory;          //!< Memory bound in bytes
+    uint64_t m_memoryUsage;        //!< Memory held by m_tables in bytes
+    uint64_t m_useCounter;         //!< Logical clock for the LRU order
+};
+
+} // namespace ns3
+
+#endif /* IRS_LOOKUP_TABLE_REGISTRY_H */
@@ -9,9 +9,18 @@
 
 #include "irs-lookup-table.h"
 
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
 #include "ns3/fatal-error.h"
+#include "ns3/uinteger.h"
 
+#include <Eigen/Dense>
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <ostream>
 
 namespace ns3
@@ -20,40 +29,900 @@ namespace ns3
 TypeId
 IrsLookupTable::GetTypeId()
 {
-    static TypeId tid =
-        TypeId("ns3::IrsLookupTable").SetParent<Object>().AddConstructor<IrsLookupTable>();
+    static TypeId tid = TypeId("ns3::IrsLookupTable")
+                            .SetParent<Object>()
+                            .AddConstructor<IrsLookupTable>()
+                            .AddAttribute("Frequency",
+                                          "The carrier frequency (in Hz) the table was generated "
+                                          "for. Zero if unknown.",
+                                          DoubleValue(0),
+                                          MakeDoubleAccessor(&IrsLookupTable::SetFrequency,
+                                                             &IrsLookupTable::GetFrequency),
+                                          MakeDoubleChecker<double>(0))
+                            .AddAttribute("Resolution",
+                                          "The step (in degrees) of the angle grid. Must divide "
+                                          "180 degrees and can only be changed on an empty table.",
+                                          DoubleValue(1),
+                                          MakeDoubleAccessor(&IrsLookupTable::SetResolution,
+                                                             &IrsLookupTable::GetResolution),
+                                          MakeDoubleChecker<double>(0))
+                            .AddAttribute("StorageMode",
+                                          "How the entries are kept in memory. Quantized entries "
+                                          "take a quarter of the memory at an error of at most "
+                                          "0.005 dB in gain and pi/65536 in phase shift. LowRank "
+                                          "keeps a truncated SVD of the complex response. Sparse "
+                                          "only keeps the entries above the SparseThreshold.",
+                                          EnumValue(IrsLookupTable::DENSE),
+                                          MakeEnumAccessor<IrsLookupTable::StorageMode>(
+                                              &IrsLookupTable::SetStorageMode,
+                                              &IrsLookupTable::GetStorageMode),
+                                          MakeEnumChecker(IrsLookupTable::DENSE,
+                                                          "Dense",
+                                                          IrsLookupTable::QUANTIZED,
+                                                          "Quantized",
+                                                          IrsLookupTable::LOW_RANK,
+                                                          "LowRank",
+                                                          IrsLookupTable::SPARSE,
+                                                          "Sparse"))
+                            .AddAttribute("Rank",
+                                          "The rank of the factorization when converting to "
+                                          "LowRank storage. Zero selects the smallest rank that "
+                                          "meets the Tolerance.",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&IrsLookupTable::SetRank,
+                                                               &IrsLookupTable::GetRank),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("Tolerance",
+                                          "The maximum relative Frobenius error of the complex "
+                                          "response when converting to LowRank storage with a "
+                                          "Rank of zero.",
+                                          DoubleValue(1e-3),
+                                          MakeDoubleAccessor(&IrsLookupTable::SetTolerance,
+                                                             &IrsLookupTable::GetTolerance),
+                                          MakeDoubleChecker<double>(0))
+                            .AddAttribute("SparseThreshold",
+                                          "When converting to Sparse storage, entries whose gain "
+                                          "is more than this many dB below the largest gain of "
+                                          "the table are not stored.",
+                                          DoubleValue(30),
+                                          MakeDoubleAccessor(&IrsLookupTable::SetSparseThreshold,
+                                                             &IrsLookupTable::GetSparseThreshold),
+                                          MakeDoubleChecker<double>(0))
+                            .AddAttribute("FloorGain",
+                                          "The gain (in dB) returned for grid points that are not "
+                                          "stored in Sparse storage.",
+                                          DoubleValue(-100),
+                                          MakeDoubleAccessor(&IrsLookupTable::SetFloorGain,
+                                                             &IrsLookupTable::GetFloorGain),
+                                          MakeDoubleChecker<double>());
     return tid;
 }
 
+IrsEntry
+BlendIrsEntries(const IrsEntry& low, const IrsEntry& high, double t)
+{
+    // unwrap relative to the lower entry to blend across the +-pi discontinuity
+    double delta = std::remainder(high.phase_shift - low.phase_shift, 2 * M_PI);
+    return {low.gain + t * (high.gain - low.gain),
+            std::remainder(low.phase_shift + t * delta, 2 * M_PI)};
+}
+
+IrsQuantizedEntry
+IrsQuantizedEntry::Quantize(double gain, double phase_shift)
+{
+    NS_ABORT_MSG_IF(std::isnan(gain) || std::isnan(phase_shift),
+                    "Quantized IRS entries can not be NaN.");
+    double steps = std::round(gain / GAIN_STEP);
+    NS_ABORT_MSG_IF(steps <= MISSING || steps > INT16_MAX,
+                    "Gain out of range of a quantized IRS entry: " << gain << " dB");
+    // map [-pi, pi) onto the full int16 range, pi wraps to -pi
+    long phase = std::lround(std::remainder(phase_shift, 2 * M_PI) * (32768 / M_PI));
+    if (phase == 32768)
+    {
+        phase = -32768;
+    }
+    return {static_cast<int16_t>(steps), static_cast<int16_t>(phase)};
+}
+
+namespace
+{
+/**
+ * Shared storage of a table without any entries. Tables start out referencing it and copy it on
+ * the first insert, so tables backed by external storage never allocate their own.
+ * @return Row-major array of N_ANGLES * N_ANGLES missing entries
+ */
+const IrsEntry*
+GetEmptyEntries()
+{
+    static const std::vector<IrsEntry> empty(IrsLookupTable::N_ANGLES * IrsLookupTable::N_ANGLES,
+                                             {std::numeric_limits<double>::quiet_NaN(),
+                                              std::numeric_limits<double>::quiet_NaN()});
+    return empty.data();
+}
+} // namespace
+
 IrsLookupTable::IrsLookupTable()
+    : m_entries(GetEmptyEntries()),
+      m_quantized(nullptr),
+      m_inFactors(nullptr),
+      m_outFactors(nullptr),
+      m_present(nullptr),
+      m_factorRank(0),
+      m_rank(0),
+      m_tolerance(1e-3),
+      m_sparseEntries(nullptr),
+      m_numSparseEntries(0),
+      m_sparseThreshold(30),
+      m_floorGain(-100),
+      m_maxGain(-std::numeric_limits<double>::infinity()),
+      m_numSectors(0),
+      m_storageMode(DENSE),
+      m_frequency(0),
+      m_readOnly(false),
+      m_resolution(1),
+      m_stepsPerDegree(1),
+      m_numAngles(N_ANGLES)
 {
+    // no entries yet, every bound starts out at -infinity
+    m_numSectors = SectorIndex(m_numAngles - 1) + 1;
+    m_rowMaxGain.assign(m_numAngles, m_maxGain);
+    m_sectorMaxGain.assign(m_numSectors * m_numSectors, m_maxGain);
 }
 
 IrsLookupTable::~IrsLookupTable()
 {
     m_irsLookupTable.clear();
+    m_quantizedTable.clear();
+    m_factorTable.clear();
+    m_presentTable.clear();
+    m_sparseTable.clear();
+    m_sparseOffsets.clear();
+    m_rowMaxGain.clear();
+    m_sectorMaxGain.clear();
+}
+
+bool
+IrsLookupTable::AngleToIndex(double angle, uint32_t& index) const
+{
+    double position = angle * m_stepsPerDegree;
+    double rounded = std::round(position);
+    if (!(rounded >= 0 && rounded < m_numAngles) || std::abs(position - rounded) > 1e-6)
+    {
+        return false;
+    }
+    index = static_cast<uint32_t>(rounded);
+    return true;
 }
 
 void
 IrsLookupTable::Insert(uint8_t in_angle, uint8_t out_angle, double gain, double phase_shift)
 {
-    m_irsLookupTable[{in_angle, out_angle}] = {gain, phase_shift};
+    InsertAt(in_angle, out_angle, gain, phase_shift);
+}
+
+void
+IrsLookupTable::InsertAt(double in_angle, double out_angle, double gain, double phase_shift)
+{
+    uint32_t in;
+    uint32_t out;
+    NS_ABORT_MSG_IF(!AngleToIndex(in_angle, in) || !AngleToIndex(out_angle, out),
+                    "IrsLookupTable angles must be within [0, 180] degrees and on the "
+                        << m_resolution << " degree grid, got in_angle: " << in_angle
+                        << " and out_angle: " << out_angle);
+    NS_ABORT_MSG_IF(m_readOnly, "IrsLookupTable is read-only.");
+    NS_ABORT_MSG_IF(std::isnan(gain), "IrsLookupTable gain can not be NaN.");
+    NS_ABORT_MSG_IF(m_storageMode == LOW_RANK || m_storageMode == SPARSE,
+                    "IrsLookupTable with LowRank or Sparse storage does not support Insert. Fill "
+                    "the table with another storage mode and convert it afterwards.");
+    uint32_t size = m_numAngles * m_numAngles;
+    uint32_t index = in * m_numAngles + out;
+    if (m_storageMode == QUANTIZED)
+    {
+        if (m_quantizedTable.empty())
+        {
+            m_quantizedTable.assign(m_quantized, m_quantized + size);
+            m_quantized = m_quantizedTable.data();
+            m_owner.reset();
+        }
+        m_quantizedTable[index] = IrsQuantizedEntry::Quantize(gain, phase_shift);
+    }
+    else
+    {
+        if (m_irsLookupTable.empty())
+        {
+            // copy external storage before the first modification
+            m_irsLookupTable.assign(m_entries, m_entries + size);
+            m_entries = m_irsLookupTable.data();
+            m_owner.reset();
+        }
+        m_irsLookupTable[index] = {gain, phase_shift};
+    }
+    // overwriting the largest entry with a smaller one keeps a valid, if loose, bound
+    RaiseBounds(index, gain);
+}
+
+bool
+IrsLookupTable::ReadEntry(uint32_t index, IrsEntry& entry) const
+{
+    switch (m_storageMode)
+    {
+    case QUANTIZED: {
+        IrsQuantizedEntry quantized = m_quantized[index];
+        entry = quantized.Dequantize();
+        return quantized.gain != IrsQuantizedEntry::MISSING;
+    }
+    case LOW_RANK: {
+        if (!((m_present[index / 64] >> (index % 64)) & 1))
+        {
+            entry = {std::numeric_limits<double>::quiet_NaN(),
+                     std::numeric_limits<double>::quiet_NaN()};
+            return false;
+        }
+        const std::complex<float>* in = m_inFactors + (index / m_numAngles) * m_factorRank;
+        const std::complex<float>* out = m_outFactors + (index % m_numAngles) * m_factorRank;
+        // multiply by hand, std::complex multiplication checks for NaN and infinity
+        float re = 0;
+        float im = 0;
+        for (uint32_t k = 0; k < m_factorRank; ++k)
+        {
+            re += in[k].real() * out[k].real() - in[k].imag() * out[k].imag();
+            im += in[k].real() * out[k].imag() + in[k].imag() * out[k].real();
+        }
+        entry = {10 * std::log10(static_cast<double>(re) * re + static_cast<double>(im) * im),
+                 std::atan2(im, re)};
+        return true;
+    }
+    case SPARSE: {
+        uint64_t word = m_present[index / 64];
+        uint64_t bit = uint64_t(1) << (index % 64);
+        if (!(word & bit))
+        {
+            entry = {m_floorGain, 0};
+            return true;
+        }
+        // stored entries before the word plus the ones before the bit within the word
+        entry = m_sparseEntries[m_sparseOffsets[index / 64] + std::popcount(word & (bit - 1))];
+        return true;
+    }
+    default:
+        entry = m_entries[index];
+        return !std::isnan(entry.gain);
+    }
 }
 
 IrsEntry
 IrsLookupTable::GetIrsEntry(uint8_t in_angle, uint8_t out_angle) const
 {
-    auto key = std::make_pair(in_angle, out_angle);
-    auto it = m_irsLookupTable.find(key);
+    uint32_t in = in_angle;
+    uint32_t out = out_angle;
+    // whole degrees index the default grid directly
+    if (m_numAngles == N_ANGLES ? in < N_ANGLES && out < N_ANGLES
+                                : AngleToIndex(in_angle, in) && AngleToIndex(out_angle, out))
+    {
+        IrsEntry entry;
+        if (ReadEntry(in * m_numAngles + out, entry))
+        {
+            return entry;
+        }
+    }
+    NS_FATAL_ERROR("Entry in IrsLookupTable with in_angle: " << +in_angle << " and out_angle: "
+                                                             << +out_angle << " not Found.");
+}
+
+IrsEntry
+IrsLookupTable::GetNearestIrsEntry(double in_angle, double out_angle) const
+{
+    uint32_t in = std::lround(std::clamp(in_angle, 0.0, 180.0) * m_stepsPerDegree);
+    uint32_t out = std::lround(std::clamp(out_angle, 0.0, 180.0) * m_stepsPerDegree);
+    IrsEntry entry;
+    if (!ReadEntry(in * m_numAngles + out, entry))
+    {
+        NS_FATAL_ERROR("Entry in IrsLookupTable with in_angle: " << in * m_resolution
+                                                                 << " and out_angle: "
+                                                                 << out * m_resolution
+                                                                 << " not Found.");
+    }
+    return entry;
+}
+
+IrsEntry
+IrsLookupTable::GetInterpolatedIrsEntry(double in_angle, double out_angle) const
+{
+    double x = std::clamp(in_angle, 0.0, 180.0) * m_stepsPerDegree;
+    double y = std::clamp(out_angle, 0.0, 180.0) * m_stepsPerDegree;
+    // lower grid point, the last cell also covers the upper edge
+    uint32_t i = std::min(static_cast<uint32_t>(x), m_numAngles - 2);
+    uint32_t j = std::min(static_cast<uint32_t>(y), m_numAngles - 2);
+    double fx = x - i;
+    double fy = y - j;
+
+    uint32_t cell = i * m_numAngles + j;
+    const uint32_t corners[4] = {cell, cell + 1, cell + m_numAngles, cell + m_numAngles + 1};
+    const double weights[4] = {(1 - fx) * (1 - fy), (1 - fx) * fy, fx * (1 - fy), fx * fy};
+
+    double weight = 0;
+    IrsEntry blended{0, 0};
+    for (int k = 0; k < 4; ++k)
+    {
+        IrsEntry corner;
+        if (weights[k] == 0 || !ReadEntry(corners[k], corner))
+        {
+            continue;
+        }
+        weight += weights[k];
+        blended = BlendIrsEntries(blended, corner, weights[k] / weight);
+    }
+    if (weight == 0)
+    {
+        NS_FATAL_ERROR("No entry in IrsLookupTable around in_angle: " << in_angle
+                                                                      << " and out_angle: "
+                                                                      << out_angle);
+    }
+    return blended;
+}
+
+bool
+IrsLookupTable::IsEmpty() const
+{
+    if (m_owner)
+    {
+        return false;
+    }
+    for (const IrsEntry& entry : m_irsLookupTable)
+    {
+        if (!std::isnan(entry.gain))
+        {
+            return false;
+        }
+    }
+    for (const IrsQuantizedEntry& entry : m_quantizedTable)
+    {
+        if (entry.gain != IrsQuantizedEntry::MISSING)
+        {
+            return false;
+        }
+    }
+    for (uint64_t word : m_presentTable)
+    {
+        if (word != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+IrsLookupTable::Release()
+{
+    m_owner.reset();
+    m_irsLookupTable.clear();
+    m_irsLookupTable.shrink_to_fit();
+    m_quantizedTable.clear();
+    m_quantizedTable.shrink_to_fit();
+    m_factorTable.clear();
+    m_factorTable.shrink_to_fit();
+    m_presentTable.clear();
+    m_presentTable.shrink_to_fit();
+    m_sparseTable.clear();
+    m_sparseTable.shrink_to_fit();
+    m_sparseOffsets.clear();
+    m_sparseOffsets.shrink_to_fit();
+    m_entries = nullptr;
+    m_quantized = nullptr;
+    m_inFactors = nullptr;
+    m_outFactors = nullptr;
+    m_present = nullptr;
+    m_sparseEntries = nullptr;
+    m_factorRank = 0;
+    m_numSparseEntries = 0;
+}
 
-    if (it != m_irsLookupTable.end())
+void
+IrsLookupTable::Reset()
+{
+    Release();
+    uint32_t size = m_numAngles * m_numAngles;
+    if (m_storageMode == QUANTIZED)
     {
-        return it->second;
+        m_quantizedTable.assign(size, {IrsQuantizedEntry::MISSING, 0});
+        m_quantized = m_quantizedTable.data();
+    }
+    else if (m_storageMode == LOW_RANK || m_storageMode == SPARSE)
+    {
+        m_presentTable.assign((size + 63) / 64, 0);
+        m_present = m_presentTable.data();
+        if (m_storageMode == SPARSE)
+        {
+            IndexSparse();
+        }
+    }
+    else if (m_numAngles == N_ANGLES)
+    {
+        m_entries = GetEmptyEntries();
     }
     else
     {
-        NS_FATAL_ERROR("Entry in IrsLookupTable with in_angle: " << in_angle << " and out_angle: "
-                                                                 << out_angle << " not Found.");
+        m_irsLookupTable.assign(size,
+                                {std::numeric_limits<double>::quiet_NaN(),
+                                 std::numeric_limits<double>::quiet_NaN()});
+        m_entries = m_irsLookupTable.data();
+    }
+    UpdateBounds();
+}
+
+uint32_t
+IrsLookupTable::SectorIndex(uint32_t index) const
+{
+    return static_cast<uint32_t>(index * m_resolution / SECTOR_WIDTH);
+}
+
+void
+IrsLookupTable::UpdateBounds()
+{
+    double minusInfinity = -std::numeric_limits<double>::infinity();
+    m_numSectors = SectorIndex(m_numAngles - 1) + 1;
+    m_maxGain = minusInfinity;
+    m_rowMaxGain.assign(m_numAngles, minusInfinity);
+    m_sectorMaxGain.assign(m_numSectors * m_numSectors, minusInfinity);
+    for (uint32_t i = 0; i < m_numAngles * m_numAngles; ++i)
+    {
+        IrsEntry entry;
+        if (ReadEntry(i, entry))
+        {
+            RaiseBounds(i, entry.gain);
+        }
+    }
+}
+
+void
+IrsLookupTable::RaiseBounds(uint32_t index, double gain)
+{
+    uint32_t in = index / m_numAngles;
+    uint32_t sector = SectorIndex(in) * m_numSectors + SectorIndex(index % m_numAngles);
+    m_maxGain = std::max(m_maxGain, gain);
+    m_rowMaxGain[in] = std::max(m_rowMaxGain[in], gain);
+    m_sectorMaxGain[sector] = std::max(m_sectorMaxGain[sector], gain);
+}
+
+double
+IrsLookupTable::GetMaxGain() const
+{
+    return m_maxGain;
+}
+
+double
+IrsLookupTable::GetMaxGain(double in_angle) const
+{
+    // the grid rows on both sides cover nearest and interpolated lookups
+    double x = std::clamp(in_angle, 0.0, 180.0) * m_stepsPerDegree;
+    uint32_t low = static_cast<uint32_t>(x);
+    uint32_t high = std::min(low + 1, m_numAngles - 1);
+    return std::max(m_rowMaxGain[low], m_rowMaxGain[high]);
+}
+
+double
+IrsLookupTable::GetMaxGain(double in_angle, double out_angle) const
+{
+    double x = std::clamp(in_angle, 0.0, 180.0) * m_stepsPerDegree;
+    double y = std::clamp(out_angle, 0.0, 180.0) * m_stepsPerDegree;
+    uint32_t i = static_cast<uint32_t>(x);
+    uint32_t j = static_cast<uint32_t>(y);
+    double bound = -std::numeric_limits<double>::infinity();
+    for (uint32_t a = SectorIndex(i); a <= SectorIndex(std::min(i + 1, m_numAngles - 1)); ++a)
+    {
+        for (uint32_t b = SectorIndex(j); b <= SectorIndex(std::min(j + 1, m_numAngles - 1));
+             ++b)
+        {
+            bound = std::max(bound, m_sectorMaxGain[a * m_numSectors + b]);
+        }
+    }
+    return bound;
+}
+
+std::vector<IrsEntry>
+IrsLookupTable::Decode() const
+{
+    uint32_t size = m_numAngles * m_numAngles;
+    if (m_storageMode == DENSE)
+    {
+        return std::vector<IrsEntry>(m_entries, m_entries + size);
+    }
+    std::vector<IrsEntry> entries(size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (!ReadEntry(i, entries[i]))
+        {
+            entries[i].gain = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    return entries;
+}
+
+void
+IrsLookupTable::Encode(std::vector<IrsEntry> entries, StorageMode mode)
+{
+    m_storageMode = mode;
+    Reset();
+    if (mode == QUANTIZED)
+    {
+        for (uint32_t i = 0; i < entries.size(); ++i)
+        {
+            if (!std::isnan(entries[i].gain))
+            {
+                m_quantizedTable[i] =
+                    IrsQuantizedEntry::Quantize(entries[i].gain, entries[i].phase_shift);
+            }
+        }
+    }
+    else if (mode == LOW_RANK)
+    {
+        Factorize(entries);
+    }
+    else if (mode == SPARSE)
+    {
+        Sparsify(entries);
+    }
+    else
+    {
+        m_irsLookupTable = std::move(entries);
+        m_entries = m_irsLookupTable.data();
+    }
+    UpdateBounds();
+}
+
+void
+IrsLookupTable::Factorize(const std::vector<IrsEntry>& entries)
+{
+    // complex response, missing entries do not contribute
+    Eigen::MatrixXcd response = Eigen::MatrixXcd::Zero(m_numAngles, m_numAngles);
+    for (uint32_t i = 0; i < entries.size(); ++i)
+    {
+        if (!std::isnan(entries[i].gain))
+        {
+            m_presentTable[i / 64] |= uint64_t(1) << (i % 64);
+            response(i / m_numAngles, i % m_numAngles) =
+                std::polar(std::pow(10.0, entries[i].gain / 20), entries[i].phase_shift);
+        }
+    }
+
+    Eigen::BDCSVD<Eigen::MatrixXcd> svd(response, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    const Eigen::VectorXd& sigma = svd.singularValues();
+    uint32_t rank = std::min<uint32_t>(m_rank, sigma.size());
+    if (m_rank == 0)
+    {
+        // smallest rank whose discarded singular values stay within the tolerance
+        double limit = m_tolerance * m_tolerance * sigma.squaredNorm();
+        double discarded = sigma.squaredNorm();
+        while (rank < sigma.size() && discarded > limit)
+        {
+            discarded -= sigma(rank) * sigma(rank);
+            ++rank;
+        }
+    }
+
+    // H(in, out) = sum_k U(in, k) * S(k) * conj(V(out, k))
+    m_factorRank = rank;
+    m_factorTable.resize(2 * static_cast<std::size_t>(m_numAngles) * rank);
+    for (uint32_t a = 0; a < m_numAngles; ++a)
+    {
+        for (uint32_t k = 0; k < rank; ++k)
+        {
+            m_factorTable[a * rank + k] = std::complex<float>(svd.matrixU()(a, k) * sigma(k));
+            m_factorTable[(m_numAngles + a) * rank + k] =
+                std::complex<float>(std::conj(svd.matrixV()(a, k)));
+        }
+    }
+    m_inFactors = m_factorTable.data();
+    m_outFactors = m_factorTable.data() + static_cast<std::size_t>(m_numAngles) * rank;
+    m_present = m_presentTable.data();
+}
+
+void
+IrsLookupTable::Sparsify(const std::vector<IrsEntry>& entries)
+{
+    double peak = -std::numeric_limits<double>::infinity();
+    for (const IrsEntry& entry : entries)
+    {
+        if (entry.gain > peak)
+        {
+            peak = entry.gain;
+        }
+    }
+    // NaN gains of missing entries fail the comparison and are not stored either
+    double threshold = peak - m_sparseThreshold;
+    for (uint32_t i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].gain >= threshold)
+        {
+            m_presentTable[i / 64] |= uint64_t(1) << (i % 64);
+            m_sparseTable.push_back(entries[i]);
+        }
+    }
+    m_sparseTable.shrink_to_fit();
+    m_sparseEntries = m_sparseTable.data();
+    IndexSparse();
+}
+
+void
+IrsLookupTable::IndexSparse()
+{
+    uint32_t words = (m_numAngles * m_numAngles + 63) / 64;
+    m_sparseOffsets.resize(words);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < words; ++i)
+    {
+        m_sparseOffsets[i] = count;
+        count += std::popcount(m_present[i]);
+    }
+    m_numSparseEntries = count;
+}
+
+void
+IrsLookupTable::SetStorageMode(StorageMode mode)
+{
+    if (mode == m_storageMode)
+    {
+        return;
+    }
+    if (IsEmpty())
+    {
+        m_storageMode = mode;
+        Reset();
+        return;
+    }
+    NS_ABORT_MSG_IF(m_readOnly, "IrsLookupTable is read-only.");
+    Encode(Decode(), mode);
+}
+
+IrsLookupTable::StorageMode
+IrsLookupTable::GetStorageMode() const
+{
+    return m_storageMode;
+}
+
+Ptr<IrsLookupTable>
+IrsLookupTable::Convert(StorageMode mode) const
+{
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    table->SetFrequency(m_frequency);
+    table->SetResolution(m_resolution);
+    table->SetRank(m_rank);
+    table->SetTolerance(m_tolerance);
+    table->SetSparseThreshold(m_sparseThreshold);
+    table->SetFloorGain(m_floorGain);
+    table->Encode(Decode(), mode);
+    return table;
+}
+
+void
+IrsLookupTable::SetResolution(double resolution)
+{
+    double steps = 180.0 / resolution;
+    NS_ABORT_MSG_IF(!(resolution > 0) || resolution > 180 ||
+                        std::abs(steps - std::round(steps)) > 1e-9 * steps,
+                    "IrsLookupTable resolution must divide 180 degrees, got " << resolution);
+    NS_ABORT_MSG_UNLESS(IsEmpty(), "IrsLookupTable resolution can only be set on an empty table.");
+    m_resolution = resolution;
+    m_stepsPerDegree = 1.0 / resolution;
+    m_numAngles = static_cast<uint32_t>(std::round(steps)) + 1;
+    Reset();
+}
+
+double
+IrsLookupTable::GetResolution() const
+{
+    return m_resolution;
+}
+
+uint32_t
+IrsLookupTable::GetNumAngles() const
+{
+    return m_numAngles;
+}
+
+void
+IrsLookupTable::SetExternalStorage(const IrsEntry* entries, std::shared_ptr<const void> owner)
+{
+    NS_ABORT_MSG_UNLESS(entries, "External storage of IrsLookupTable can not be null.");
+    Release();
+    m_storageMode = DENSE;
+    m_owner = owner;
+    m_entries = entries;
+    UpdateBounds();
+}
+
+void
+IrsLookupTable::SetExternalStorage(const IrsQuantizedEntry* entries,
+                                   std::shared_ptr<const void> owner)
+{
+    NS_ABORT_MSG_UNLESS(entries, "External storage of IrsLookupTable can not be null.");
+    Release();
+    m_storageMode = QUANTIZED;
+    m_owner = owner;
+    m_quantized = entries;
+    UpdateBounds();
+}
+
+void
+IrsLookupTable::SetExternalStorage(uint32_t rank,
+                                   const uint64_t* present,
+                                   const std::complex<float>* inFactors,
+                                   const std::complex<float>* outFactors,
+                                   std::shared_ptr<const void> owner)
+{
+    NS_ABORT_MSG_UNLESS(present && (rank == 0 || (inFactors && outFactors)),
+                        "External storage of IrsLookupTable can not be null.");
+    Release();
+    m_storageMode = LOW_RANK;
+    m_owner = owner;
+    m_factorRank = rank;
+    m_present = present;
+    m_inFactors = inFactors;
+    m_outFactors = outFactors;
+    UpdateBounds();
+}
+
+void
+IrsLookupTable::SetExternalStorage(const uint64_t* present,
+                                   const IrsEntry* entries,
+                                   std::shared_ptr<const void> owner)
+{
+    NS_ABORT_MSG_UNLESS(present, "External storage of IrsLookupTable can not be null.");
+    Release();
+    m_storageMode = SPARSE;
+    m_owner = owner;
+    m_present = present;
+    m_sparseEntries = entries;
+    IndexSparse();
+    UpdateBounds();
+}
+
+const IrsEntry*
+IrsLookupTable::GetEntries() const
+{
+    return m_storageMode == DENSE ? m_entries : nullptr;
+}
+
+const IrsQuantizedEntry*
+IrsLookupTable::GetQuantizedEntries() const
+{
+    return m_storageMode == QUANTIZED ? m_quantized : nullptr;
+}
+
+uint32_t
+IrsLookupTable::GetFactorRank() const
+{
+    return m_storageMode == LOW_RANK ? m_factorRank : 0;
+}
+
+const std::complex<float>*
+IrsLookupTable::GetInFactors() const
+{
+    return m_storageMode == LOW_RANK ? m_inFactors : nullptr;
+}
+
+const std::complex<float>*
+IrsLookupTable::GetOutFactors() const
+{
+    return m_storageMode == LOW_RANK ? m_outFactors : nullptr;
+}
+
+const uint64_t*
+IrsLookupTable::GetPresentMask() const
+{
+    return m_storageMode == LOW_RANK || m_storageMode == SPARSE ? m_present : nullptr;
+}
+
+const IrsEntry*
+IrsLookupTable::GetSparseEntries() const
+{
+    return m_storageMode == SPARSE ? m_sparseEntries : nullptr;
+}
+
+uint32_t
+IrsLookupTable::GetNumSparseEntries() const
+{
+    return m_storageMode == SPARSE ? m_numSparseEntries : 0;
+}
+
+void
+IrsLookupTable::SetSparseThreshold(double threshold)
+{
+    NS_ABORT_MSG_IF(!(threshold >= 0), "IrsLookupTable sparse threshold can not be negative.");
+    m_sparseThreshold = threshold;
+}
+
+double
+IrsLookupTable::GetSparseThreshold() const
+{
+    return m_sparseThreshold;
+}
+
+void
+IrsLookupTable::SetFloorGain(double gain)
+{
+    NS_ABORT_MSG_IF(std::isnan(gain), "IrsLookupTable floor gain can not be NaN.");
+    m_floorGain = gain;
+    if (m_storageMode == SPARSE)
+    {
+        UpdateBounds();
+    }
+}
+
+double
+IrsLookupTable::GetFloorGain() const
+{
+    return m_floorGain;
+}
+
+void
+IrsLookupTable::SetRank(uint32_t rank)
+{
+    m_rank = rank;
+}
+
+uint32_t
+IrsLookupTable::GetRank() const
+{
+    return m_rank;
+}
+
+void
+IrsLookupTable::SetTolerance(double tolerance)
+{
+    NS_ABORT_MSG_IF(!(tolerance >= 0), "IrsLookupTable tolerance can not be negative.");
+    m_tolerance = tolerance;
+}
+
+double
+IrsLookupTable::GetTolerance() const
+{
+    return m_tolerance;
+}
+
+void
+IrsLookupTable::SetFrequency(double frequency)
+{
+    NS_ABORT_MSG_IF(frequency < 0, "Frequency can not be negative (in Hz).");
+    m_frequency = frequency;
+}
+
+double
+IrsLookupTable::GetFrequency() const
+{
+    return m_frequency;
+}
+
+void
+IrsLookupTable::SetReadOnly()
+{
+    m_readOnly = true;
+}
+
+bool
+IrsLookupTable::IsReadOnly() const
+{
+    return m_readOnly;
+}
+
+uint64_t
+IrsLookupTable::GetMemoryUsage() const
+{
+    uint64_t size = static_cast<uint64_t>(m_numAngles) * m_numAngles;
+    switch (m_storageMode)
+    {
+    case QUANTIZED:
+        return size * sizeof(IrsQuantizedEntry);
+    case LOW_RANK:
+        return (size + 63) / 64 * sizeof(uint64_t) +
+               2 * static_cast<uint64_t>(m_numAngles) * m_factorRank *
+                   sizeof(std::complex<float>);
+    case SPARSE:
+        return (size + 63) / 64 * (sizeof(uint64_t) + sizeof(uint32_t)) +
+               static_cast<uint64_t>(m_numSparseEntries) * sizeof(IrsEntry);
+    default:
+        return size * sizeof(IrsEntry);
     }
 }
 } // namespace ns3
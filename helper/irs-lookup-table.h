@@ -11,12 +11,15 @@
 #define IRS_LOOKUP_TABLE_H
 
 #include "ns3/object.h"
+#include "ns3/ptr.h"
 #include "ns3/type-id.h"
 
+#include <cmath>
+#include <complex>
 #include <cstddef>
 #include <cstdint>
-#include <unordered_map>
-#include <utility>
+#include <memory>
+#include <vector>
 
 struct IrsEntry
 {
@@ -24,33 +27,97 @@ struct IrsEntry
     double phase_shift;
 };
 
+namespace ns3
+{
+
 /**
- * @struct hash_tuple
- * @brief A custom hash function for std::pair<uint8_t, uint8_t>.
+ * @brief Gain and phase shift of an IRS entry, quantized to 16 bit each.
  *
- * Combines two 8-bit integers into a 16-bit value and hashes it,
- * using a simple hash function for efficient lookups.
+ * The gain is stored in steps of \c GAIN_STEP dB over [-327.67, 327.67] dB, the phase shift in
+ * steps of pi / 32768 radians over [-pi, pi). Rounding to the nearest step bounds the error of
+ * a dequantized entry to GAIN_STEP / 2 = 0.005 dB in gain and pi / 65536 (about 4.8e-5) radians
+ * in phase shift. A gain of \c MISSING marks a missing entry.
  */
-struct hash_tuple
+struct IrsQuantizedEntry
 {
-    std::size_t operator()(const std::pair<uint8_t, uint8_t>& p) const
-    {
-        // Combine the two 8-bit integers into a 16-bit integer
-        uint16_t combined = (static_cast<uint16_t>(p.first) << 8) | static_cast<uint16_t>(p.second);
+    int16_t gain;        //!< Gain in units of GAIN_STEP dB
+    int16_t phase_shift; //!< Phase shift in units of pi / 32768 radians
+
+    /**
+     * @brief Quantize an IRS entry.
+     * @param gain Gain in dB
+     * @param phase_shift Phase shift in radians, wrapped to [-pi, pi)
+     * @return The quantized entry
+     */
+    static IrsQuantizedEntry Quantize(double gain, double phase_shift);
 
-        // Use a standard hash function on the combined value
-        return std::hash<uint16_t>{}(combined);
+    /**
+     * @brief Convert the quantized entry back to gain and phase shift.
+     * @return The IRS entry
+     */
+    IrsEntry Dequantize() const
+    {
+        return {gain * GAIN_STEP, phase_shift * (M_PI / 32768)};
     }
+
+    /// Quantization step of the gain in dB
+    static constexpr double GAIN_STEP = 0.01;
+
+    /// Quantized gain of a missing entry
+    static constexpr int16_t MISSING = INT16_MIN;
 };
 
-namespace ns3
-{
+/**
+ * @brief Blend two IRS entries linearly.
+ * @param low Entry at t = 0
+ * @param high Entry at t = 1
+ * @param t Weight of \c high, in [0, 1]
+ * @return The entry with the gain (in dB) and the phase shift blended, the phase shift of
+ * \c high unwrapped relative to \c low and the result wrapped to [-pi, pi]
+ *
+ * A weighted mean of several entries is built by blending each entry into the mean of the
+ * previous ones, with its weight relative to the total weight so far.
+ */
+IrsEntry BlendIrsEntries(const IrsEntry& low, const IrsEntry& high, double t);
 
 /**
  * @class IrsLookupTable
  * @brief Represents a lookup table for IRS entries.
  *
  * Stores precomputed gain and phase shift values for given input and output angles.
+ * The angle grid covers 0 to 180 degrees for both angles in steps of the \c Resolution
+ * attribute (1 degree by default, i.e. 181x181 grid points). It is kept in a single
+ * contiguous array indexed by [in_angle][out_angle], so a lookup is one multiply-add
+ * and one load. Entries that were never inserted are marked with a NaN gain.
+ *
+ * Angles between the grid points can either be rounded to the nearest grid point
+ * (\c GetNearestIrsEntry) or bilinearly interpolated from the four neighbouring grid
+ * points (\c GetInterpolatedIrsEntry).
+ *
+ * The entries are either owned by the table or live in external read-only memory,
+ * e.g. a memory-mapped binary table file (see \c IrsLookupTableIo). An external table
+ * is copied into owned storage on the first \c Insert.
+ *
+ * The \c StorageMode attribute selects how entries are kept in memory. \c DENSE stores each
+ * entry as two doubles (16 bytes). \c QUANTIZED stores two 16 bit values
+ * (\c IrsQuantizedEntry, 4 bytes), a quarter of the dense size and about a fifteenth of a
+ * hash map node, at an error of at most 0.005 dB in gain and pi / 65536 radians in phase
+ * shift. \c LOW_RANK keeps a truncated singular value decomposition of the complex response
+ * H(in, out) = 10^(gain / 20) * exp(j * phase_shift): two factor matrices of GetNumAngles() x
+ * rank complex floats, so each entry is rebuilt by a dot product of length rank. The rank is
+ * either fixed by the \c Rank attribute or the smallest one that keeps the relative Frobenius
+ * error of H below \c Tolerance. Since the error is bounded on the linear response, entries with
+ * a low gain (nulls) have a larger error in dB than the main beam. \c SPARSE only stores the
+ * entries within \c SparseThreshold dB of the strongest one, next to a bit mask of the stored
+ * grid points and the number of stored entries before each 64 bit word of the mask. A lookup
+ * reads the mask word, counts the stored entries before its bit and reads the entry, so it stays
+ * O(1); grid points that are not stored return \c FloorGain with a phase shift of zero instead of
+ * being reported as missing. Lookups return \c IrsEntry in every mode.
+ *
+ * The table keeps upper bounds of its gain, for the whole table, per incoming angle and per
+ * sector of \c SECTOR_WIDTH x \c SECTOR_WIDTH degrees. They are rebuilt whenever the storage
+ * changes and let \c IrsPropagationLossModel drop paths that can not reach its pruning threshold
+ * after computing their 2D angles, before the table lookups and the 3D angles.
  */
 class IrsLookupTable : public Object
 {
@@ -63,15 +130,37 @@ class IrsLookupTable : public Object
     IrsLookupTable();
     ~IrsLookupTable() override;
 
+    /// How the entries are kept in memory
+    enum StorageMode
+    {
+        DENSE,     //!< Two doubles per entry
+        QUANTIZED, //!< Two int16 per entry, see IrsQuantizedEntry
+        LOW_RANK,  //!< Truncated SVD of the complex response
+        SPARSE,    //!< Only entries above a threshold, a floor gain for the rest
+    };
+
     /**
      * @brief Inserts an IRS entry into the lookup table.
      * @param in_angle Input angle as an 8-bit value
      * @param out_angle Output angle as an 8-bit value
      * @param gain Gain value associated with the angles
      * @param phase_shift Phase shift value associated with the angles
+     *
+     * Both angles must lie within [0, 180] degrees and on the angle grid.
      */
     void Insert(uint8_t in_angle, uint8_t out_angle, double gain, double phase_shift);
 
+    /**
+     * @brief Inserts an IRS entry at a grid point given by fractional angles.
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @param gain Gain value associated with the angles
+     * @param phase_shift Phase shift value associated with the angles
+     *
+     * Both angles must lie within [0, 180] degrees and on the angle grid.
+     */
+    void InsertAt(double in_angle, double out_angle, double gain, double phase_shift);
+
     /**
      * @brief Retrieves an IRS entry from the lookup table.
      * @param in_angle Input angle as an 8-bit value
@@ -80,8 +169,403 @@ class IrsLookupTable : public Object
      */
     IrsEntry GetIrsEntry(uint8_t in_angle, uint8_t out_angle) const;
 
+    /**
+     * @brief Retrieves the IRS entry of the grid point closest to the given angles.
+     * @param in_angle Input angle in degrees, clamped to [0, 180]
+     * @param out_angle Output angle in degrees, clamped to [0, 180]
+     * @return The IRS entry of the nearest grid point
+     */
+    IrsEntry GetNearestIrsEntry(double in_angle, double out_angle) const;
+
+    /**
+     * @brief Bilinearly interpolates the IRS entry from the four surrounding grid points.
+     * @param in_angle Input angle in degrees, clamped to [0, 180]
+     * @param out_angle Output angle in degrees, clamped to [0, 180]
+     * @return The interpolated IRS entry
+     *
+     * The gain is interpolated in dB. The grid points are blended one by one with
+     * \c BlendIrsEntries, so neighbours on both sides of the +-pi wrap are averaged correctly
+     * and the phase shift stays in [-pi, pi]. Missing grid points are left out and the weights
+     * of the remaining ones renormalized.
+     */
+    IrsEntry GetInterpolatedIrsEntry(double in_angle, double out_angle) const;
+
+    /**
+     * @brief Get an upper bound of the gain of all entries.
+     * @return Largest gain in dB, -infinity for an empty table
+     */
+    double GetMaxGain() const;
+
+    /**
+     * @brief Get an upper bound of the gain for an incoming angle.
+     * @param in_angle Input angle in degrees, clamped to [0, 180]
+     * @return Largest gain in dB of the grid rows a nearest or interpolated lookup at
+     * \p in_angle reads
+     */
+    double GetMaxGain(double in_angle) const;
+
+    /**
+     * @brief Get an upper bound of the gain around a pair of angles.
+     * @param in_angle Input angle in degrees, clamped to [0, 180]
+     * @param out_angle Output angle in degrees, clamped to [0, 180]
+     * @return Largest gain in dB of the sectors holding the grid points a nearest or
+     * interpolated lookup at the angles reads
+     */
+    double GetMaxGain(double in_angle, double out_angle) const;
+
+    /**
+     * @brief Use external read-only memory as storage for the table entries.
+     * @param entries Row-major array of GetNumAngles() * GetNumAngles() entries, missing entries
+     * hold a NaN gain
+     * @param owner Keeps the memory behind \p entries alive as long as the table uses it, may be
+     * null for static memory
+     */
+    void SetExternalStorage(const IrsEntry* entries, std::shared_ptr<const void> owner);
+
+    /**
+     * @brief Use external read-only memory holding quantized entries as storage.
+     * @param entries Row-major array of GetNumAngles() * GetNumAngles() entries, missing entries
+     * hold a gain of \c IrsQuantizedEntry::MISSING
+     * @param owner Keeps the memory behind \p entries alive as long as the table uses it, may be
+     * null for static memory
+     *
+     * Switches the table to \c QUANTIZED storage.
+     */
+    void SetExternalStorage(const IrsQuantizedEntry* entries, std::shared_ptr<const void> owner);
+
+    /**
+     * @brief Use external read-only memory holding a low-rank factorization as storage.
+     * @param rank Rank of the factorization
+     * @param present Bit mask of the present entries, bit (i % 64) of word i / 64 for the
+     * row-major index i
+     * @param inFactors Row-major GetNumAngles() x rank matrix U * S
+     * @param outFactors Row-major GetNumAngles() x rank matrix conj(V), so that
+     * H(in, out) = sum_k inFactors[in][k] * outFactors[out][k]
+     * @param owner Keeps the memory alive as long as the table uses it, may be null for static
+     * memory
+     *
+     * Switches the table to \c LOW_RANK storage.
+     */
+    void SetExternalStorage(uint32_t rank,
+                            const uint64_t* present,
+                            const std::complex<float>* inFactors,
+                            const std::complex<float>* outFactors,
+                            std::shared_ptr<const void> owner);
+
+    /**
+     * @brief Use external read-only memory holding sparse entries as storage.
+     * @param present Bit mask of the stored entries, bit (i % 64) of word i / 64 for the
+     * row-major index i
+     * @param entries The stored entries in row-major order, one per set bit of \p present
+     * @param owner Keeps the memory alive as long as the table uses it, may be null for static
+     * memory
+     *
+     * Switches the table to \c SPARSE storage. Grid points that are not stored return the
+     * \c FloorGain of the table.
+     */
+    void SetExternalStorage(const uint64_t* present,
+                            const IrsEntry* entries,
+                            std::shared_ptr<const void> owner);
+
+    /**
+     * @brief Get the raw table entries.
+     * @return Row-major array of GetNumAngles() * GetNumAngles() entries, null unless the table
+     * uses \c DENSE storage
+     */
+    const IrsEntry* GetEntries() const;
+
+    /**
+     * @brief Get the raw quantized table entries.
+     * @return Row-major array of GetNumAngles() * GetNumAngles() entries, null unless the table
+     * uses \c QUANTIZED storage
+     */
+    const IrsQuantizedEntry* GetQuantizedEntries() const;
+
+    /**
+     * @brief Get the rank of the low-rank factorization.
+     * @return The rank, 0 unless the table uses \c LOW_RANK storage
+     */
+    uint32_t GetFactorRank() const;
+
+    /**
+     * @brief Get the incoming angle factors of the low-rank factorization.
+     * @return Row-major GetNumAngles() x GetFactorRank() matrix, null unless the table uses
+     * \c LOW_RANK storage
+     */
+    const std::complex<float>* GetInFactors() const;
+
+    /**
+     * @brief Get the outgoing angle factors of the low-rank factorization.
+     * @return Row-major GetNumAngles() x GetFactorRank() matrix, null unless the table uses
+     * \c LOW_RANK storage
+     */
+    const std::complex<float>* GetOutFactors() const;
+
+    /**
+     * @brief Get the bit mask of present entries of the low-rank factorization or of the stored
+     * entries of a sparse table.
+     * @return (GetNumAngles()^2 + 63) / 64 words, null unless the table uses \c LOW_RANK or
+     * \c SPARSE storage
+     */
+    const uint64_t* GetPresentMask() const;
+
+    /**
+     * @brief Get the stored entries of a sparse table.
+     * @return GetNumSparseEntries() entries in row-major order, null unless the table uses
+     * \c SPARSE storage
+     */
+    const IrsEntry* GetSparseEntries() const;
+
+    /**
+     * @brief Get the number of stored entries of a sparse table.
+     * @return Number of set bits in GetPresentMask(), 0 unless the table uses \c SPARSE storage
+     */
+    uint32_t GetNumSparseEntries() const;
+
+    /**
+     * @brief Set the threshold used when converting to \c SPARSE storage.
+     * @param threshold Entries whose gain is more than this many dB below the largest gain of
+     * the table are not stored
+     */
+    void SetSparseThreshold(double threshold);
+
+    /**
+     * @brief Get the threshold used when converting to \c SPARSE storage.
+     * @return Distance in dB below the largest gain
+     */
+    double GetSparseThreshold() const;
+
+    /**
+     * @brief Set the gain returned for grid points not stored in \c SPARSE storage.
+     * @param gain Gain in dB
+     */
+    void SetFloorGain(double gain);
+
+    /**
+     * @brief Get the gain returned for grid points not stored in \c SPARSE storage.
+     * @return Gain in dB
+     */
+    double GetFloorGain() const;
+
+    /**
+     * @brief Set the rank used when converting to \c LOW_RANK storage.
+     * @param rank The rank, 0 to choose the smallest rank that meets the tolerance
+     */
+    void SetRank(uint32_t rank);
+
+    /**
+     * @brief Get the rank used when converting to \c LOW_RANK storage.
+     * @return The rank, 0 if chosen by the tolerance
+     */
+    uint32_t GetRank() const;
+
+    /**
+     * @brief Set the error tolerance used when converting to \c LOW_RANK storage.
+     * @param tolerance Maximum relative Frobenius error of the complex response
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * @brief Get the error tolerance used when converting to \c LOW_RANK storage.
+     * @return Maximum relative Frobenius error of the complex response
+     */
+    double GetTolerance() const;
+
+    /**
+     * @brief Set how the entries are kept in memory, converting the existing entries.
+     * @param mode The storage mode
+     *
+     * Converting to \c QUANTIZED rounds the entries as described for \c IrsQuantizedEntry,
+     * converting to \c LOW_RANK factorizes them with the \c Rank and \c Tolerance attributes,
+     * converting to \c SPARSE drops the entries below the \c SparseThreshold. \c Insert is not
+     * supported in \c LOW_RANK and \c SPARSE storage. Aborts on a read-only table that holds
+     * entries, use \c Convert to get a copy instead.
+     */
+    void SetStorageMode(StorageMode mode);
+
+    /**
+     * @brief Get how the entries are kept in memory.
+     * @return The storage mode
+     */
+    StorageMode GetStorageMode() const;
+
+    /**
+     * @brief Create a copy of the table with another storage mode.
+     * @param mode The storage mode of the copy
+     * @return The new, writable table with the same grid, frequency, low-rank and sparse
+     * settings and entries
+     */
+    Ptr<IrsLookupTable> Convert(StorageMode mode) const;
+
+    /**
+     * @brief Set the angular resolution of the grid.
+     * @param resolution Grid step in degrees, must divide 180 degrees
+     *
+     * Can only be changed while the table holds no entries.
+     */
+    void SetResolution(double resolution);
+
+    /**
+     * @brief Get the angular resolution of the grid.
+     * @return Grid step in degrees
+     */
+    double GetResolution() const;
+
+    /**
+     * @brief Get the number of grid points per angle axis.
+     * @return 180 / resolution + 1
+     */
+    uint32_t GetNumAngles() const;
+
+    /**
+     * @brief Set the carrier frequency the table was generated for.
+     * @param frequency Frequency in Hz, 0 if unknown
+     */
+    void SetFrequency(double frequency);
+
+    /**
+     * @brief Get the carrier frequency the table was generated for.
+     * @return Frequency in Hz, 0 if unknown
+     */
+    double GetFrequency() const;
+
+    /**
+     * @brief Mark the table as read-only. Any further \c Insert aborts.
+     *
+     * Used for tables shared between several users, e.g. by the \c IrsLookupTableRegistry.
+     */
+    void SetReadOnly();
+
+    /**
+     * @brief Check whether the table is read-only.
+     * @return true if \c Insert is not allowed
+     */
+    bool IsReadOnly() const;
+
+    /**
+     * @brief Get the memory held by the table entries.
+     * @return Size of the entry storage in bytes
+     */
+    uint64_t GetMemoryUsage() const;
+
+    /// Number of grid points per angle axis at the default resolution (0 to 180 degrees in 1
+    /// degree steps)
+    static constexpr uint16_t N_ANGLES = 181;
+
+    /// Width of the sectors of the gain bounds in degrees
+    static constexpr double SECTOR_WIDTH = 10;
+
   private:
-    std::unordered_map<std::pair<uint8_t, uint8_t>, IrsEntry, hash_tuple> m_irsLookupTable;
+    /**
+     * @brief Convert an angle on the grid to its index.
+     * @param angle Angle in degrees
+     * @param index The grid index, set if the angle lies on the grid
+     * @return true if the angle lies on the grid
+     */
+    bool AngleToIndex(double angle, uint32_t& index) const;
+
+    /**
+     * @brief Check whether any entry was inserted or external storage is used.
+     * @return true if the table holds no entries
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Read the entry at a grid index in any storage mode.
+     * @param index Row-major grid index
+     * @param entry The entry, set even if it is missing
+     * @return true if the entry is present
+     */
+    bool ReadEntry(uint32_t index, IrsEntry& entry) const;
+
+    /**
+     * @brief Decode all entries into dense form.
+     * @return Row-major array of m_numAngles * m_numAngles entries, missing ones with a NaN gain
+     */
+    std::vector<IrsEntry> Decode() const;
+
+    /**
+     * @brief Replace the storage by owned storage of the given mode holding the given entries.
+     * @param entries Row-major array of m_numAngles * m_numAngles entries as returned by Decode()
+     * @param mode The storage mode
+     */
+    void Encode(std::vector<IrsEntry> entries, StorageMode mode);
+
+    /**
+     * @brief Factorize dense entries into the low-rank storage.
+     * @param entries Row-major array of m_numAngles * m_numAngles entries as returned by Decode()
+     */
+    void Factorize(const std::vector<IrsEntry>& entries);
+
+    /**
+     * @brief Keep the dense entries above the sparse threshold in the sparse storage.
+     * @param entries Row-major array of m_numAngles * m_numAngles entries as returned by Decode()
+     */
+    void Sparsify(const std::vector<IrsEntry>& entries);
+
+    /**
+     * @brief Count the stored sparse entries before each word of the present mask.
+     */
+    void IndexSparse();
+
+    /**
+     * @brief Recompute the gain bounds from all entries.
+     */
+    void UpdateBounds();
+
+    /**
+     * @brief Raise the gain bounds to include an entry.
+     * @param index Row-major grid index of the entry
+     * @param gain Gain of the entry in dB
+     */
+    void RaiseBounds(uint32_t index, double gain);
+
+    /**
+     * @brief Get the sector index of a grid index on one axis.
+     * @param index Grid index on the axis
+     * @return Sector index on the axis
+     */
+    uint32_t SectorIndex(uint32_t index) const;
+
+    /**
+     * @brief Drop all storage, owned or external.
+     */
+    void Release();
+
+    /**
+     * @brief Replace the storage by empty storage of the current mode and grid.
+     */
+    void Reset();
+
+    std::vector<IrsEntry> m_irsLookupTable;          //!< Owned DENSE storage, empty if unused
+    const IrsEntry* m_entries;                       //!< Row-major [in * m_numAngles + out]
+    std::vector<IrsQuantizedEntry> m_quantizedTable; //!< Owned storage of QUANTIZED mode
+    const IrsQuantizedEntry* m_quantized;            //!< Row-major like m_entries
+    std::vector<std::complex<float>> m_factorTable;  //!< Owned LOW_RANK factors, in then out
+    const std::complex<float>* m_inFactors;          //!< Row-major [in * m_factorRank + k]
+    const std::complex<float>* m_outFactors;         //!< Row-major [out * m_factorRank + k]
+    std::vector<uint64_t> m_presentTable;            //!< Owned LOW_RANK or SPARSE mask
+    const uint64_t* m_present;                       //!< Bit mask of present or stored entries
+    uint32_t m_factorRank;                           //!< Rank of the LOW_RANK factors
+    uint32_t m_rank;                                 //!< Requested rank, 0 to use m_tolerance
+    double m_tolerance;                              //!< Relative error of the factorization
+    std::vector<IrsEntry> m_sparseTable;             //!< Owned storage of SPARSE mode
+    const IrsEntry* m_sparseEntries;                 //!< Stored SPARSE entries, row-major
+    std::vector<uint32_t> m_sparseOffsets;           //!< Stored entries before each mask word
+    uint32_t m_numSparseEntries;                     //!< Number of stored SPARSE entries
+    double m_sparseThreshold;                        //!< Kept range below the peak gain in dB
+    double m_floorGain;                              //!< Gain of grid points not stored in dB
+    double m_maxGain;                                //!< Largest gain in dB
+    std::vector<double> m_rowMaxGain;                //!< Largest gain per incoming angle
+    std::vector<double> m_sectorMaxGain;             //!< Largest gain per sector, row-major
+    uint32_t m_numSectors;                           //!< Sectors per angle axis
+    std::shared_ptr<const void> m_owner;             //!< Keeps external storage alive
+    StorageMode m_storageMode;                       //!< Which of the storages is used
+    double m_frequency;                              //!< Carrier frequency in Hz, 0 if unknown
+    bool m_readOnly;                                 //!< Whether Insert is allowed
+    double m_resolution;                             //!< Grid step in degrees
+    double m_stepsPerDegree;                         //!< Inverse of m_resolution
+    uint32_t m_numAngles;                            //!< Grid points per angle axis
 };
 
 } // namespace ns3
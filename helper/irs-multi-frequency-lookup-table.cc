@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-multi-frequency-lookup-table.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IrsMultiFrequencyLookupTable");
+
+NS_OBJECT_ENSURE_REGISTERED(IrsMultiFrequencyLookupTable);
+
+TypeId
+IrsMultiFrequencyLookupTable::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::IrsMultiFrequencyLookupTable")
+                            .SetParent<Object>()
+                            .AddConstructor<IrsMultiFrequencyLookupTable>();
+    return tid;
+}
+
+IrsMultiFrequencyLookupTable::IrsMultiFrequencyLookupTable()
+{
+}
+
+IrsMultiFrequencyLookupTable::~IrsMultiFrequencyLookupTable()
+{
+    m_slices.clear();
+}
+
+void
+IrsMultiFrequencyLookupTable::AddSlice(Ptr<IrsLookupTable> table)
+{
+    NS_ABORT_MSG_UNLESS(table, "Lookup table can not be null.");
+    double frequency = table->GetFrequency();
+    NS_ABORT_MSG_UNLESS(frequency > 0, "Frequency of a lookup table slice must be set.");
+    NS_ABORT_MSG_IF(!m_slices.empty() &&
+                        table->GetResolution() != m_slices.front()->GetResolution(),
+                    "All lookup table slices must have the same resolution.");
+    auto it = std::lower_bound(m_frequencies.begin(), m_frequencies.end(), frequency);
+    NS_ABORT_MSG_IF(it != m_frequencies.end() && *it == frequency,
+                    "Lookup table slice for " << frequency << " Hz already added.");
+    m_slices.insert(m_slices.begin() + std::distance(m_frequencies.begin(), it), table);
+    m_frequencies.insert(it, frequency);
+    NS_LOG_DEBUG("Added lookup table slice for " << frequency << " Hz");
+}
+
+IrsEntry
+IrsMultiFrequencyLookupTable::GetSliceEntry(uint32_t i,
+                                            double in_angle,
+                                            double out_angle,
+                                            bool interpolateAngles) const
+{
+    return interpolateAngles ? m_slices[i]->GetInterpolatedIrsEntry(in_angle, out_angle)
+                             : m_slices[i]->GetNearestIrsEntry(in_angle, out_angle);
+}
+
+IrsEntry
+IrsMultiFrequencyLookupTable::GetIrsEntry(double in_angle,
+                                          double out_angle,
+                                          double frequency,
+                                          bool interpolateAngles) const
+{
+    NS_ABORT_MSG_IF(m_slices.empty(), "IrsMultiFrequencyLookupTable has no slices.");
+    auto upper = std::lower_bound(m_frequencies.begin(), m_frequencies.end(), frequency);
+    if (upper == m_frequencies.begin())
+    {
+        return GetSliceEntry(0, in_angle, out_angle, interpolateAngles);
+    }
+    if (upper == m_frequencies.end())
+    {
+        return GetSliceEntry(m_slices.size() - 1, in_angle, out_angle, interpolateAngles);
+    }
+
+    uint32_t i = std::distance(m_frequencies.begin(), upper);
+    if (*upper == frequency)
+    {
+        return GetSliceEntry(i, in_angle, out_angle, interpolateAngles);
+    }
+    double t = (frequency - m_frequencies[i - 1]) / (m_frequencies[i] - m_frequencies[i - 1]);
+    IrsEntry low = GetSliceEntry(i - 1, in_angle, out_angle, interpolateAngles);
+    IrsEntry high = GetSliceEntry(i, in_angle, out_angle, interpolateAngles);
+    return BlendIrsEntries(low, high, t);
+}
+
+uint32_t
+IrsMultiFrequencyLookupTable::GetN() const
+{
+    return m_slices.size();
+}
+
+Ptr<IrsLookupTable>
+IrsMultiFrequencyLookupTable::GetSlice(uint32_t i) const
+{
+    NS_ABORT_MSG_UNLESS(i < m_slices.size(), "Lookup table slice " << i << " does not exist.");
+    return m_slices[i];
+}
+
+} // namespace ns3
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_MULTI_FREQUENCY_LOOKUP_TABLE_H
+#define IRS_MULTI_FREQUENCY_LOOKUP_TABLE_H
+
+#include "irs-lookup-table.h"
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @class IrsMultiFrequencyLookupTable
+ * @brief Lookup table with a frequency axis, built from one \c IrsLookupTable per frequency.
+ *
+ * Each slice is a lookup table generated for a single carrier frequency. A query at a frequency
+ * between two slices linearly interpolates gain (in dB) and phase shift of the two neighbouring
+ * slices, see \c BlendIrsEntries. Queries outside of the covered band use the nearest slice.
+ * This lets a single object serve every channel in use, e.g. Wi-Fi channels of different widths
+ * or an LTE carrier next to a Wi-Fi one.
+ */
+class IrsMultiFrequencyLookupTable : public Object
+{
+  public:
+    /**
+     * @brief Get the TypeId of this class.
+     * @return the TypeId
+     */
+    static TypeId GetTypeId();
+    IrsMultiFrequencyLookupTable();
+    ~IrsMultiFrequencyLookupTable() override;
+
+    /**
+     * @brief Add a frequency slice.
+     * @param table Lookup table of the slice, its \c Frequency attribute must be set
+     *
+     * All slices must share the angular resolution of the first one, and no two slices may
+     * have the same frequency.
+     */
+    void AddSlice(Ptr<IrsLookupTable> table);
+
+    /**
+     * @brief Get the IRS entry at a frequency, interpolated between the neighbouring slices.
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @param frequency Carrier frequency in Hz
+     * @param interpolateAngles Whether to interpolate between the grid points of each slice
+     * (see \c IrsLookupTable::GetInterpolatedIrsEntry) instead of using the nearest one
+     * @return The IRS entry
+     */
+    IrsEntry GetIrsEntry(double in_angle,
+                         double out_angle,
+                         double frequency,
+                         bool interpolateAngles) const;
+
+    /**
+     * @brief Get the number of frequency slices.
+     * @return Number of slices
+     */
+    uint32_t GetN() const;
+
+    /**
+     * @brief Get a frequency slice, ordered by frequency.
+     * @param i Index of the slice
+     * @return The lookup table of the slice
+     */
+    Ptr<IrsLookupTable> GetSlice(uint32_t i) const;
+
+  private:
+    /**
+     * @brief Look up an entry in one slice.
+     * @param i Index of the slice
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @param interpolateAngles Whether to interpolate between grid points
+     * @return The IRS entry of the slice
+     */
+    IrsEntry GetSliceEntry(uint32_t i,
+                           double in_angle,
+                           double out_angle,
+                           bool interpolateAngles) const;
+
+    std::vector<double> m_frequencies;         //!< Frequencies of the slices in Hz, ascending
+    std::vector<Ptr<IrsLookupTable>> m_slices; //!< Lookup tables ordered like m_frequencies
+};
+
+} // namespace ns3
+
+#endif // IRS_MULTI_FREQUENCY_LOOKUP_TABLE_H
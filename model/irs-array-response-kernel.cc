@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-array-response-kernel.h"
+
+#include "ns3/abort.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define IRS_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace ns3
+{
+
+namespace
+{
+/// Number of elements the arrays are padded to a multiple of, the width of AVX-512
+constexpr uint32_t PADDING = 8;
+
+/// 2 / pi, to count the quarter turns of a phase
+constexpr double TWO_OVER_PI = 0.636619772367581343076;
+/// pi / 2 in three parts of 33 bits, so the quarter turns are subtracted without rounding
+constexpr double PIO2_1 = 1.57079632673412561417e+00;
+constexpr double PIO2_2 = 6.07710050630396597660e-11; //!< Second part of pi / 2
+constexpr double PIO2_3 = 2.02226624871116645580e-21; //!< Third part of pi / 2
+
+/// Minimax coefficients of (sin(r) - r) / r^3 in r^2 on [-pi/4, pi/4], highest order first
+constexpr double SIN_COEFFS[] = {1.58962301576546568060e-10,
+                                 -2.50507477628578072866e-8,
+                                 2.75573136213857245213e-6,
+                                 -1.98412698295895385996e-4,
+                                 8.33333333332211858878e-3,
+                                 -1.66666666666666307295e-1};
+/// Minimax coefficients of (cos(r) - 1 + r^2 / 2) / r^4 in r^2 on [-pi/4, pi/4]
+constexpr double COS_COEFFS[] = {-1.13585365213876817300e-11,
+                                 2.08757008419747316778e-9,
+                                 -2.75573141792967388112e-7,
+                                 2.48015872888517045348e-5,
+                                 -1.38888888888730564116e-3,
+                                 4.16666666666665929218e-2};
+
+/**
+ * @brief Calculate the sine and cosine of a phase with the polynomials of the vector kernels.
+ * @param phase The phase in radians
+ * @param sine Set to the sine of the phase
+ * @param cosine Set to the cosine of the phase
+ */
+void
+SinCos(double phase, double& sine, double& cosine)
+{
+    double q = std::nearbyint(phase * TWO_OVER_PI);
+    double r = ((phase - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+    double r2 = r * r;
+    double s = SIN_COEFFS[0];
+    double c = COS_COEFFS[0];
+    for (uint32_t i = 1; i < 6; ++i)
+    {
+        s = s * r2 + SIN_COEFFS[i];
+        c = c * r2 + COS_COEFFS[i];
+    }
+    s = r + r * r2 * s;
+    c = (1 - 0.5 * r2) + r2 * r2 * c;
+
+    // rotate back by the quarter turns
+    switch (static_cast<int64_t>(q) & 3)
+    {
+    case 0:
+        sine = s;
+        cosine = c;
+        break;
+    case 1:
+        sine = c;
+        cosine = -s;
+        break;
+    case 2:
+        sine = -s;
+        cosine = -c;
+        break;
+    default:
+        sine = -c;
+        cosine = s;
+        break;
+    }
+}
+
+/**
+ * @brief Calculate the response of the elements with the scalar loop.
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param z z coordinates
+ * @param real Real parts of the reflection coefficients
+ * @param imag Imaginary parts of the reflection coefficients
+ * @param n Number of elements
+ * @param k Sum of the wave vectors
+ * @return The response
+ */
+std::complex<double>
+EvaluateScalar(const double* x,
+               const double* y,
+               const double* z,
+               const double* real,
+               const double* imag,
+               uint32_t n,
+               const Eigen::Vector3d& k)
+{
+    double sumReal = 0;
+    double sumImag = 0;
+    for (uint32_t e = 0; e < n; ++e)
+    {
+        double sine;
+        double cosine;
+        SinCos(k.x() * x[e] + k.y() * y[e] + k.z() * z[e], sine, cosine);
+        // r exp(-j phase) = (a + j b) (cos - j sin)
+        sumReal += real[e] * cosine + imag[e] * sine;
+        sumImag += imag[e] * cosine - real[e] * sine;
+    }
+    return {sumReal, sumImag};
+}
+
+#ifdef IRS_KERNEL_X86
+/// Mask of all 8 lanes; the zero-masking intrinsics do not read an undefined passthrough
+constexpr __mmask8 ALL_LANES = 0xFF;
+
+/**
+ * @brief Calculate the response of the elements with AVX2 and FMA, 4 elements at a time.
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param z z coordinates
+ * @param real Real parts of the reflection coefficients
+ * @param imag Imaginary parts of the reflection coefficients
+ * @param n Number of elements, a multiple of 4
+ * @param k Sum of the wave vectors
+ * @return The response
+ */
+__attribute__((target("avx2,fma"))) std::complex<double>
+EvaluateAvx2(const double* x,
+             const double* y,
+             const double* z,
+             const double* real,
+             const double* imag,
+             uint32_t n,
+             const Eigen::Vector3d& k)
+{
+    const __m256d kx = _mm256_set1_pd(k.x());
+    const __m256d ky = _mm256_set1_pd(k.y());
+    const __m256d kz = _mm256_set1_pd(k.z());
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    __m256d sumReal = zero;
+    __m256d sumImag = zero;
+    for (uint32_t e = 0; e < n; e += 4)
+    {
+        __m256d phase = _mm256_fmadd_pd(
+            kz,
+            _mm256_loadu_pd(z + e),
+            _mm256_fmadd_pd(ky, _mm256_loadu_pd(y + e), _mm256_mul_pd(kx, _mm256_loadu_pd(x + e))));
+        __m256d q = _mm256_round_pd(_mm256_mul_pd(phase, _mm256_set1_pd(TWO_OVER_PI)),
+                                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d r = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_1), phase);
+        r = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_2), r);
+        r = _mm256_fnmadd_pd(q, _mm256_set1_pd(PIO2_3), r);
+        __m256d r2 = _mm256_mul_pd(r, r);
+        __m256d s = _mm256_set1_pd(SIN_COEFFS[0]);
+        __m256d c = _mm256_set1_pd(COS_COEFFS[0]);
+        for (uint32_t i = 1; i < 6; ++i)
+        {
+            s = _mm256_fmadd_pd(s, r2, _mm256_set1_pd(SIN_COEFFS[i]));
+            c = _mm256_fmadd_pd(c, r2, _mm256_set1_pd(COS_COEFFS[i]));
+        }
+        s = _mm256_fmadd_pd(_mm256_mul_pd(r, r2), s, r);
+        c = _mm256_fmadd_pd(_mm256_mul_pd(r2, r2), c, _mm256_fnmadd_pd(half, r2, one));
+
+        // bits 0 and 1 of the quarter turns, from q / 2 and q / 4 being whole
+        __m256d halfTurns = _mm256_floor_pd(_mm256_mul_pd(q, half));
+        __m256d odd = _mm256_cmp_pd(_mm256_fmsub_pd(q, half, halfTurns), zero, _CMP_NEQ_OQ);
+        __m256d flip = _mm256_cmp_pd(
+            _mm256_sub_pd(_mm256_mul_pd(halfTurns, half),
+                          _mm256_floor_pd(_mm256_mul_pd(halfTurns, half))),
+            zero,
+            _CMP_NEQ_OQ);
+        __m256d sine = _mm256_blendv_pd(s, c, odd);
+        __m256d cosine = _mm256_blendv_pd(c, s, odd);
+        sine = _mm256_xor_pd(sine, _mm256_and_pd(flip, signBit));
+        cosine = _mm256_xor_pd(cosine, _mm256_and_pd(_mm256_xor_pd(odd, flip), signBit));
+
+        __m256d a = _mm256_loadu_pd(real + e);
+        __m256d b = _mm256_loadu_pd(imag + e);
+        sumReal = _mm256_fmadd_pd(a, cosine, _mm256_fmadd_pd(b, sine, sumReal));
+        sumImag = _mm256_fmadd_pd(b, cosine, _mm256_fnmadd_pd(a, sine, sumImag));
+    }
+
+    alignas(32) double realLanes[4];
+    alignas(32) double imagLanes[4];
+    _mm256_store_pd(realLanes, sumReal);
+    _mm256_store_pd(imagLanes, sumImag);
+    return {(realLanes[0] + realLanes[1]) + (realLanes[2] + realLanes[3]),
+            (imagLanes[0] + imagLanes[1]) + (imagLanes[2] + imagLanes[3])};
+}
+
+/**
+ * @brief Calculate the response of the elements with AVX-512F, 8 elements at a time.
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param z z coordinates
+ * @param real Real parts of the reflection coefficients
+ * @param imag Imaginary parts of the reflection coefficients
+ * @param n Number of elements, a multiple of 8
+ * @param k Sum of the wave vectors
+ * @return The response
+ */
+__attribute__((target("avx512f"))) std::complex<double>
+EvaluateAvx512(const double* x,
+               const double* y,
+               const double* z,
+               const double* real,
+               const double* imag,
+               uint32_t n,
+               const Eigen::Vector3d& k)
+{
+    const __m512d kx = _mm512_set1_pd(k.x());
+    const __m512d ky = _mm512_set1_pd(k.y());
+    const __m512d kz = _mm512_set1_pd(k.z());
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d one = _mm512_set1_pd(1);
+    __m512d sumReal = zero;
+    __m512d sumImag = zero;
+    for (uint32_t e = 0; e < n; e += 8)
+    {
+        __m512d phase = _mm512_fmadd_pd(
+            kz,
+            _mm512_loadu_pd(z + e),
+            _mm512_fmadd_pd(ky, _mm512_loadu_pd(y + e), _mm512_mul_pd(kx, _mm512_loadu_pd(x + e))));
+        __m512d q = _mm512_maskz_roundscale_pd(ALL_LANES,
+                                               _mm512_mul_pd(phase, _mm512_set1_pd(TWO_OVER_PI)),
+                                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m512d r = _mm512_fnmadd_pd(q, _mm512_set1_pd(PIO2_1), phase);
+        r = _mm512_fnmadd_pd(q, _mm512_set1_pd(PIO2_2), r);
+        r = _mm512_fnmadd_pd(q, _mm512_set1_pd(PIO2_3), r);
+        __m512d r2 = _mm512_mul_pd(r, r);
+        __m512d s = _mm512_set1_pd(SIN_COEFFS[0]);
+        __m512d c = _mm512_set1_pd(COS_COEFFS[0]);
+        for (uint32_t i = 1; i < 6; ++i)
+        {
+            s = _mm512_fmadd_pd(s, r2, _mm512_set1_pd(SIN_COEFFS[i]));
+            c = _mm512_fmadd_pd(c, r2, _mm512_set1_pd(COS_COEFFS[i]));
+        }
+        s = _mm512_fmadd_pd(_mm512_mul_pd(r, r2), s, r);
+        c = _mm512_fmadd_pd(_mm512_mul_pd(r2, r2), c, _mm512_fnmadd_pd(half, r2, one));
+
+        __m512d halfTurns = _mm512_maskz_roundscale_pd(ALL_LANES,
+                                                       _mm512_mul_pd(q, half),
+                                                       _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        __m512d quarterTurns = _mm512_mul_pd(halfTurns, half);
+        __mmask8 odd = _mm512_cmp_pd_mask(_mm512_fmsub_pd(q, half, halfTurns), zero, _CMP_NEQ_OQ);
+        __mmask8 flip = _mm512_cmp_pd_mask(
+            _mm512_sub_pd(quarterTurns,
+                          _mm512_maskz_roundscale_pd(ALL_LANES,
+                                                     quarterTurns,
+                                                     _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)),
+            zero,
+            _CMP_NEQ_OQ);
+        __m512d sine = _mm512_mask_blend_pd(odd, s, c);
+        __m512d cosine = _mm512_mask_blend_pd(odd, c, s);
+        sine = _mm512_mask_sub_pd(sine, flip, zero, sine);
+        cosine = _mm512_mask_sub_pd(cosine, odd ^ flip, zero, cosine);
+
+        __m512d a = _mm512_loadu_pd(real + e);
+        __m512d b = _mm512_loadu_pd(imag + e);
+        sumReal = _mm512_fmadd_pd(a, cosine, _mm512_fmadd_pd(b, sine, sumReal));
+        sumImag = _mm512_fmadd_pd(b, cosine, _mm512_fnmadd_pd(a, sine, sumImag));
+    }
+
+    alignas(64) double realLanes[8];
+    alignas(64) double imagLanes[8];
+    _mm512_store_pd(realLanes, sumReal);
+    _mm512_store_pd(imagLanes, sumImag);
+    std::complex<double> sum = 0;
+    for (uint32_t lane = 0; lane < 8; ++lane)
+    {
+        sum += std::complex<double>(realLanes[lane], imagLanes[lane]);
+    }
+    return sum;
+}
+#endif
+} // namespace
+
+IrsArrayResponseKernel::IrsArrayResponseKernel()
+    : m_isa(GetBestIsa()),
+      m_size(0)
+{
+}
+
+void
+IrsArrayResponseKernel::SetElements(const Eigen::MatrixX3d& positions,
+                                    const Eigen::VectorXcd& rcoeffs)
+{
+    m_size = positions.rows() == rcoeffs.size() ? positions.rows() : 0;
+    // padded elements sit in the origin and reflect nothing
+    uint32_t padded = (m_size + PADDING - 1) / PADDING * PADDING;
+    m_x.assign(padded, 0);
+    m_y.assign(padded, 0);
+    m_z.assign(padded, 0);
+    m_real.assign(padded, 0);
+    m_imag.assign(padded, 0);
+    for (uint32_t e = 0; e < m_size; ++e)
+    {
+        m_x[e] = positions(e, 0);
+        m_y[e] = positions(e, 1);
+        m_z[e] = positions(e, 2);
+        m_real[e] = rcoeffs[e].real();
+        m_imag[e] = rcoeffs[e].imag();
+    }
+}
+
+uint32_t
+IrsArrayResponseKernel::GetSize() const
+{
+    return m_size;
+}
+
+std::complex<double>
+IrsArrayResponseKernel::Evaluate(const Eigen::Vector3d& k) const
+{
+#ifdef IRS_KERNEL_X86
+    uint32_t padded = m_x.size();
+    switch (m_isa)
+    {
+    case AVX512:
+        return EvaluateAvx512(m_x.data(), m_y.data(), m_z.data(), m_real.data(), m_imag.data(),
+                              padded, k);
+    case AVX2:
+        return EvaluateAvx2(m_x.data(), m_y.data(), m_z.data(), m_real.data(), m_imag.data(),
+                            padded, k);
+    default:
+        break;
+    }
+#endif
+    return EvaluateScalar(m_x.data(), m_y.data(), m_z.data(), m_real.data(), m_imag.data(), m_size,
+                          k);
+}
+
+void
+IrsArrayResponseKernel::SetIsa(Isa isa)
+{
+    NS_ABORT_MSG_UNLESS(IsSupported(isa), GetIsaName(isa) << " is not supported by this CPU.");
+    m_isa = isa;
+}
+
+IrsArrayResponseKernel::Isa
+IrsArrayResponseKernel::GetIsa() const
+{
+    return m_isa;
+}
+
+bool
+IrsArrayResponseKernel::IsSupported(Isa isa)
+{
+    switch (isa)
+    {
+    case SCALAR:
+        return true;
+#ifdef IRS_KERNEL_X86
+    case AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+IrsArrayResponseKernel::Isa
+IrsArrayResponseKernel::GetBestIsa()
+{
+    static const Isa best = IsSupported(AVX512) ? AVX512 : IsSupported(AVX2) ? AVX2 : SCALAR;
+    return best;
+}
+
+std::string
+IrsArrayResponseKernel::GetIsaName(Isa isa)
+{
+    switch (isa)
+    {
+    case AVX2:
+        return "AVX2";
+    case AVX512:
+        return "AVX-512";
+    default:
+        return "scalar";
+    }
+}
+
+} // namespace ns3
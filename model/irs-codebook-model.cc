@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-codebook-model.h"
+
+#include "irs-lookup-model.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("IrsCodebookModel");
+NS_OBJECT_ENSURE_REGISTERED(IrsCodebookModel);
+
+TypeId
+IrsCodebookModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::IrsCodebookModel")
+            .SetParent<IrsModel>()
+            .SetGroupName("IrsModel")
+            .AddConstructor<IrsCodebookModel>()
+            .AddTraceSource("Switch",
+                            "Fired when the active configuration changes.",
+                            MakeTraceSourceAccessor(&IrsCodebookModel::m_switchTrace),
+                            "ns3::IrsCodebookModel::SwitchTracedCallback");
+    return tid;
+}
+
+IrsCodebookModel::IrsCodebookModel()
+    : m_active(nullptr),
+      m_activeIndex(0)
+{
+}
+
+IrsCodebookModel::~IrsCodebookModel()
+{
+    m_active = nullptr;
+    m_configurations.clear();
+}
+
+uint32_t
+IrsCodebookModel::AddConfiguration(Ptr<IrsModel> model)
+{
+    NS_ABORT_MSG_UNLESS(model, "Configuration of an IrsCodebookModel can not be null.");
+    NS_ABORT_MSG_IF(dynamic_cast<IrsCodebookModel*>(PeekPointer(model)),
+                    "Configuration of an IrsCodebookModel can not be a codebook itself.");
+    if (auto lookupModel = dynamic_cast<IrsLookupModel*>(PeekPointer(model)))
+    {
+        // configurations are not aggregated to the node, an atlas is placed by the codebook
+        lookupModel->SetAtlasPlacement(this);
+    }
+    m_configurations.push_back(model);
+    if (!m_active)
+    {
+        m_active = PeekPointer(model);
+        m_activeIndex = 0;
+    }
+    NS_LOG_DEBUG("Added configuration " << m_configurations.size() - 1);
+    return m_configurations.size() - 1;
+}
+
+uint32_t
+IrsCodebookModel::GetN() const
+{
+    return m_configurations.size();
+}
+
+Ptr<IrsModel>
+IrsCodebookModel::GetConfiguration(uint32_t index) const
+{
+    NS_ABORT_MSG_UNLESS(index < m_configurations.size(),
+                        "Configuration " << index << " does not exist.");
+    return m_configurations[index];
+}
+
+void
+IrsCodebookModel::SetActiveConfiguration(uint32_t index)
+{
+    NS_ABORT_MSG_UNLESS(index < m_configurations.size(),
+                        "Configuration " << index << " does not exist.");
+    uint32_t oldIndex = m_activeIndex;
+    m_active = PeekPointer(m_configurations[index]);
+    m_activeIndex = index;
+    NS_LOG_DEBUG("Switched from configuration " << oldIndex << " to " << index);
+    m_switchTrace(oldIndex, index);
+}
+
+uint32_t
+IrsCodebookModel::GetActiveConfiguration() const
+{
+    CheckNotEmpty();
+    return m_activeIndex;
+}
+
+Ptr<IrsModel>
+IrsCodebookModel::GetActiveModel() const
+{
+    CheckNotEmpty();
+    return m_configurations[m_activeIndex];
+}
+
+EventId
+IrsCodebookModel::ScheduleSwitch(Time delay, uint32_t index)
+{
+    NS_ABORT_MSG_UNLESS(index < m_configurations.size(),
+                        "Configuration " << index << " does not exist.");
+    return Simulator::Schedule(delay, &IrsCodebookModel::SetActiveConfiguration, this, index);
+}
+
+IrsEntry
+IrsCodebookModel::GetIrsEntry(uint8_t in_angle, uint8_t out_angle) const
+{
+    CheckNotEmpty();
+    return m_active->GetIrsEntry(in_angle, out_angle);
+}
+
+IrsEntry
+IrsCodebookModel::GetIrsEntry(Angles in, Angles out, double lambda) const
+{
+    CheckNotEmpty();
+    return m_active->GetIrsEntry(in, out, lambda);
+}
+
+double
+IrsCodebookModel::GetMaxGain() const
+{
+    CheckNotEmpty();
+    return m_active->GetMaxGain();
+}
+
+double
+IrsCodebookModel::GetMaxGain(double in_angle, double out_angle) const
+{
+    CheckNotEmpty();
+    return m_active->GetMaxGain(in_angle, out_angle);
+}
+
+void
+IrsCodebookModel::CheckNotEmpty() const
+{
+    NS_ABORT_MSG_UNLESS(m_active, "IrsCodebookModel has no configurations.");
+}
+
+} // namespace ns3
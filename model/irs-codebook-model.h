@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_CODEBOOK_MODEL_H
+#define IRS_CODEBOOK_MODEL_H
+
+#include "irs-model.h"
+
+#include "ns3/angles.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include "ns3/type-id.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @class IrsCodebookModel
+ * @brief IRS with a codebook of precomputed configurations, one of which is active at a time.
+ *
+ * Each configuration is a complete \c IrsModel, e.g. an \c IrsLookupModel with its own lookup
+ * table or an \c IrsSpectrumModel with its own reflection coefficients and cache. All lookups
+ * are forwarded to the active configuration, so switching between configurations only changes
+ * an index: nothing is reloaded or recomputed, and the read path takes no locks.
+ *
+ * Switches can be scheduled with \c ScheduleSwitch, e.g. to steer the IRS towards a different
+ * station for every TXOP. The \c Direction of the codebook applies to all configurations, the
+ * directions of the configurations themselves are not used. \c IrsLookupModel configurations
+ * with an atlas select their slices by the node and direction of the codebook.
+ */
+class IrsCodebookModel : public IrsModel
+{
+  public:
+    /**
+     * @brief Get the TypeId of this class.
+     * @return The object TypeId
+     */
+    static TypeId GetTypeId();
+    IrsCodebookModel();
+    ~IrsCodebookModel() override;
+
+    /**
+     * @brief Add a configuration to the codebook.
+     * @param model The IRS model of the configuration, can not be a codebook itself
+     * @return Index of the configuration
+     *
+     * The first configuration added becomes the active one.
+     */
+    uint32_t AddConfiguration(Ptr<IrsModel> model);
+
+    /**
+     * @brief Get the number of configurations.
+     * @return Number of configurations in the codebook
+     */
+    uint32_t GetN() const;
+
+    /**
+     * @brief Get a configuration.
+     * @param index Index of the configuration
+     * @return The IRS model of the configuration
+     */
+    Ptr<IrsModel> GetConfiguration(uint32_t index) const;
+
+    /**
+     * @brief Switch to another configuration.
+     * @param index Index of the configuration
+     */
+    void SetActiveConfiguration(uint32_t index);
+
+    /**
+     * @brief Get the index of the active configuration.
+     * @return Index of the active configuration
+     */
+    uint32_t GetActiveConfiguration() const;
+
+    /**
+     * @brief Get the IRS model of the active configuration.
+     * @return The active IRS model
+     */
+    Ptr<IrsModel> GetActiveModel() const;
+
+    /**
+     * @brief Schedule a switch to another configuration.
+     * @param delay Time from now until the switch
+     * @param index Index of the configuration
+     * @return The event of the switch, e.g. to cancel it
+     */
+    EventId ScheduleSwitch(Time delay, uint32_t index);
+
+    /**
+     * @brief Get an IRS entry of the active configuration.
+     * @param in_angle Input angle in degrees.
+     * @param out_angle Output angle in degrees.
+     * @return The corresponding \c IrsEntry of the active configuration.
+     */
+    IrsEntry GetIrsEntry(uint8_t in_angle, uint8_t out_angle) const override;
+
+    /**
+     * @brief Get an IRS entry of the active configuration.
+     * @param in Input angles (azimuth and inclination in radians).
+     * @param out Output angles (azimuth and inclination in radians).
+     * @param lambda Wavelength of the signal in meters.
+     * @return The corresponding \c IrsEntry of the active configuration.
+     */
+    IrsEntry GetIrsEntry(Angles in, Angles out, double lambda) const override;
+
+    /**
+     * @brief Get an upper bound of the gain of the active configuration.
+     * @return Largest gain in dB, +infinity if the active configuration does not know a bound.
+     */
+    double GetMaxGain() const override;
+
+    /**
+     * @brief Get an upper bound of the gain of the active configuration around a pair of angles.
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @return Largest gain in dB near the angles, +infinity if the active configuration does not
+     * know a bound.
+     */
+    double GetMaxGain(double in_angle, double out_angle) const override;
+
+    /**
+     * TracedCallback signature for configuration switches.
+     * @param [in] oldIndex Index of the previously active configuration
+     * @param [in] newIndex Index of the now active configuration
+     */
+    typedef void (*SwitchTracedCallback)(uint32_t oldIndex, uint32_t newIndex);
+
+  private:
+    /**
+     * @brief Abort unless the codebook has at least one configuration.
+     */
+    void CheckNotEmpty() const;
+
+    std::vector<Ptr<IrsModel>> m_configurations; //!< Configurations of the codebook
+    IrsModel* m_active;                          //!< Active configuration, owned by the codebook
+    uint32_t m_activeIndex;                      //!< Index of the active configuration
+
+    /// Trace fired on every switch, with the old and new configuration index
+    TracedCallback<uint32_t, uint32_t> m_switchTrace;
+};
+
+} // namespace ns3
+
+#endif // IRS_CODEBOOK_MODEL_H
@@ -11,10 +11,16 @@
 
 #include "irs-model.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/fatal-error.h"
+#include "ns3/mobility-model.h"
 #include "ns3/object-base.h"
 #include "ns3/pointer.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 namespace ns3
 {
@@ -34,25 +40,131 @@ IrsLookupModel::GetTypeId()
                                           PointerValue(),
                                           MakePointerAccessor(&IrsLookupModel::SetLookupTable,
                                                               &IrsLookupModel::GetLookupTable),
-                                          MakePointerChecker<IrsLookupTable>());
+                                          MakePointerChecker<IrsLookupTable>())
+                            .AddAttribute("LookupTable4D",
+                                          "The lookup table for the IRS, indexed by azimuth and "
+                                          "inclination of both directions.",
+                                          TypeId::ATTR_SET | TypeId::ATTR_GET,
+                                          PointerValue(),
+                                          MakePointerAccessor(&IrsLookupModel::SetLookupTable4D,
+                                                              &IrsLookupModel::GetLookupTable4D),
+                                          MakePointerChecker<IrsLookupTable4D>())
+                            .AddAttribute(
+                                "MultiFrequencyLookupTable",
+                                "The lookup table for the IRS with a frequency axis.",
+                                TypeId::ATTR_SET | TypeId::ATTR_GET,
+                                PointerValue(),
+                                MakePointerAccessor(&IrsLookupModel::SetMultiFrequencyLookupTable,
+                                                    &IrsLookupModel::GetMultiFrequencyLookupTable),
+                                MakePointerChecker<IrsMultiFrequencyLookupTable>())
+                            .AddAttribute("Atlas",
+                                          "The lookup tables for the IRS, indexed by the "
+                                          "position of the IRS.",
+                                          TypeId::ATTR_SET | TypeId::ATTR_GET,
+                                          PointerValue(),
+                                          MakePointerAccessor(&IrsLookupModel::SetAtlas,
+                                                              &IrsLookupModel::GetAtlas),
+                                          MakePointerChecker<IrsLookupTableAtlas>())
+                            .AddAttribute("Frequency",
+                                          "Frequency in Hz of the lookups without a wavelength, "
+                                          "selects the slices of a multi-frequency table.",
+                                          DoubleValue(5.21e9),
+                                          MakeDoubleAccessor(&IrsLookupModel::SetFrequency,
+                                                             &IrsLookupModel::GetFrequency),
+                                          MakeDoubleChecker<double>())
+                            .AddAttribute("Interpolate",
+                                          "Bilinearly interpolate between the grid points of "
+                                          "the lookup table instead of using the nearest one.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&IrsLookupModel::SetInterpolate,
+                                                              &IrsLookupModel::GetInterpolate),
+                                          MakeBooleanChecker());
     return tid;
 }
 
 IrsLookupModel::IrsLookupModel()
+    : m_interpolate(false),
+      m_frequency(5.21e9),
+      m_atlasPlacement(this),
+      m_atlasSelection{0, 0, 0},
+      m_atlasSelected(false)
 {
 }
 
 IrsEntry
 IrsLookupModel::GetIrsEntry(uint8_t in_angle, uint8_t out_angle) const
 {
-    return m_irsLookupTable->GetIrsEntry(in_angle, out_angle);
+    // the double lookups clamp to the table, whole degrees outside of it are missing entries
+    if (in_angle > 180 || out_angle > 180)
+    {
+        NS_FATAL_ERROR("Entry in IrsLookupTable with in_angle: " << +in_angle << " and out_angle: "
+                                                                 << +out_angle << " not Found.");
+    }
+    return LookupIrsEntry(in_angle, out_angle);
 }
 
 IrsEntry
 IrsLookupModel::GetIrsEntry(Angles in, Angles out, double lambda) const
 {
-    // this function should generally not be called
-    return GetIrsEntry(RadiansToDegrees(in.GetAzimuth()), RadiansToDegrees(out.GetAzimuth()));
+    static const double c = 299792458.0; // speed of light in vacuum
+    return DoLookupIrsEntry(in,
+                            out,
+                            RadiansToDegrees(in.GetAzimuth()),
+                            RadiansToDegrees(out.GetAzimuth()),
+                            c / lambda);
+}
+
+IrsEntry
+IrsLookupModel::LookupIrsEntry(double in_angle, double out_angle) const
+{
+    // same mapping as IrsSpectrumModel
+    return DoLookupIrsEntry(Angles(DegreesToRadians(in_angle), 0),
+                            Angles(DegreesToRadians(out_angle), 0),
+                            in_angle,
+                            out_angle,
+                            m_frequency);
+}
+
+IrsEntry
+IrsLookupModel::LookupIrsEntry(double in_angle, double out_angle, double lambda) const
+{
+    static const double c = 299792458.0; // speed of light in vacuum
+    return DoLookupIrsEntry(Angles(DegreesToRadians(in_angle), 0),
+                            Angles(DegreesToRadians(out_angle), 0),
+                            in_angle,
+                            out_angle,
+                            c / lambda);
+}
+
+IrsEntry
+IrsLookupModel::DoLookupIrsEntry(Angles in,
+                                 Angles out,
+                                 double in_angle,
+                                 double out_angle,
+                                 double frequency) const
+{
+    if (m_irsLookupTable4D)
+    {
+        return m_interpolate ? m_irsLookupTable4D->GetInterpolatedIrsEntry(in, out)
+                             : m_irsLookupTable4D->GetIrsEntry(in, out);
+    }
+    if (m_irsMultiFrequencyLookupTable)
+    {
+        return m_irsMultiFrequencyLookupTable->GetIrsEntry(in_angle,
+                                                           out_angle,
+                                                           frequency,
+                                                           m_interpolate);
+    }
+    if (m_atlas)
+    {
+        return m_atlas->GetIrsEntry(GetAtlasSelection(), in_angle, out_angle, m_interpolate);
+    }
+    NS_ABORT_MSG_UNLESS(m_irsLookupTable, "IrsLookupModel has no lookup table.");
+    if (m_interpolate)
+    {
+        return m_irsLookupTable->GetInterpolatedIrsEntry(in_angle, out_angle);
+    }
+    return m_irsLookupTable->GetNearestIrsEntry(in_angle, out_angle);
 }
 
 void
@@ -68,4 +180,154 @@ IrsLookupModel::GetLookupTable() const
     return m_irsLookupTable;
 }
 
+void
+IrsLookupModel::SetMultiFrequencyLookupTable(const Ptr<IrsMultiFrequencyLookupTable> table)
+{
+    NS_ABORT_MSG_UNLESS(table, "Lookup table can not be null.");
+    m_irsMultiFrequencyLookupTable = table;
+}
+
+Ptr<IrsMultiFrequencyLookupTable>
+IrsLookupModel::GetMultiFrequencyLookupTable() const
+{
+    return m_irsMultiFrequencyLookupTable;
+}
+
+void
+IrsLookupModel::SetLookupTable4D(const Ptr<IrsLookupTable4D> table)
+{
+    NS_ABORT_MSG_UNLESS(table, "Lookup table can not be null.");
+    m_irsLookupTable4D = table;
+}
+
+Ptr<IrsLookupTable4D>
+IrsLookupModel::GetLookupTable4D() const
+{
+    return m_irsLookupTable4D;
+}
+
+void
+IrsLookupModel::SetAtlas(const Ptr<IrsLookupTableAtlas> atlas)
+{
+    NS_ABORT_MSG_UNLESS(atlas, "Lookup table atlas can not be null.");
+    m_atlas = atlas;
+    m_atlasSelected = false;
+}
+
+Ptr<IrsLookupTableAtlas>
+IrsLookupModel::GetAtlas() const
+{
+    return m_atlas;
+}
+
+void
+IrsLookupModel::SetAtlasPlacement(const IrsModel* placement)
+{
+    m_atlasPlacement = placement ? placement : this;
+    m_atlasMobility = nullptr;
+    m_atlasSelected = false;
+}
+
+const IrsLookupTableAtlas::Selection&
+IrsLookupModel::GetAtlasSelection() const
+{
+    if (!m_atlasMobility)
+    {
+        m_atlasMobility = m_atlasPlacement->GetObject<MobilityModel>();
+        NS_ABORT_MSG_UNLESS(m_atlasMobility,
+                            "IrsLookupModel with an atlas needs a MobilityModel aggregated to "
+                            "it or to the IrsCodebookModel it is a configuration of.");
+    }
+    Vector position = m_atlasMobility->GetPosition();
+    Vector direction = m_atlasPlacement->GetDirection();
+    if (!m_atlasSelected || position != m_atlasPosition || direction != m_atlasDirection)
+    {
+        m_atlasSelection = m_atlas->Select(position, direction);
+        m_atlasPosition = position;
+        m_atlasDirection = direction;
+        m_atlasSelected = true;
+    }
+    return m_atlasSelection;
+}
+
+bool
+IrsLookupModel::HasLookupTable4D() const
+{
+    return static_cast<bool>(m_irsLookupTable4D);
+}
+
+void
+IrsLookupModel::SetInterpolate(bool interpolate)
+{
+    m_interpolate = interpolate;
+}
+
+bool
+IrsLookupModel::GetInterpolate() const
+{
+    return m_interpolate;
+}
+
+void
+IrsLookupModel::SetFrequency(double frequency)
+{
+    NS_ABORT_MSG_UNLESS(frequency > 0, "Frequency should be greater zero (in Hz).");
+    m_frequency = frequency;
+}
+
+double
+IrsLookupModel::GetFrequency() const
+{
+    return m_frequency;
+}
+
+double
+IrsLookupModel::GetMaxGain() const
+{
+    if (m_irsLookupTable4D || (!m_irsLookupTable && !m_irsMultiFrequencyLookupTable && !m_atlas))
+    {
+        return IrsModel::GetMaxGain();
+    }
+    if (m_irsMultiFrequencyLookupTable)
+    {
+        // interpolating between slices never exceeds the larger one
+        double bound = -std::numeric_limits<double>::infinity();
+        for (uint32_t i = 0; i < m_irsMultiFrequencyLookupTable->GetN(); ++i)
+        {
+            bound = std::max(bound, m_irsMultiFrequencyLookupTable->GetSlice(i)->GetMaxGain());
+        }
+        return bound;
+    }
+    if (m_atlas)
+    {
+        return m_atlas->GetMaxGain(GetAtlasSelection());
+    }
+    return m_irsLookupTable->GetMaxGain();
+}
+
+double
+IrsLookupModel::GetMaxGain(double in_angle, double out_angle) const
+{
+    if (m_irsLookupTable4D || (!m_irsLookupTable && !m_irsMultiFrequencyLookupTable && !m_atlas))
+    {
+        return IrsModel::GetMaxGain();
+    }
+    if (m_irsMultiFrequencyLookupTable)
+    {
+        double bound = -std::numeric_limits<double>::infinity();
+        for (uint32_t i = 0; i < m_irsMultiFrequencyLookupTable->GetN(); ++i)
+        {
+            bound = std::max(
+                bound,
+                m_irsMultiFrequencyLookupTable->GetSlice(i)->GetMaxGain(in_angle, out_angle));
+        }
+        return bound;
+    }
+    if (m_atlas)
+    {
+        return m_atlas->GetMaxGain(GetAtlasSelection(), in_angle, out_angle);
+    }
+    return m_irsLookupTable->GetMaxGain(in_angle, out_angle);
+}
+
 } // namespace ns3
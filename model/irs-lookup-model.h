@@ -13,7 +13,11 @@
 #include "irs-model.h"
 
 #include "ns3/angles.h"
+#include "ns3/irs-lookup-table-4d.h"
+#include "ns3/irs-lookup-table-atlas.h"
 #include "ns3/irs-lookup-table.h"
+#include "ns3/irs-multi-frequency-lookup-table.h"
+#include "ns3/mobility-model.h"
 #include "ns3/ptr.h"
 #include "ns3/type-id.h"
 
@@ -33,7 +37,25 @@ namespace ns3
  *
  * The \c IrsLookupModel class is a concrete implementation of the \c IrsModel interface.
  * It uses a precomputed lookup table to provide reflection coefficients or other IRS parameters
- * for specific input and output angles.
+ * for specific input and output angles. Angles between the grid points of the table are either
+ * rounded to the nearest grid point or, with the \c Interpolate attribute, bilinearly
+ * interpolated.
+ *
+ * With an \c IrsMultiFrequencyLookupTable, the wavelength passed to the model selects and
+ * interpolates the frequency slices, lookups without a wavelength use the \c Frequency attribute;
+ * otherwise the lookup does not depend on the wavelength.
+ *
+ * With an \c IrsLookupTable4D, the model also takes the inclination of both directions into
+ * account and is queried with the 3D angles of \c IrsPropagationLossModel::CalcAngles3D. With
+ * \c Interpolate, the 16 grid points around both directions are interpolated.
+ *
+ * With an \c IrsLookupTableAtlas, the table is chosen by the position of the \c MobilityModel
+ * aggregated to the node and the direction of the IRS. The chosen slices are kept until the IRS
+ * moves or turns, so lookups of a static IRS cost the same as with a single table. A model used
+ * as a configuration of an \c IrsCodebookModel takes the node and direction of the codebook.
+ *
+ * If more than one table is set, every lookup uses the 4D table, then the multi-frequency table,
+ * then the atlas and then the 2D table, whichever comes first.
  */
 class IrsLookupModel : public IrsModel
 {
@@ -51,17 +73,39 @@ class IrsLookupModel : public IrsModel
      * @param out_angle Output angle in degrees.
      * @return The corresponding \c IrsEntry from the lookup table.
      *
-     * This method retrieves a precomputed IRS entry for the given input and output angles.
+     * This method retrieves a precomputed IRS entry for the given input and output angles, at the
+     * \c Frequency of the model. Angles above 180 degrees are reported as missing entries (fatal
+     * error), they are not clamped to the table like the angles of the double lookups.
      */
     IrsEntry GetIrsEntry(uint8_t in_angle, uint8_t out_angle) const override;
 
     /**
      * @brief Get an IRS entry for the specified input and output angles.
      *
-     * Is not frequency dependent - just looks up \c IrsEntry using the azimuth angles
+     * Looks up \c IrsEntry in the 4D table if set, otherwise using the azimuth angles only. Only
+     * frequency dependent with a multi-frequency table and no 4D table.
      */
     IrsEntry GetIrsEntry(Angles in, Angles out, double lambda) const override;
 
+    /**
+     * @brief Get an IRS entry for fractional input and output angles.
+     * @param in_angle Input angle in degrees.
+     * @param out_angle Output angle in degrees.
+     * @return The entry of the nearest grid point, or the interpolated entry if \c Interpolate
+     * is set, at the \c Frequency of the model.
+     */
+    IrsEntry LookupIrsEntry(double in_angle, double out_angle) const;
+
+    /**
+     * @brief Get an IRS entry for fractional input and output angles at a wavelength.
+     * @param in_angle Input angle in degrees.
+     * @param out_angle Output angle in degrees.
+     * @param lambda Wavelength of the signal in meters.
+     * @return The entry interpolated between the frequency slices of the multi-frequency table
+     * if set, otherwise independent of the wavelength.
+     */
+    IrsEntry LookupIrsEntry(double in_angle, double out_angle, double lambda) const;
+
     /**
      * @brief Set the lookup table.
      * @param table A pointer to the \c IrsLookupTable.
@@ -74,8 +118,135 @@ class IrsLookupModel : public IrsModel
      */
     Ptr<IrsLookupTable> GetLookupTable() const;
 
+    /**
+     * @brief Set the lookup table with a frequency axis.
+     * @param table A pointer to the \c IrsMultiFrequencyLookupTable.
+     */
+    void SetMultiFrequencyLookupTable(Ptr<IrsMultiFrequencyLookupTable> table);
+
+    /**
+     * @brief Get the lookup table with a frequency axis.
+     * @return A pointer to the current \c IrsMultiFrequencyLookupTable, null if not set.
+     */
+    Ptr<IrsMultiFrequencyLookupTable> GetMultiFrequencyLookupTable() const;
+
+    /**
+     * @brief Set the 4D lookup table, indexed by azimuth and inclination of both directions.
+     * @param table A pointer to the \c IrsLookupTable4D.
+     */
+    void SetLookupTable4D(Ptr<IrsLookupTable4D> table);
+
+    /**
+     * @brief Get the 4D lookup table associated with this model.
+     * @return A pointer to the current \c IrsLookupTable4D, null if not set.
+     */
+    Ptr<IrsLookupTable4D> GetLookupTable4D() const;
+
+    /**
+     * @brief Check whether the model uses a 4D lookup table.
+     * @return true if a 4D lookup table is set.
+     */
+    bool HasLookupTable4D() const;
+
+    /**
+     * @brief Set the atlas of lookup tables indexed by IRS position.
+     * @param atlas A pointer to the \c IrsLookupTableAtlas.
+     *
+     * Takes precedence over a lookup table set with \c SetLookupTable.
+     */
+    void SetAtlas(Ptr<IrsLookupTableAtlas> atlas);
+
+    /**
+     * @brief Get the atlas of lookup tables indexed by IRS position.
+     * @return A pointer to the current \c IrsLookupTableAtlas, null if not set.
+     */
+    Ptr<IrsLookupTableAtlas> GetAtlas() const;
+
+    /**
+     * @brief Set the IRS model whose node and direction place the lookups in the atlas.
+     * @param placement The placing model, e.g. the \c IrsCodebookModel holding this model as a
+     * configuration; this model itself if null
+     *
+     * The placing model is not owned and must outlive this model. Its \c MobilityModel is looked
+     * up on the first atlas lookup and kept afterwards.
+     */
+    void SetAtlasPlacement(const IrsModel* placement);
+
+    /**
+     * @brief Set whether lookups interpolate between the grid points of the table.
+     * @param interpolate true to interpolate, false for the nearest grid point
+     */
+    void SetInterpolate(bool interpolate);
+
+    /**
+     * @brief Get whether lookups interpolate between the grid points of the table.
+     * @return true if lookups interpolate
+     */
+    bool GetInterpolate() const;
+
+    /**
+     * @brief Set the frequency of the lookups without a wavelength.
+     * @param frequency Frequency in Hz
+     */
+    void SetFrequency(double frequency);
+
+    /**
+     * @brief Get the frequency of the lookups without a wavelength.
+     * @return Frequency in Hz
+     */
+    double GetFrequency() const;
+
+    /**
+     * @brief Get an upper bound of the gain over all angles.
+     * @return Largest gain in dB of the table lookups read: all slices of the multi-frequency
+     * table, the atlas slices of the current position or the 2D table, +infinity with a 4D table.
+     */
+    double GetMaxGain() const override;
+
+    /**
+     * @brief Get an upper bound of the gain around a pair of angles.
+     * @param in_angle Input angle in degrees
+     * @param out_angle Output angle in degrees
+     * @return Largest gain in dB of the table sectors a lookup at the angles reads, over the same
+     * tables as \c GetMaxGain(), +infinity with a 4D table.
+     */
+    double GetMaxGain(double in_angle, double out_angle) const override;
+
   private:
+    /**
+     * @brief Look up an entry in the first table set of 4D, multi-frequency, atlas and 2D.
+     * @param in Incoming direction, used by the 4D table
+     * @param out Outgoing direction, used by the 4D table
+     * @param in_angle Incoming azimuth in degrees, used by the other tables
+     * @param out_angle Outgoing azimuth in degrees, used by the other tables
+     * @param frequency Frequency in Hz, used by the multi-frequency table
+     * @return The entry, interpolated if \c Interpolate is set
+     */
+    IrsEntry DoLookupIrsEntry(Angles in,
+                              Angles out,
+                              double in_angle,
+                              double out_angle,
+                              double frequency) const;
+
+    /**
+     * @brief Get the atlas slices for the current position and direction of the IRS.
+     * @return The slices, selected again only if the IRS moved or turned
+     */
+    const IrsLookupTableAtlas::Selection& GetAtlasSelection() const;
+
     Ptr<IrsLookupTable> m_irsLookupTable;
+    Ptr<IrsLookupTable4D> m_irsLookupTable4D; //!< Elevation-aware table, may be null
+    Ptr<IrsMultiFrequencyLookupTable> m_irsMultiFrequencyLookupTable; //!< May be null
+    bool m_interpolate; //!< Whether to interpolate between the grid points of the table
+    double m_frequency; //!< Frequency in Hz of the lookups without a wavelength
+
+    Ptr<IrsLookupTableAtlas> m_atlas;                        //!< Tables by position, may be null
+    const IrsModel* m_atlasPlacement;                        //!< Model placing the atlas lookups
+    mutable Ptr<MobilityModel> m_atlasMobility;              //!< Mobility of m_atlasPlacement
+    mutable IrsLookupTableAtlas::Selection m_atlasSelection; //!< Slices of the last position
+    mutable Vector m_atlasPosition;                          //!< Position of the last selection
+    mutable Vector m_atlasDirection;                         //!< Direction of the last selection
+    mutable bool m_atlasSelected;                            //!< Whether m_atlasSelection is valid
 };
 } // namespace ns3
 
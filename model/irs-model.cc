@@ -13,6 +13,8 @@
 #include "ns3/log.h"
 #include "ns3/object-base.h"
 
+#include <limits>
+
 namespace ns3
 {
 
@@ -56,4 +58,16 @@ IrsModel::GetDirection() const
 {
     return m_direction;
 }
+
+double
+IrsModel::GetMaxGain() const
+{
+    return std::numeric_limits<double>::infinity();
+}
+
+double
+IrsModel::GetMaxGain(double in_angle, double out_angle) const
+{
+    return GetMaxGain();
+}
 } // namespace ns3
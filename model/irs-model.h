@@ -66,6 +66,22 @@ class IrsModel : public Object
      */
     virtual IrsEntry GetIrsEntry(Angles in, Angles out, double lambda) const = 0;
 
+    /**
+     * @brief Get an upper bound of the gain over all angles.
+     * @return Largest gain in dB, +infinity if the model does not know a bound.
+     *
+     * Used by \c IrsPropagationLossModel to drop paths before evaluating them.
+     */
+    virtual double GetMaxGain() const;
+
+    /**
+     * @brief Get an upper bound of the gain around a pair of 2D angles.
+     * @param in_angle Input angle in degrees, as returned by \c IrsPropagationLossModel::CalcAngles
+     * @param out_angle Output angle in degrees
+     * @return Largest gain in dB of the lookups near the angles, \c GetMaxGain() by default.
+     */
+    virtual double GetMaxGain(double in_angle, double out_angle) const;
+
     /**
      * @brief Set the direction of the IRS.
      * @param direction A \c Vector specifying the direction of the IRS in 3D space.
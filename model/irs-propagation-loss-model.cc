@@ -9,6 +9,7 @@
 
 #include "irs-propagation-loss-model.h"
 
+#include "irs-codebook-model.h"
 #include "irs-lookup-model.h"
 #include "irs-model.h"
 #include "irs-spectrum-model.h"
@@ -77,6 +78,14 @@ IrsPropagationLossModel::GetTypeId()
                     &IrsPropagationLossModel::GetErrorModel),
                 MakeTupleChecker<DoubleValue, DoubleValue>(MakeDoubleChecker<double>(),
                                                            MakeDoubleChecker<double>()))
+            .AddAttribute(
+                "PruningThreshold",
+                "IRS paths whose received power (in dBm) stays below this threshold even with the "
+                "largest gain of every IRS on the path are not evaluated. The random error of the "
+                "ErrorModel is not part of the bound.",
+                DoubleValue(-std::numeric_limits<double>::infinity()),
+                MakeDoubleAccessor(&IrsPropagationLossModel::m_pruningThreshold),
+                MakeDoubleChecker<double>())
             .AddAttribute(
                 "Frequency",
                 "The carrier frequency (in Hz) at which propagation occurs (default is 5.21 GHz).",
@@ -412,13 +421,99 @@ IrsPropagationLossModel::CalcIrsPaths()
     NS_LOG_DEBUG("Generated " << m_irsPaths.size() << " possible IRS path(s): " << m_irsPaths);
 }
 
+Ptr<IrsModel>
+IrsPropagationLossModel::GetEvaluatedModel(Ptr<Node> irs)
+{
+    Ptr<IrsModel> irsModel = irs->GetObject<IrsModel>();
+    if (auto codebook = dynamic_cast<IrsCodebookModel*>(PeekPointer(irsModel)))
+    {
+        // evaluate the active configuration, the direction is still the codebook's
+        return codebook->GetActiveModel();
+    }
+    return irsModel;
+}
+
+double
+IrsPropagationLossModel::CalcGainBound(const IrsPath& path,
+                                       Ptr<MobilityModel> source,
+                                       Ptr<MobilityModel> destination) const
+{
+    double bound = 0;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        Ptr<IrsModel> irsModel = GetEvaluatedModel(path[i]);
+        double maxGain;
+        auto lookupModel = dynamic_cast<IrsLookupModel*>(PeekPointer(irsModel));
+        if (lookupModel && !lookupModel->HasLookupTable4D())
+        {
+            // the angles of a 2D lookup narrow the bound to the table sectors it reads
+            Ptr<MobilityModel> prev = (i > 0) ? path[i - 1]->GetObject<MobilityModel>() : source;
+            Ptr<MobilityModel> next =
+                (i + 1 < path.size()) ? path[i + 1]->GetObject<MobilityModel>() : destination;
+            auto angles = CalcAngles(prev->GetPosition(),
+                                     next->GetPosition(),
+                                     path[i]->GetObject<MobilityModel>()->GetPosition(),
+                                     path[i]->GetObject<IrsModel>()->GetDirection());
+            if (!angles)
+            {
+                // CalcPath drops the path as well
+                return -std::numeric_limits<double>::infinity();
+            }
+            maxGain = lookupModel->GetMaxGain(angles->first, angles->second);
+        }
+        else
+        {
+            maxGain = irsModel->GetMaxGain();
+        }
+        if (maxGain == std::numeric_limits<double>::infinity())
+        {
+            return maxGain;
+        }
+        bound += maxGain;
+    }
+    return bound;
+}
+
+double
+IrsPropagationLossModel::CalcSegmentLoss(const IrsPath& path,
+                                         Ptr<MobilityModel> source,
+                                         Ptr<MobilityModel> destination) const
+{
+    double loss = 0;
+    Ptr<MobilityModel> segmentStart = source;
+    for (const auto& irs : path)
+    {
+        Ptr<MobilityModel> segmentEnd = irs->GetObject<MobilityModel>();
+        loss += m_irsLossModel->CalcRxPower(0, segmentStart, segmentEnd);
+        segmentStart = segmentEnd;
+    }
+    return loss + m_irsLossModel->CalcRxPower(0, segmentStart, destination);
+}
+
 std::complex<double>
 IrsPropagationLossModel::CalcPath(const IrsPath& path,
                                   double txPowerDbm,
                                   Ptr<MobilityModel> source,
                                   Ptr<MobilityModel> destination) const
 {
-    double pathLoss = txPowerDbm;
+    double gainBound = std::numeric_limits<double>::infinity();
+    if (m_pruningThreshold > -std::numeric_limits<double>::infinity())
+    {
+        // the gains are bounded before any segment loss is computed
+        gainBound = CalcGainBound(path, source, destination);
+        if (gainBound == -std::numeric_limits<double>::infinity())
+        {
+            return std::complex<double>(0.0, 0.0);
+        }
+    }
+
+    double pathLoss = txPowerDbm + CalcSegmentLoss(path, source, destination);
+    if (pathLoss + gainBound < m_pruningThreshold)
+    {
+        NS_LOG_DEBUG("Pruned IRS path, bound below " << m_pruningThreshold << " dBm");
+        return std::complex<double>(0.0, 0.0);
+    }
+
     double totalDistance = 0.0;
     double totalPhaseShift = 0.0;
 
@@ -432,8 +527,9 @@ IrsPropagationLossModel::CalcPath(const IrsPath& path,
             (curr + 1 != path.end()) ? (*(curr + 1))->GetObject<MobilityModel>() : destination;
         Ptr<Node> irs = *curr;
 
-        Ptr<IrsModel> irsModel = irs->GetObject<IrsModel>();
-        if (dynamic_cast<IrsLookupModel*>(PeekPointer(irsModel)))
+        Ptr<IrsModel> irsModel = GetEvaluatedModel(irs);
+        auto lookupModel = dynamic_cast<IrsLookupModel*>(PeekPointer(irsModel));
+        if (lookupModel && !lookupModel->HasLookupTable4D())
         {
             // Calculate angles
             auto angles = CalcAngles(prev->GetPosition(),
@@ -445,18 +541,18 @@ IrsPropagationLossModel::CalcPath(const IrsPath& path,
                 return std::complex<double>(0.0, 0.0);
             }
             IrsEntry modifier =
-                irsModel->GetIrsEntry(std::round(angles->first), std::round(angles->second));
+                lookupModel->LookupIrsEntry(angles->first, angles->second, m_lambda);
             NS_LOG_INFO("IRS Gain (dBm): " << modifier.gain << " | IRS phase shift (radians): "
                                            << modifier.phase_shift);
             // add path lenght and phase shift
             totalDistance += prev->GetDistanceFrom(irs->GetObject<MobilityModel>());
             totalPhaseShift += modifier.phase_shift;
             // calulate pathloss
-            pathLoss = m_irsLossModel->CalcRxPower(pathLoss, prev, irs->GetObject<MobilityModel>());
             pathLoss += modifier.gain + m_rng->GetValue();
         }
-        else if (dynamic_cast<IrsSpectrumModel*>(PeekPointer(irsModel)))
+        else if (lookupModel || dynamic_cast<IrsSpectrumModel*>(PeekPointer(irsModel)))
         {
+            // Spectrum models and lookup models with a 4D table use the full 3D directions
             // Calculate angles
             auto anglesIn = CalcAngles3D(prev->GetPosition(),
                                          irs->GetObject<MobilityModel>()->GetPosition(),
@@ -476,22 +572,18 @@ IrsPropagationLossModel::CalcPath(const IrsPath& path,
             totalDistance += prev->GetDistanceFrom(irs->GetObject<MobilityModel>());
             totalPhaseShift += modifier.phase_shift;
             // calulate pathloss
-            pathLoss = m_irsLossModel->CalcRxPower(pathLoss, prev, irs->GetObject<MobilityModel>());
             pathLoss += modifier.gain + m_rng->GetValue();
         }
     }
     totalDistance += path.back()->GetObject<MobilityModel>()->GetDistanceFrom(destination);
-    pathLoss =
-        m_irsLossModel->CalcRxPower(pathLoss, path.back()->GetObject<MobilityModel>(), destination);
     // Calculate phase for the entire path
     double theta = WrapToPi(((2 * M_PI * totalDistance) / m_lambda) + totalPhaseShift);
-    std::complex<double> phase_path(0.0, theta);
 
     NS_LOG_DEBUG("IRS - Node(s): " << path.size() << ", Distance: " << totalDistance << "m"
                                    << ", Path Loss: " << pathLoss << "dBm" << ", Phase: " << theta);
 
     NS_ASSERT_MSG(!std::isnan(pathLoss), "Path loss is NaN");
-    return std::sqrt(DbmToW(pathLoss)) * std::exp(phase_path);
+    return std::polar(std::sqrt(DbmToW(pathLoss)), theta);
 }
 
 double
@@ -520,9 +612,7 @@ IrsPropagationLossModel::DoCalcRxPower(double txPowerDbm,
         double pl_direct = m_losLossModel->CalcRxPower(txPowerDbm, a, b);
         double distance = a->GetDistanceFrom(b);
         double theta = WrapToPi((2 * M_PI * distance) / m_lambda);
-        std::complex<double> phase_direct(0.0, theta);
-        std::complex<double> los_contribution =
-            std::sqrt(DbmToW(pl_direct)) * std::exp(phase_direct);
+        std::complex<double> los_contribution = std::polar(std::sqrt(DbmToW(pl_direct)), theta);
         totalSignal += los_contribution;
 
         NS_LOG_DEBUG("LOS Path - Distance: " << distance << "m, Path Loss: " << pl_direct
@@ -534,7 +624,7 @@ IrsPropagationLossModel::DoCalcRxPower(double txPowerDbm,
         NS_LOG_DEBUG("No N/LOS propagation model specified. Calculating only IRS path.");
     }
     // Calculate final received power
-    double rxPower = DbmFromW(std::pow(std::abs(totalSignal), 2));
+    double rxPower = DbmFromW(std::norm(totalSignal));
     NS_LOG_DEBUG("Resulting RX Power (dBm): " << rxPower);
 
     return rxPower;
@@ -17,7 +17,9 @@
 #include "ns3/vector.h"
 
 #include <complex>
+#include <limits>
 #include <optional>
+#include <vector>
 
 // friend classes to test private fuctions
 class IrsPropagationLossModelTestCase;
@@ -30,6 +32,8 @@ class IrsPropagationLossModelHelperFunctionsTestCase;
 
 namespace ns3
 {
+class IrsModel;
+
 typedef std::vector<Ptr<Node>> IrsPath;
 
 /**
@@ -40,6 +44,12 @@ typedef std::vector<Ptr<Node>> IrsPath;
  * Intelligent Reflecting Surfaces (IRS) in the channel. It computes signal losses for paths
  * involving IRS nodes and includes parameters such as carrier frequency, error model, and
  * propagation loss models for line-of-sight (LoS) and IRS-reflected paths.
+ *
+ * With the \c PruningThreshold attribute, a path is only evaluated if it could reach the
+ * threshold with the largest gain of every IRS on it (\c IrsModel::GetMaxGain). The gains are
+ * bounded first, for 2D lookup models by the table sectors their angles read, and paths those
+ * angles reject are dropped before any segment loss is computed. Paths that can never matter
+ * skip the table lookups and the 3D angles.
  */
 class IrsPropagationLossModel : public PropagationLossModel
 {
@@ -172,6 +182,13 @@ class IrsPropagationLossModel : public PropagationLossModel
      */
     void CalcIrsPaths();
 
+    /**
+     * @brief Get the model evaluating the reflections of an IRS node.
+     * @param irs The IRS node.
+     * @return The IRS model of the node, or the active configuration of its codebook.
+     */
+    static Ptr<IrsModel> GetEvaluatedModel(Ptr<Node> irs);
+
     /**
      * @brief Compute the signal contribution of a specific IRS path.
      * @param path The IRS path as a vector of \c Ptr<Node>.
@@ -179,12 +196,41 @@ class IrsPropagationLossModel : public PropagationLossModel
      * @param source Mobility model of the source node.
      * @param destination Mobility model of the destination node.
      * @return The path contribution as a complex number.
+     *
+     * The loss of every segment is computed once, for a transmit power of 0 dBm as in
+     * \c CalcIrsPaths, and shared by the bound and the evaluation of the path.
      */
     std::complex<double> CalcPath(const IrsPath& path,
                                   double txPowerDbm,
                                   Ptr<MobilityModel> source,
                                   Ptr<MobilityModel> destination) const;
 
+    /**
+     * @brief Compute an upper bound of the summed IRS gains of a path.
+     * @param path The IRS path as a vector of \c Ptr<Node>.
+     * @param source Mobility model of the source node.
+     * @param destination Mobility model of the destination node.
+     * @return The summed gain in dB if every IRS reflected with its largest gain, -infinity if a
+     * 2D lookup model drops the path, +infinity if an IRS model does not know its largest gain.
+     *
+     * 2D lookup models are bounded by the table sectors around their angles, which are cheap to
+     * compute, other models by their largest gain over all angles.
+     */
+    double CalcGainBound(const IrsPath& path,
+                         Ptr<MobilityModel> source,
+                         Ptr<MobilityModel> destination) const;
+
+    /**
+     * @brief Compute the summed loss of the segments of an IRS path.
+     * @param path The IRS path as a vector of \c Ptr<Node>.
+     * @param source Mobility model of the source node.
+     * @param destination Mobility model of the destination node.
+     * @return Loss in dB of the segments from the source over each IRS to the destination.
+     */
+    double CalcSegmentLoss(const IrsPath& path,
+                           Ptr<MobilityModel> source,
+                           Ptr<MobilityModel> destination) const;
+
     double DoCalcRxPower(double txPowerDbm,
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
@@ -200,6 +246,7 @@ class IrsPropagationLossModel : public PropagationLossModel
     Ptr<NormalRandomVariable> m_rng;
     double m_frequency = 5.21e9;
     double m_lambda = 0.05754;
+    double m_pruningThreshold = -std::numeric_limits<double>::infinity();
     bool m_initialized = false;
 
     // friend classes to test private functions
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "irs-reflection-pattern.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+namespace
+{
+/**
+ * @brief Round up to a power of two.
+ * @param n The number
+ * @return The smallest power of two not below n
+ */
+uint32_t
+NextPowerOfTwo(uint32_t n)
+{
+    uint32_t power = 1;
+    while (power < n)
+    {
+        power <<= 1;
+    }
+    return power;
+}
+} // namespace
+
+IrsReflectionPattern::IrsReflectionPattern(uint32_t oversampling)
+    : m_oversampling(oversampling),
+      m_rows(0),
+      m_columns(0),
+      m_rowCenter(0),
+      m_columnCenter(0),
+      m_rowScale(0),
+      m_columnScale(0)
+{
+    NS_ABORT_MSG_UNLESS(oversampling >= 1, "Oversampling should be at least 1.");
+}
+
+void
+IrsReflectionPattern::Compute(const IrsSpectrumModel& irs, Angles in, double lambda)
+{
+    auto [nr, nc] = irs.GetN();
+    auto [dr, dc] = irs.GetSpacing();
+    Eigen::VectorXcd rcoeffs = irs.GetRcoeffs();
+    NS_ABORT_MSG_UNLESS(rcoeffs.size() == nr * nc,
+                        "Reflection coefficients must be calculated before use.");
+    Eigen::MatrixX3d elementPos = irs.GetElementPos();
+    Eigen::MatrixX3d layout = irs.CalcElementPositions();
+    NS_ABORT_MSG_UNLESS(elementPos.rows() == layout.rows() &&
+                            (elementPos - layout).cwiseAbs().maxCoeff() <= 1e-12,
+                        "Reflection pattern needs the element layout of CalcElementPositions.");
+
+    m_rows = NextPowerOfTwo(nr * m_oversampling);
+    m_columns = NextPowerOfTwo(nc * m_oversampling);
+    m_rowCenter = (nr - 1) / 2.0;
+    m_columnCenter = (nc - 1) / 2.0;
+    m_rowScale = 2 * M_PI / lambda * dr;
+    m_columnScale = 2 * M_PI / lambda * dc;
+
+    // element (i, j) is weighted by the incoming steering vector and its reflection coefficient
+    Eigen::VectorXcd weights = irs.CalcSteeringvector(in, lambda).cwiseProduct(rcoeffs);
+    m_spectrum.assign(static_cast<uint64_t>(m_rows) * m_columns, 0);
+    for (uint32_t i = 0; i < nr; ++i)
+    {
+        for (uint32_t j = 0; j < nc; ++j)
+        {
+            m_spectrum[static_cast<uint64_t>(i) * m_columns + j] = weights[i * nc + j];
+        }
+    }
+
+    // z falls with the column index, so the columns take the inverse transform; the rows beyond
+    // the IRS are zero and stay zero
+    std::vector<std::complex<double>> twiddles = CalcTwiddles(m_columns, 1);
+    for (uint32_t i = 0; i < nr; ++i)
+    {
+        Fft(&m_spectrum[static_cast<uint64_t>(i) * m_columns], m_columns, 1, twiddles);
+    }
+    Fft(m_spectrum.data(), m_rows, m_columns, CalcTwiddles(m_rows, -1));
+}
+
+std::complex<double>
+IrsReflectionPattern::GetResponse(Angles out) const
+{
+    NS_ABORT_MSG_IF(m_spectrum.empty(), "Reflection pattern must be computed before use.");
+    double cosInclination = std::cos(out.GetInclination());
+    double u = m_rowScale * cosInclination * std::sin(out.GetAzimuth());
+    double v = m_columnScale * std::sin(out.GetInclination());
+    double p = u * m_rows / (2 * M_PI);
+    double q = v * m_columns / (2 * M_PI);
+    double pFloor = std::floor(p);
+    double qFloor = std::floor(q);
+    double pWeight = p - pFloor;
+    double qWeight = q - qFloor;
+    auto p0 = static_cast<int64_t>(pFloor);
+    auto q0 = static_cast<int64_t>(qFloor);
+    std::complex<double> lower =
+        (1 - qWeight) * GetSample(p0, q0) + qWeight * GetSample(p0, q0 + 1);
+    std::complex<double> upper =
+        (1 - qWeight) * GetSample(p0 + 1, q0) + qWeight * GetSample(p0 + 1, q0 + 1);
+    return (1 - pWeight) * lower + pWeight * upper;
+}
+
+IrsEntry
+IrsReflectionPattern::GetIrsEntry(Angles out) const
+{
+    return IrsSpectrumModel::MakeIrsEntry(GetResponse(out));
+}
+
+uint32_t
+IrsReflectionPattern::GetNumRows() const
+{
+    return m_rows;
+}
+
+uint32_t
+IrsReflectionPattern::GetNumColumns() const
+{
+    return m_columns;
+}
+
+std::complex<double>
+IrsReflectionPattern::GetSample(int64_t p, int64_t q) const
+{
+    // the DFT is periodic, the phase ramp centering it on the middle of the IRS is not
+    int64_t row = ((p % m_rows) + m_rows) % m_rows;
+    int64_t column = ((q % m_columns) + m_columns) % m_columns;
+    double u = 2 * M_PI * p / m_rows;
+    double v = 2 * M_PI * q / m_columns;
+    return m_spectrum[row * m_columns + column] *
+           std::polar(1.0, u * m_rowCenter - v * m_columnCenter);
+}
+
+void
+IrsReflectionPattern::Fft(std::complex<double>* data,
+                          uint32_t n,
+                          uint32_t width,
+                          const std::vector<std::complex<double>>& twiddles)
+{
+    for (uint32_t i = 1, j = 0; i < n; ++i)
+    {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            std::swap_ranges(data + static_cast<uint64_t>(i) * width,
+                             data + static_cast<uint64_t>(i + 1) * width,
+                             data + static_cast<uint64_t>(j) * width);
+        }
+    }
+    for (uint32_t len = 2; len <= n; len <<= 1)
+    {
+        uint32_t half = len / 2;
+        uint32_t step = n / len;
+        for (uint32_t start = 0; start < n; start += len)
+        {
+            for (uint32_t k = 0; k < half; ++k)
+            {
+                std::complex<double> twiddle = twiddles[k * step];
+                std::complex<double>* a = data + static_cast<uint64_t>(start + k) * width;
+                std::complex<double>* b = a + static_cast<uint64_t>(half) * width;
+                for (uint32_t w = 0; w < width; ++w)
+                {
+                    std::complex<double> t = twiddle * b[w];
+                    b[w] = a[w] - t;
+                    a[w] += t;
+                }
+            }
+        }
+    }
+}
+
+std::vector<std::complex<double>>
+IrsReflectionPattern::CalcTwiddles(uint32_t n, int sign)
+{
+    std::vector<std::complex<double>> twiddles(n / 2);
+    for (uint32_t k = 0; k < n / 2; ++k)
+    {
+        twiddles[k] = std::polar(1.0, sign * 2 * M_PI * k / n);
+    }
+    return twiddles;
+}
+
+} // namespace ns3
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#ifndef IRS_REFLECTION_PATTERN_H
+#define IRS_REFLECTION_PATTERN_H
+
+#include "irs-model.h"
+#include "irs-spectrum-model.h"
+
+#include "ns3/angles.h"
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @class IrsReflectionPattern
+ * @brief Full reflected pattern of an \c IrsSpectrumModel for one incoming direction, computed
+ * with a 2D FFT.
+ *
+ * The elements of the IRS form a uniform planar array (see
+ * \c IrsSpectrumModel::CalcElementPositions), so the response towards an outgoing direction only
+ * depends on the phase steps u = k dr cos(inclination) sin(azimuth) between rows and
+ * v = k dc sin(inclination) between columns. Over a grid of (u, v) the response is a 2D DFT of
+ * the elements weighted by the incoming steering vector and the reflection coefficients. A
+ * zero-padded radix-2 FFT evaluates all outgoing directions of the grid in O(P Q log(P Q))
+ * instead of O(Nr Nc) per direction, with P x Q the grid size.
+ *
+ * The grid is \c Oversampling times finer than the number of elements along each axis, rounded
+ * up to a power of two. Responses on the grid are exact, responses in between are interpolated
+ * bilinearly. With the phase centered on the middle of the IRS, the error of the interpolated
+ * response stays below about (pi / Oversampling)^2 / 4 of the largest response.
+ *
+ * The pattern is a plain value, so every worker thread can compute its own.
+ */
+class IrsReflectionPattern
+{
+  public:
+    /**
+     * @brief Create an empty pattern.
+     * @param oversampling Grid points per element along each axis, at least 1
+     */
+    explicit IrsReflectionPattern(uint32_t oversampling = 8);
+
+    /**
+     * @brief Compute the pattern of an IRS for an incoming direction.
+     * @param irs The IRS, with reflection coefficients and the element layout of
+     * \c IrsSpectrumModel::CalcElementPositions
+     * @param in Incoming direction (azimuth and inclination in radians)
+     * @param lambda Wavelength in meters
+     *
+     * The IRS is only read, so several patterns can be computed from it at once.
+     */
+    void Compute(const IrsSpectrumModel& irs, Angles in, double lambda);
+
+    /**
+     * @brief Get the complex response towards an outgoing direction.
+     * @param out Outgoing direction (azimuth and inclination in radians)
+     * @return The response, interpolated between the grid points
+     */
+    std::complex<double> GetResponse(Angles out) const;
+
+    /**
+     * @brief Get the IRS entry towards an outgoing direction.
+     * @param out Outgoing direction (azimuth and inclination in radians)
+     * @return Gain and phase shift of the interpolated response
+     */
+    IrsEntry GetIrsEntry(Angles out) const;
+
+    /**
+     * @brief Get the number of grid points along the phase step between rows.
+     * @return Number of points P, a power of two
+     */
+    uint32_t GetNumRows() const;
+
+    /**
+     * @brief Get the number of grid points along the phase step between columns.
+     * @return Number of points Q, a power of two
+     */
+    uint32_t GetNumColumns() const;
+
+  private:
+    /**
+     * @brief Transform blocks of values in place with a radix-2 FFT.
+     * @param data First value of the first block
+     * @param n Number of blocks, a power of two
+     * @param width Number of values per block, transformed independently
+     * @param twiddles Twiddle factors of the transform, n / 2 of them
+     *
+     * Transforming whole rows as blocks keeps the column transform contiguous in memory.
+     */
+    static void Fft(std::complex<double>* data,
+                    uint32_t n,
+                    uint32_t width,
+                    const std::vector<std::complex<double>>& twiddles);
+
+    /**
+     * @brief Calculate the twiddle factors of a transform.
+     * @param n Size of the transform, a power of two
+     * @param sign Sign of the exponent, -1 for the forward transform
+     * @return The factors exp(sign 2 pi j k / n) for k < n / 2
+     */
+    static std::vector<std::complex<double>> CalcTwiddles(uint32_t n, int sign);
+
+    /**
+     * @brief Get the response at a grid point.
+     * @param p Index of the row phase step, any integer
+     * @param q Index of the column phase step, any integer
+     * @return The response at u = 2 pi p / P and v = 2 pi q / Q
+     */
+    std::complex<double> GetSample(int64_t p, int64_t q) const;
+
+    uint32_t m_oversampling; //!< Grid points per element along each axis
+    uint32_t m_rows;         //!< Number of grid points P along u
+    uint32_t m_columns;      //!< Number of grid points Q along v
+    double m_rowCenter;      //!< Row index of the center of the IRS
+    double m_columnCenter;   //!< Column index of the center of the IRS
+    double m_rowScale;       //!< Phase step between rows at broadside (k dr)
+    double m_columnScale;    //!< Phase step between columns at broadside (k dc)
+    std::vector<std::complex<double>> m_spectrum; //!< Uncentered DFT, P x Q row-major
+};
+
+} // namespace ns3
+
+#endif /* IRS_REFLECTION_PATTERN_H */
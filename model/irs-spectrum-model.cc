@@ -12,8 +12,11 @@
 #include "Eigen/src/Core/Matrix.h"
 
 #include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/object-base.h"
+#include "ns3/trace-source-accessor.h"
 #include "ns3/tuple.h"
 #include "ns3/uinteger.h"
 #include "ns3/vector.h"
@@ -26,6 +29,59 @@
 namespace ns3
 {
 
+namespace
+{
+/// Slot index marking the end of the LRU list
+constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+/// Epoch of the slots that were never filled
+constexpr uint64_t NO_EPOCH = UINT64_MAX;
+
+/// Number of steps after which a phasor recurrence is scaled back to unit magnitude
+constexpr uint32_t RENORMALIZE_INTERVAL = 32;
+
+/**
+ * Unit phasors of a linear phase progression, computed by complex multiplication instead of one
+ * complex exponential per element.
+ */
+class PhasorRecurrence
+{
+  public:
+    /**
+     * @brief Start a progression.
+     * @param phase Phase of the first phasor in radians
+     * @param step Phase step between consecutive phasors in radians
+     */
+    PhasorRecurrence(double phase, double step)
+        : m_phasor(std::polar(1.0, phase)),
+          m_step(std::polar(1.0, step)),
+          m_count(0)
+    {
+    }
+
+    /**
+     * @brief Get the next phasor of the progression.
+     * @return The phasor, exp(j (phase + n step)) on the n-th call
+     */
+    std::complex<double> Next()
+    {
+        std::complex<double> phasor = m_phasor;
+        m_phasor *= m_step;
+        // rounding lets the magnitude drift with every multiplication
+        if (++m_count % RENORMALIZE_INTERVAL == 0)
+        {
+            m_phasor /= std::abs(m_phasor);
+        }
+        return phasor;
+    }
+
+  private:
+    std::complex<double> m_phasor; //!< Next phasor
+    std::complex<double> m_step;   //!< Rotation between consecutive phasors
+    uint32_t m_count;              //!< Number of phasors returned
+};
+} // namespace
+
 NS_OBJECT_ENSURE_REGISTERED(IrsSpectrumModel);
 
 TypeId
@@ -57,12 +113,70 @@ IrsSpectrumModel::GetTypeId()
                           DoubleValue(5.21e9),
                           MakeDoubleAccessor(&IrsSpectrumModel::SetFrequency,
                                              &IrsSpectrumModel::GetFrequency),
-                          MakeDoubleChecker<double>());
+                          MakeDoubleChecker<double>())
+            .AddAttribute("CacheCapacity",
+                          "Number of directions each level of the steering vector cache holds, "
+                          "0 disables caching. The vector of a direction is allocated when it "
+                          "is first cached.",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&IrsSpectrumModel::SetCacheCapacity,
+                                               &IrsSpectrumModel::GetCacheCapacity),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("SeparableEvaluation",
+                          "Evaluate reflection coefficients that factor into a row and a column "
+                          "term, like those of CalcRCoeffs, as the product of two sums over the "
+                          "rows and the columns instead of using the cache. Not used while a "
+                          "GridResolution is set.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&IrsSpectrumModel::SetSeparableEvaluation,
+                                              &IrsSpectrumModel::GetSeparableEvaluation),
+                          MakeBooleanChecker())
+            .AddAttribute("SimdKernel",
+                          "Evaluate uncached responses with AVX2 or AVX-512 where the CPU "
+                          "supports it, instead of the scalar loop.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&IrsSpectrumModel::SetSimdKernel,
+                                              &IrsSpectrumModel::GetSimdKernel),
+                          MakeBooleanChecker())
+            .AddAttribute("GridResolution",
+                          "Grid step in degrees the cached steering vectors are computed at, "
+                          "with bilinear interpolation in between. 0 caches the directions "
+                          "truncated to whole degrees instead. Takes precedence over "
+                          "SeparableEvaluation.",
+                          DoubleValue(0),
+                          MakeDoubleAccessor(&IrsSpectrumModel::SetGridResolution,
+                                             &IrsSpectrumModel::GetGridResolution),
+                          MakeDoubleChecker<double>(0))
+            .AddTraceSource("CacheHits",
+                            "Number of steering vector cache lookups that hit.",
+                            MakeTraceSourceAccessor(&IrsSpectrumModel::m_cacheHits),
+                            "ns3::TracedValueCallback::Uint64")
+            .AddTraceSource("CacheMisses",
+                            "Number of steering vector cache lookups that missed.",
+                            MakeTraceSourceAccessor(&IrsSpectrumModel::m_cacheMisses),
+                            "ns3::TracedValueCallback::Uint64")
+            .AddTraceSource("CacheEvictions",
+                            "Number of cached steering vectors evicted to make room.",
+                            MakeTraceSourceAccessor(&IrsSpectrumModel::m_cacheEvictions),
+                            "ns3::TracedValueCallback::Uint64");
     return tid;
 }
 
 IrsSpectrumModel::IrsSpectrumModel()
+    : m_cacheCapacity(0),
+      m_gridResolution(0),
+      m_separableEvaluation(true),
+      m_separable(false),
+      m_gridLayout(false),
+      m_uniformGrid(false),
+      m_depth(0),
+      m_rowStep(0),
+      m_columnStep(0),
+      m_cacheHits(0),
+      m_cacheMisses(0),
+      m_cacheEvictions(0)
 {
+    SetCacheCapacity(1024);
 }
 
 void
@@ -73,41 +187,206 @@ IrsSpectrumModel::CalcRCoeffs(double dApSta,
                               double delta)
 {
     m_elementPos = CalcElementPositions();
-    m_cache.clear();
+    m_steeringCache.Invalidate();
+    m_weightedCache.Invalidate();
+    UpdateLayout();
+    ResizeBuffers();
 
-    Eigen::VectorXcd stv_in = CalcSteeringvector(inAngle, m_lambda, m_elementPos).array().arg();
-    Eigen::VectorXcd stv_out = CalcSteeringvector(outAngle, m_lambda, m_elementPos).array().arg();
+    Eigen::VectorXcd stv_in = CalcSteeringvector(inAngle, m_lambda).array().arg();
+    Eigen::VectorXcd stv_out = CalcSteeringvector(outAngle, m_lambda).array().arg();
     double shift = CalcPhaseShift(dApSta, dApIrsSta, delta);
 
     m_rcoeffs = (std::complex<double>(0, 1) *
                  (Eigen::VectorXd::Constant(m_Nr * m_Nc, shift) - stv_in - stv_out))
                     .array()
                     .exp();
+    FactorRcoeffs();
+    m_kernel.SetElements(m_elementPos, m_rcoeffs);
 }
 
 void
 IrsSpectrumModel::CalcRCoeffs(Angles inAngle, Angles outAngle)
 {
     m_elementPos = CalcElementPositions();
-    m_cache.clear();
+    m_steeringCache.Invalidate();
+    m_weightedCache.Invalidate();
+    UpdateLayout();
+    ResizeBuffers();
 
-    Eigen::VectorXcd stv_in = CalcSteeringvector(inAngle, m_lambda, m_elementPos).array().arg();
-    Eigen::VectorXcd stv_out = CalcSteeringvector(outAngle, m_lambda, m_elementPos).array().arg();
+    Eigen::VectorXcd stv_in = CalcSteeringvector(inAngle, m_lambda).array().arg();
+    Eigen::VectorXcd stv_out = CalcSteeringvector(outAngle, m_lambda).array().arg();
 
     m_rcoeffs = (std::complex<double>(0, 1) * (-stv_in - stv_out)).array().exp();
+    FactorRcoeffs();
+    m_kernel.SetElements(m_elementPos, m_rcoeffs);
 }
 
 void
 IrsSpectrumModel::SetRcoeffs(Eigen::VectorXcd rcoeffs)
 {
-    m_cache.clear();
+    m_weightedCache.Invalidate();
     m_rcoeffs = rcoeffs;
+    FactorRcoeffs();
+    m_kernel.SetElements(m_elementPos, m_rcoeffs);
 }
 
 void
 IrsSpectrumModel::SetElementPos(Eigen::MatrixX3d positions)
 {
     m_elementPos = positions;
+    m_steeringCache.Invalidate();
+    m_weightedCache.Invalidate();
+    UpdateLayout();
+    ResizeBuffers();
+    FactorRcoeffs();
+    m_kernel.SetElements(m_elementPos, m_rcoeffs);
+}
+
+void
+IrsSpectrumModel::ResizeBuffers()
+{
+    auto size = static_cast<uint32_t>(m_elementPos.rows());
+    m_steeringCache.SetVectorSize(size);
+    m_weightedCache.SetVectorSize(size);
+    m_uncached.resize(size);
+    m_uncachedWeighted.resize(size);
+    m_blendIn.resize(size);
+    m_blendOut.resize(size);
+}
+
+void
+IrsSpectrumModel::UpdateLayout()
+{
+    m_gridLayout = false;
+    m_uniformGrid = false;
+    Eigen::Index n = m_elementPos.rows();
+    if (n == 0 || n != m_Nr * m_Nc)
+    {
+        return;
+    }
+
+    m_rowPos.resize(m_Nr);
+    for (uint32_t i = 0; i < m_Nr; ++i)
+    {
+        m_rowPos[i] = m_elementPos(i * m_Nc, 1);
+    }
+    m_columnPos.resize(m_Nc);
+    for (uint32_t j = 0; j < m_Nc; ++j)
+    {
+        m_columnPos[j] = m_elementPos(j, 2);
+    }
+    m_depth = m_elementPos(0, 0);
+    for (uint32_t i = 0; i < m_Nr; ++i)
+    {
+        for (uint32_t j = 0; j < m_Nc; ++j)
+        {
+            uint32_t e = i * m_Nc + j;
+            if (m_elementPos(e, 0) != m_depth || m_elementPos(e, 1) != m_rowPos[i] ||
+                m_elementPos(e, 2) != m_columnPos[j])
+            {
+                return;
+            }
+        }
+    }
+    m_gridLayout = true;
+
+    // the recurrence needs equally spaced rows and columns
+    m_rowStep = m_Nr > 1 ? (m_rowPos[m_Nr - 1] - m_rowPos[0]) / (m_Nr - 1) : 0;
+    m_columnStep = m_Nc > 1 ? (m_columnPos[m_Nc - 1] - m_columnPos[0]) / (m_Nc - 1) : 0;
+    for (uint32_t i = 0; i < m_Nr; ++i)
+    {
+        if (std::abs(m_rowPos[i] - (m_rowPos[0] + i * m_rowStep)) > 1e-12 * std::abs(m_rowStep))
+        {
+            return;
+        }
+    }
+    for (uint32_t j = 0; j < m_Nc; ++j)
+    {
+        if (std::abs(m_columnPos[j] - (m_columnPos[0] + j * m_columnStep)) >
+            1e-12 * std::abs(m_columnStep))
+        {
+            return;
+        }
+    }
+    m_uniformGrid = true;
+}
+
+void
+IrsSpectrumModel::FactorRcoeffs()
+{
+    m_separable = false;
+    if (!m_gridLayout || m_rcoeffs.size() != m_elementPos.rows())
+    {
+        return;
+    }
+
+    // the largest coefficient divides the column term, so the factors are well conditioned
+    Eigen::Index pivot;
+    double maxCoeff = m_rcoeffs.cwiseAbs().maxCoeff(&pivot);
+    if (maxCoeff == 0)
+    {
+        return;
+    }
+    uint32_t pivotRow = pivot / m_Nc;
+    uint32_t pivotColumn = pivot % m_Nc;
+    m_rowCoeffs.resize(m_Nr);
+    for (uint32_t i = 0; i < m_Nr; ++i)
+    {
+        m_rowCoeffs[i] = m_rcoeffs[i * m_Nc + pivotColumn];
+    }
+    m_columnCoeffs.resize(m_Nc);
+    for (uint32_t j = 0; j < m_Nc; ++j)
+    {
+        m_columnCoeffs[j] = m_rcoeffs[pivotRow * m_Nc + j] / m_rcoeffs[pivot];
+    }
+
+    // the coefficients must be the product of the two terms
+    double tolerance = 1e-10 * maxCoeff;
+    for (uint32_t i = 0; i < m_Nr; ++i)
+    {
+        for (uint32_t j = 0; j < m_Nc; ++j)
+        {
+            if (std::abs(m_rcoeffs[i * m_Nc + j] - m_rowCoeffs[i] * m_columnCoeffs[j]) >
+                tolerance)
+            {
+                return;
+            }
+        }
+    }
+    m_separable = true;
+}
+
+IrsEntry
+IrsSpectrumModel::CalcSeparableIrsEntry(Angles in, Angles out, double lambda) const
+{
+    Eigen::Vector3d k = CalcWaveVector(in, lambda) + CalcWaveVector(out, lambda);
+    std::complex<double> rowSum = 0;
+    std::complex<double> columnSum = 0;
+    if (m_uniformGrid)
+    {
+        PhasorRecurrence row(-k.y() * m_rowPos[0], -k.y() * m_rowStep);
+        for (Eigen::Index i = 0; i < m_rowCoeffs.size(); ++i)
+        {
+            rowSum += m_rowCoeffs[i] * row.Next();
+        }
+        PhasorRecurrence column(-k.z() * m_columnPos[0], -k.z() * m_columnStep);
+        for (Eigen::Index j = 0; j < m_columnCoeffs.size(); ++j)
+        {
+            columnSum += m_columnCoeffs[j] * column.Next();
+        }
+    }
+    else
+    {
+        for (Eigen::Index i = 0; i < m_rowCoeffs.size(); ++i)
+        {
+            rowSum += m_rowCoeffs[i] * std::polar(1.0, -k.y() * m_rowPos[i]);
+        }
+        for (Eigen::Index j = 0; j < m_columnCoeffs.size(); ++j)
+        {
+            columnSum += m_columnCoeffs[j] * std::polar(1.0, -k.z() * m_columnPos[j]);
+        }
+    }
+    return MakeIrsEntry(std::polar(1.0, -k.x() * m_depth) * rowSum * columnSum);
 }
 
 Eigen::MatrixX3d
@@ -152,53 +431,501 @@ IrsSpectrumModel::CalcElementPositions() const
 }
 
 Eigen::VectorXcd
-IrsSpectrumModel::CalcSteeringvector(Angles angle, double lambda, Eigen::MatrixX3d elementPos) const
+IrsSpectrumModel::CalcSteeringvector(Angles angle,
+                                     double lambda,
+                                     const Eigen::MatrixX3d& elementPos) const
 {
     Eigen::Vector3d k = CalcWaveVector(angle, lambda);
 
     return (-std::complex<double>(0, 1) * (elementPos * k).array()).exp();
 }
 
+Eigen::VectorXcd
+IrsSpectrumModel::CalcSteeringvector(Angles angle, double lambda) const
+{
+    Eigen::VectorXcd stv;
+    FillSteeringvector(angle, lambda, stv);
+    return stv;
+}
+
+void
+IrsSpectrumModel::FillSteeringvector(Angles angle, double lambda, Eigen::VectorXcd& stv) const
+{
+    Eigen::Vector3d k = CalcWaveVector(angle, lambda);
+    if (!m_uniformGrid)
+    {
+        // the phases are a coefficient-wise expression, so no product is evaluated into a
+        // temporary
+        stv.resize(m_elementPos.rows());
+        stv.array() = (-std::complex<double>(0, 1) *
+                       (m_elementPos.col(0) * k.x() + m_elementPos.col(1) * k.y() +
+                        m_elementPos.col(2) * k.z())
+                           .array())
+                          .exp();
+        return;
+    }
+
+    // exp(-j k.r) = exp(-j (kx x + kz z_j)) exp(-j ky y_i): the column phasors are computed
+    // into the first row, then scaled by the row phasors from the last row up, so the first row
+    // is overwritten last
+    stv.resize(m_Nr * m_Nc);
+    PhasorRecurrence column(-(k.x() * m_depth + k.z() * m_columnPos[0]), -k.z() * m_columnStep);
+    for (uint32_t j = 0; j < m_Nc; ++j)
+    {
+        stv[j] = column.Next();
+    }
+    PhasorRecurrence row(-k.y() * m_rowPos[m_Nr - 1], k.y() * m_rowStep);
+    for (uint32_t i = m_Nr; i-- > 0;)
+    {
+        stv.segment(i * m_Nc, m_Nc) = row.Next() * stv.head(m_Nc);
+    }
+}
+
 double
 IrsSpectrumModel::CalcPhaseShift(double dApSta, double dApIrsSta, double delta) const
 {
     return delta + ((2 * M_PI * dApIrsSta) / m_lambda) - ((2 * M_PI * dApSta) / m_lambda);
 }
 
+IrsSpectrumModel::SteeringCache::SteeringCache()
+    : m_capacity(0),
+      m_vectorSize(0),
+      m_head(NO_SLOT),
+      m_tail(NO_SLOT),
+      m_epoch(0),
+      m_size(0)
+{
+}
+
+void
+IrsSpectrumModel::SteeringCache::SetCapacity(uint32_t capacity, uint32_t size)
+{
+    m_slots.clear();
+    m_index.clear();
+    m_slots.resize(capacity);
+    m_index.reserve(capacity);
+    m_capacity = capacity;
+    m_vectorSize = size;
+    m_head = NO_SLOT;
+    m_tail = NO_SLOT;
+    m_size = 0;
+    for (uint32_t slot = 0; slot < capacity; ++slot)
+    {
+        // unused slots hold the index nodes under keys of wavelength 0, which no direction has
+        m_slots[slot].key = {slot, 0};
+        m_slots[slot].epoch = NO_EPOCH;
+        m_index.emplace(m_slots[slot].key, slot);
+        PushFront(slot);
+    }
+}
+
+void
+IrsSpectrumModel::SteeringCache::SetVectorSize(uint32_t size)
+{
+    m_vectorSize = size;
+    for (auto& slot : m_slots)
+    {
+        if (slot.value.size() != 0)
+        {
+            slot.value.resize(size);
+        }
+    }
+}
+
+uint32_t
+IrsSpectrumModel::SteeringCache::GetCapacity() const
+{
+    return m_capacity;
+}
+
+uint32_t
+IrsSpectrumModel::SteeringCache::GetSize() const
+{
+    return m_size;
+}
+
+void
+IrsSpectrumModel::SteeringCache::Invalidate()
+{
+    ++m_epoch;
+    m_size = 0;
+}
+
+const Eigen::VectorXcd*
+IrsSpectrumModel::SteeringCache::Find(const DirectionKey& key)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end() || m_slots[it->second].epoch != m_epoch)
+    {
+        return nullptr;
+    }
+    if (it->second != m_head)
+    {
+        Unlink(it->second);
+        PushFront(it->second);
+    }
+    return &m_slots[it->second].value;
+}
+
+Eigen::VectorXcd&
+IrsSpectrumModel::SteeringCache::Insert(const DirectionKey& key, bool& evicted)
+{
+    NS_ASSERT_MSG(m_capacity > 0, "Steering vector cache without capacity.");
+    evicted = false;
+    uint32_t index;
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        // slot of an older epoch, refilled in place
+        index = it->second;
+        if (m_slots[index].epoch == m_epoch)
+        {
+            --m_size;
+        }
+        Unlink(index);
+    }
+    else
+    {
+        index = m_tail;
+        Slot& victim = m_slots[index];
+        if (victim.epoch == m_epoch)
+        {
+            evicted = true;
+            --m_size;
+        }
+        Unlink(index);
+        // the node of the victim is reused for the new key, so eviction does not allocate
+        auto node = m_index.extract(victim.key);
+        node.key() = key;
+        m_index.insert(std::move(node));
+        victim.key = key;
+    }
+    if (m_slots[index].value.size() != m_vectorSize)
+    {
+        // first fill of the slot
+        m_slots[index].value.resize(m_vectorSize);
+    }
+    m_slots[index].epoch = m_epoch;
+    ++m_size;
+    PushFront(index);
+    return m_slots[index].value;
+}
+
+void
+IrsSpectrumModel::SteeringCache::Unlink(uint32_t slot)
+{
+    Slot& s = m_slots[slot];
+    if (s.prev != NO_SLOT)
+    {
+        m_slots[s.prev].next = s.next;
+    }
+    else
+    {
+        m_head = s.next;
+    }
+    if (s.next != NO_SLOT)
+    {
+        m_slots[s.next].prev = s.prev;
+    }
+    else
+    {
+        m_tail = s.prev;
+    }
+    s.prev = NO_SLOT;
+    s.next = NO_SLOT;
+}
+
+void
+IrsSpectrumModel::SteeringCache::PushFront(uint32_t slot)
+{
+    m_slots[slot].prev = NO_SLOT;
+    m_slots[slot].next = m_head;
+    if (m_head != NO_SLOT)
+    {
+        m_slots[m_head].prev = slot;
+    }
+    else
+    {
+        m_tail = slot;
+    }
+    m_head = slot;
+}
+
+IrsSpectrumModel::DirectionKey
+IrsSpectrumModel::MakeKey(int32_t azimuth, int32_t inclination, double lambda)
+{
+    auto packedAzimuth = static_cast<uint16_t>(static_cast<int16_t>(azimuth));
+    auto packedInclination = static_cast<uint16_t>(static_cast<int16_t>(inclination));
+    return {(static_cast<uint32_t>(packedAzimuth) << 16) | packedInclination,
+            static_cast<uint64_t>(std::llround(lambda * 1e15))};
+}
+
+IrsSpectrumModel::DirectionKey
+IrsSpectrumModel::MakeKey(Angles angle, double lambda)
+{
+    const double RAD_TO_DEG = 180.0 / M_PI;
+    return MakeKey(static_cast<int32_t>(angle.GetAzimuth() * RAD_TO_DEG),
+                   static_cast<int32_t>(angle.GetInclination() * RAD_TO_DEG),
+                   lambda);
+}
+
+void
+IrsSpectrumModel::GetGridCorners(Angles angle, double lambda, GridCorner corners[4]) const
+{
+    const double RAD_TO_DEG = 180.0 / M_PI;
+    double azimuth = angle.GetAzimuth() * RAD_TO_DEG / m_gridResolution;
+    double inclination = angle.GetInclination() * RAD_TO_DEG / m_gridResolution;
+    double azimuthFloor = std::floor(azimuth);
+    double inclinationFloor = std::floor(inclination);
+    double azimuthWeight = azimuth - azimuthFloor;
+    double inclinationWeight = inclination - inclinationFloor;
+    for (uint32_t k = 0; k < 4; ++k)
+    {
+        bool upperAzimuth = k & 2;
+        bool upperInclination = k & 1;
+        auto azimuthIndex = static_cast<int32_t>(azimuthFloor) + upperAzimuth;
+        auto inclinationIndex = static_cast<int32_t>(inclinationFloor) + upperInclination;
+        corners[k].weight = (upperAzimuth ? azimuthWeight : 1 - azimuthWeight) *
+                            (upperInclination ? inclinationWeight : 1 - inclinationWeight);
+        corners[k].key = MakeKey(azimuthIndex, inclinationIndex, lambda);
+        corners[k].angle = Angles(DegreesToRadians(azimuthIndex * m_gridResolution),
+                                  DegreesToRadians(inclinationIndex * m_gridResolution));
+    }
+}
+
+IrsEntry
+IrsSpectrumModel::GetGridIrsEntry(Angles in, Angles out, double lambda) const
+{
+    GridCorner corners[4];
+    m_blendIn.setZero(m_rcoeffs.size());
+    GetGridCorners(in, lambda, corners);
+    for (const auto& corner : corners)
+    {
+        // grid points without weight are not evaluated, e.g. for directions on the grid
+        if (corner.weight > 0)
+        {
+            m_blendIn.noalias() +=
+                corner.weight * GetWeightedSteeringvector(corner.key, corner.angle, lambda);
+        }
+    }
+    m_blendOut.setZero(m_rcoeffs.size());
+    GetGridCorners(out, lambda, corners);
+    for (const auto& corner : corners)
+    {
+        if (corner.weight > 0)
+        {
+            m_blendOut.noalias() +=
+                corner.weight * GetSteeringvector(corner.key, corner.angle, lambda);
+        }
+    }
+    return MakeIrsEntry(m_blendIn.cwiseProduct(m_blendOut).sum());
+}
+
+const Eigen::VectorXcd&
+IrsSpectrumModel::GetSteeringvector(const DirectionKey& key, Angles angle, double lambda) const
+{
+    if (m_cacheCapacity == 0)
+    {
+        FillSteeringvector(angle, lambda, m_uncached);
+        return m_uncached;
+    }
+    const Eigen::VectorXcd* cached = m_steeringCache.Find(key);
+    if (cached)
+    {
+        CountLookup(true, false);
+        return *cached;
+    }
+    bool evicted;
+    Eigen::VectorXcd& slot = m_steeringCache.Insert(key, evicted);
+    CountLookup(false, evicted);
+    FillSteeringvector(angle, lambda, slot);
+    return slot;
+}
+
+const Eigen::VectorXcd&
+IrsSpectrumModel::GetWeightedSteeringvector(const DirectionKey& key,
+                                            Angles angle,
+                                            double lambda) const
+{
+    if (m_cacheCapacity == 0)
+    {
+        FillSteeringvector(angle, lambda, m_uncachedWeighted);
+        m_uncachedWeighted.array() *= m_rcoeffs.array();
+        return m_uncachedWeighted;
+    }
+    const Eigen::VectorXcd* cached = m_weightedCache.Find(key);
+    if (cached)
+    {
+        CountLookup(true, false);
+        return *cached;
+    }
+    const Eigen::VectorXcd& steering = GetSteeringvector(key, angle, lambda);
+    bool evicted;
+    Eigen::VectorXcd& slot = m_weightedCache.Insert(key, evicted);
+    CountLookup(false, evicted);
+    slot = steering.cwiseProduct(m_rcoeffs);
+    return slot;
+}
+
+void
+IrsSpectrumModel::CountLookup(bool hit, bool evicted) const
+{
+    if (hit)
+    {
+        ++m_cacheHits;
+        return;
+    }
+    ++m_cacheMisses;
+    if (evicted)
+    {
+        ++m_cacheEvictions;
+    }
+}
+
 IrsEntry
 IrsSpectrumModel::GetIrsEntry(Angles in, Angles out, double lambda) const
 {
-    // Create cache key
-    CacheKey key{in, out, lambda};
+    NS_ABORT_MSG_UNLESS(m_rcoeffs.size() > 0,
+                        "Reflection coefficients must be calculated before use.");
+    // a grid the user asked for keeps results independent of the query order, so it comes first
+    if (m_gridResolution > 0)
+    {
+        return GetGridIrsEntry(in, out, lambda);
+    }
+    if (m_separable && m_separableEvaluation)
+    {
+        return CalcSeparableIrsEntry(in, out, lambda);
+    }
 
-    // Check if result is in cache
-    auto it = m_cache.find(key);
-    if (it != m_cache.end())
+    if (m_cacheCapacity == 0)
     {
-        return it->second;
+        return CalcIrsEntry(in, out, lambda);
     }
+    const Eigen::VectorXcd& weighted = GetWeightedSteeringvector(MakeKey(in, lambda), in, lambda);
+    const Eigen::VectorXcd& stvOut = GetSteeringvector(MakeKey(out, lambda), out, lambda);
+    return MakeIrsEntry(weighted.cwiseProduct(stvOut).sum());
+}
+
+void
+IrsSpectrumModel::SetCacheCapacity(uint32_t capacity)
+{
+    m_cacheCapacity = capacity;
+    auto size = static_cast<uint32_t>(m_elementPos.rows());
+    m_steeringCache.SetCapacity(capacity, size);
+    m_weightedCache.SetCapacity(capacity, size);
+}
+
+uint32_t
+IrsSpectrumModel::GetCacheCapacity() const
+{
+    return m_cacheCapacity;
+}
+
+void
+IrsSpectrumModel::SetGridResolution(double resolution)
+{
+    NS_ABORT_MSG_UNLESS(resolution == 0 || resolution >= 0.01,
+                        "Grid resolution should be 0 or at least 0.01 degrees.");
+    m_gridResolution = resolution;
+    // keys of grid points and of whole degrees can not be mixed
+    m_steeringCache.Invalidate();
+    m_weightedCache.Invalidate();
+}
+
+double
+IrsSpectrumModel::GetGridResolution() const
+{
+    return m_gridResolution;
+}
+
+void
+IrsSpectrumModel::SetSeparableEvaluation(bool separable)
+{
+    m_separableEvaluation = separable;
+}
+
+bool
+IrsSpectrumModel::GetSeparableEvaluation() const
+{
+    return m_separableEvaluation;
+}
+
+bool
+IrsSpectrumModel::IsSeparable() const
+{
+    return m_separable;
+}
+
+void
+IrsSpectrumModel::SetSimdKernel(bool simd)
+{
+    m_kernel.SetIsa(simd ? IrsArrayResponseKernel::GetBestIsa() : IrsArrayResponseKernel::SCALAR);
+}
+
+bool
+IrsSpectrumModel::GetSimdKernel() const
+{
+    return m_kernel.GetIsa() != IrsArrayResponseKernel::SCALAR;
+}
+
+uint64_t
+IrsSpectrumModel::GetCacheHits() const
+{
+    return m_cacheHits;
+}
+
+uint64_t
+IrsSpectrumModel::GetCacheMisses() const
+{
+    return m_cacheMisses;
+}
+
+uint64_t
+IrsSpectrumModel::GetCacheEvictions() const
+{
+    return m_cacheEvictions;
+}
 
+IrsEntry
+IrsSpectrumModel::CalcIrsEntry(Angles in, Angles out, double lambda) const
+{
     NS_ABORT_MSG_UNLESS(m_rcoeffs.size() > 0,
                         "Reflection coefficients must be calculated before use.");
 
-    Eigen::VectorXcd stv_in = CalcSteeringvector(in, lambda, m_elementPos);
-    Eigen::VectorXcd stv_out = CalcSteeringvector(out, lambda, m_elementPos);
+    if (m_kernel.GetSize() != m_rcoeffs.size())
+    {
+        // positions and coefficients do not match, CalcIrsEntry reports it
+        Eigen::VectorXcd stv_in = CalcSteeringvector(in, lambda);
+        Eigen::VectorXcd stv_out = CalcSteeringvector(out, lambda);
+        return CalcIrsEntry(stv_in, stv_out);
+    }
+    Eigen::Vector3d k = CalcWaveVector(in, lambda) + CalcWaveVector(out, lambda);
+    return MakeIrsEntry(m_kernel.Evaluate(k));
+}
 
-    NS_ASSERT_MSG((stv_in.array() == stv_in.array()).all(), "stv_in contains NaN values!");
-    NS_ASSERT_MSG((stv_out.array() == stv_out.array()).all(), "stv_out contains NaN values!");
+IrsEntry
+IrsSpectrumModel::CalcIrsEntry(const Eigen::VectorXcd& stvIn, const Eigen::VectorXcd& stvOut) const
+{
+    NS_ABORT_MSG_UNLESS(m_rcoeffs.size() > 0,
+                        "Reflection coefficients must be calculated before use.");
+    NS_ABORT_MSG_UNLESS(stvIn.size() == m_rcoeffs.size() && stvOut.size() == m_rcoeffs.size(),
+                        "Steering vectors must have one element per reflection coefficient.");
+
+    NS_ASSERT_MSG((stvIn.array() == stvIn.array()).all(), "stv_in contains NaN values!");
+    NS_ASSERT_MSG((stvOut.array() == stvOut.array()).all(), "stv_out contains NaN values!");
     NS_ASSERT_MSG((m_rcoeffs.array() == m_rcoeffs.array()).all(), "m_rcoeffs contains NaN values!");
 
-    Eigen::MatrixXcd signal_inc = stv_in.transpose();
-    Eigen::MatrixXcd signal_weighted = signal_inc.array().rowwise() * m_rcoeffs.transpose().array();
-    Eigen::VectorXcd signal_ref = signal_weighted * stv_out;
+    // signal reflected by all elements, weighted by their reflection coefficients
+    return MakeIrsEntry((stvIn.array() * m_rcoeffs.array() * stvOut.array()).sum());
+}
 
-    double gain =
-        10 * std::log10((signal_ref.conjugate().array() * signal_ref.array()).real().mean());
-    double shift = -signal_ref.array().arg().mean();
+IrsEntry
+IrsSpectrumModel::MakeIrsEntry(std::complex<double> signal)
+{
+    double gain = 10 * std::log10(std::norm(signal));
+    double shift = -std::arg(signal);
 
-    IrsEntry result(gain, shift);
-    m_cache.emplace(key, result);
-    return result;
+    return IrsEntry(gain, shift);
 }
 
 IrsEntry
@@ -215,6 +942,8 @@ IrsSpectrumModel::SetN(std::tuple<uint16_t, uint16_t> N)
     m_Nr = std::get<0>(N);
     m_Nc = std::get<1>(N);
     NS_ABORT_MSG_UNLESS(m_Nr > 0 && m_Nc > 0, "Amount of elements should be greater zero.");
+    UpdateLayout();
+    FactorRcoeffs();
 }
 
 std::tuple<uint16_t, uint16_t>
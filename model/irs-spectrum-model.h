@@ -10,15 +10,20 @@
 #ifndef IRS_SPECTRUM_MODEL_H
 #define IRS_SPECTRUM_MODEL_H
 
+#include "irs-array-response-kernel.h"
 #include "irs-model.h"
 
 #include "ns3/angles.h"
 #include "ns3/object.h"
+#include "ns3/traced-value.h"
 #include "ns3/vector.h"
 
 #include <Eigen/Dense>
+#include <complex>
 #include <cstdint>
 #include <sys/types.h>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @defgroup irs Intelligent Reflecting Surface (IRS) Models
@@ -33,6 +38,40 @@ namespace ns3
  *
  * This class calculates IRS reflection coefficients, steering vectors, and
  * element positions based on the spectrum propagation model.
+ *
+ * \c GetIrsEntry caches per direction instead of per pair of directions, with the angles
+ * truncated to whole degrees. The steering vector of every direction is computed once, and
+ * every incoming direction additionally keeps its steering vector weighted by the reflection
+ * coefficients. A pair of known directions then costs a single dot product over the elements,
+ * without any \c exp, and the caches grow with the number of distinct directions rather than
+ * with the number of pairs. Changing the reflection coefficients only drops the weighted
+ * vectors, changing the element positions drops both.
+ *
+ * Reflection coefficients that factor into a row and a column term, like those of
+ * \c CalcRCoeffs steering a single beam, are detected whenever the coefficients or element
+ * positions change. The steering vectors of a uniform planar array factor the same way, so the
+ * response is the product of a sum over the rows and a sum over the columns, evaluated in
+ * O(Nr + Nc) without the cache. Arbitrary coefficients, e.g. tiles steered towards different
+ * users, take the cached O(Nr Nc) path. \c SeparableEvaluation disables the separable path, and
+ * so does a \c GridResolution, which takes precedence.
+ *
+ * With \c GridResolution set, steering vectors are only computed at the grid points of that
+ * resolution, so the result no longer depends on which direction of a degree came first. The
+ * vectors of the four grid points around each direction are blended bilinearly. As the response
+ * is bilinear in both vectors, this interpolates the complex response H(in, out) multilinearly
+ * between the 16 surrounding grid point pairs at the cost of a single dot product. The number of
+ * distinct evaluations is bounded by the grid, whose resolution trades memory for accuracy.
+ *
+ * Each cache level holds at most \c CacheCapacity directions and evicts the least recently
+ * used one when full. Dropping a level is O(1). A slot allocates its vector the first time it is
+ * filled, misses refill the vectors of evicted or stale slots in place, so lookups do not allocate
+ * once the caches are warm. The \c CacheHits,
+ * \c CacheMisses and \c CacheEvictions trace sources count the lookups of both levels, to size
+ * the cache for a scenario.
+ *
+ * Without a cache, \c GetIrsEntry and \c CalcIrsEntry compute the phases, the reflection
+ * coefficients and the sum over the elements in one pass of an \c IrsArrayResponseKernel, with
+ * AVX2 or AVX-512 where the CPU supports it. \c SimdKernel forces the scalar loop.
  */
 class IrsSpectrumModel : public IrsModel
 {
@@ -65,6 +104,36 @@ class IrsSpectrumModel : public IrsModel
      */
     IrsEntry GetIrsEntry(Angles in, Angles out, double lambda) const override;
 
+    /**
+     * @brief Calculate an IRS entry without using or filling the cache.
+     * @param in Input angles (azimuth and elevation in radians) as an \c Angles object.
+     * @param out Output angles (azimuth and elevation in radians) as an \c Angles object.
+     * @param lambda Wavelength of the signal in meters.
+     * @return The corresponding \c IrsEntry object.
+     *
+     * Evaluates all elements in a single vectorized pass, see \c IrsArrayResponseKernel. Only
+     * reads the reflection coefficients and element positions, so it can be called from several
+     * threads at once as long as the coefficients are not changed meanwhile.
+     */
+    IrsEntry CalcIrsEntry(Angles in, Angles out, double lambda) const;
+
+    /**
+     * @brief Calculate an IRS entry from precomputed steering vectors, without the cache.
+     * @param stvIn Steering vector of the input angles, see \c CalcSteeringvector
+     * @param stvOut Steering vector of the output angles, see \c CalcSteeringvector
+     * @return The corresponding \c IrsEntry object.
+     *
+     * Thread-safe like \c CalcIrsEntry(Angles, Angles, double).
+     */
+    IrsEntry CalcIrsEntry(const Eigen::VectorXcd& stvIn, const Eigen::VectorXcd& stvOut) const;
+
+    /**
+     * @brief Calculate an IRS entry from the signal reflected by all elements.
+     * @param signal Sum of the element responses
+     * @return Gain and phase shift of the signal
+     */
+    static IrsEntry MakeIrsEntry(std::complex<double> signal);
+
     /**
      * @brief Calculate reflection coefficients based on path distances, angles, and phase offset.
      * @param dApSta Distance between the access point and the station
@@ -156,11 +225,107 @@ class IrsSpectrumModel : public IrsModel
      * @brief Calculate the steering vector for the given angles and wavelength.
      * @param angle Incident or reflection angles
      * @param lambda Wavelength in meters
+     * @param elementPos Positions of the elements, one per row
      * @return A vector representing the steering vector
      */
     Eigen::VectorXcd CalcSteeringvector(Angles angle,
                                         double lambda,
-                                        Eigen::MatrixX3d elementPos) const;
+                                        const Eigen::MatrixX3d& elementPos) const;
+
+    /**
+     * @brief Calculate the steering vector of the element positions of this IRS.
+     * @param angle Incident or reflection angles
+     * @param lambda Wavelength in meters
+     * @return A vector representing the steering vector
+     *
+     * On an equally spaced grid of elements, consecutive elements differ by a constant phase
+     * rotation. The vector is then built by complex multiplication from four complex
+     * exponentials per call instead of one per element, with the phasors scaled back to unit
+     * magnitude periodically. Other layouts use the element-wise exponential.
+     */
+    Eigen::VectorXcd CalcSteeringvector(Angles angle, double lambda) const;
+
+    /**
+     * @brief Set the number of directions each cache level holds, dropping the caches.
+     * @param capacity Number of directions, 0 disables caching
+     *
+     * The vector of a direction is allocated when it is first cached, at most 2 * capacity vectors
+     * of one complex number per element.
+     */
+    void SetCacheCapacity(uint32_t capacity);
+
+    /**
+     * @brief Get the number of directions each cache level holds.
+     * @return Number of directions
+     */
+    uint32_t GetCacheCapacity() const;
+
+    /**
+     * @brief Set the grid the cached directions are anchored to, dropping the caches.
+     * @param resolution Grid step in degrees, at least 0.01, or 0 to cache the directions
+     * truncated to whole degrees
+     *
+     * A grid takes precedence over \c SeparableEvaluation, so steered IRS are interpolated on
+     * the grid as well.
+     */
+    void SetGridResolution(double resolution);
+
+    /**
+     * @brief Get the grid the cached directions are anchored to.
+     * @return Grid step in degrees, 0 if the directions are truncated to whole degrees
+     */
+    double GetGridResolution() const;
+
+    /**
+     * @brief Set whether separable reflection coefficients are evaluated in O(Nr + Nc).
+     * @param separable true to use the separable path when possible, false to always use the
+     * cache
+     *
+     * A \c GridResolution takes precedence, the separable path is only used without one.
+     */
+    void SetSeparableEvaluation(bool separable);
+
+    /**
+     * @brief Get whether separable reflection coefficients are evaluated in O(Nr + Nc).
+     * @return true if the separable path is used when possible
+     */
+    bool GetSeparableEvaluation() const;
+
+    /**
+     * @brief Check whether the reflection coefficients factor into a row and a column term.
+     * @return true if the elements form a grid and the coefficients are its outer product
+     */
+    bool IsSeparable() const;
+
+    /**
+     * @brief Set whether the uncached evaluation uses the widest vector instructions of the CPU.
+     * @param simd true for AVX2 or AVX-512 where supported, false for the scalar loop
+     */
+    void SetSimdKernel(bool simd);
+
+    /**
+     * @brief Get whether the uncached evaluation uses the widest vector instructions of the CPU.
+     * @return true if AVX2 or AVX-512 is used
+     */
+    bool GetSimdKernel() const;
+
+    /**
+     * @brief Get the number of cache lookups that hit, of both levels.
+     * @return Number of hits
+     */
+    uint64_t GetCacheHits() const;
+
+    /**
+     * @brief Get the number of cache lookups that missed, of both levels.
+     * @return Number of misses
+     */
+    uint64_t GetCacheMisses() const;
+
+    /**
+     * @brief Get the number of valid cached vectors evicted, of both levels.
+     * @return Number of evictions
+     */
+    uint64_t GetCacheEvictions() const;
 
     /**
      * @brief Calculate the phase shift for a given configuration.
@@ -180,6 +345,46 @@ class IrsSpectrumModel : public IrsModel
      */
     Eigen::Vector3d CalcWaveVector(Angles angle, double lambda) const;
 
+    /**
+     * @brief Calculate the steering vector of the element positions of this IRS into a vector.
+     * @param angle Incident or reflection angles
+     * @param lambda Wavelength in meters
+     * @param stv Set to the steering vector, reusing its memory if it has the right size
+     *
+     * Does not allocate once \c stv has the size of the IRS, see \c CalcSteeringvector.
+     */
+    void FillSteeringvector(Angles angle, double lambda, Eigen::VectorXcd& stv) const;
+
+    /**
+     * @brief Check whether the elements form an (equally spaced) grid of rows and columns.
+     *
+     * Sets \c m_gridLayout, \c m_uniformGrid and the coordinates of the rows and columns.
+     */
+    void UpdateLayout();
+
+    /**
+     * @brief Size the cached and scratch vectors to the number of elements.
+     *
+     * Allocates only if the number of elements changes, so lookups do not allocate.
+     */
+    void ResizeBuffers();
+
+    /**
+     * @brief Factor the reflection coefficients into a row and a column term, if possible.
+     *
+     * Sets \c m_separable and the factors of the separable path.
+     */
+    void FactorRcoeffs();
+
+    /**
+     * @brief Calculate an IRS entry from the factored reflection coefficients.
+     * @param in Input angles
+     * @param out Output angles
+     * @param lambda Wavelength in meters
+     * @return The IRS entry, as the product of the row and the column sum
+     */
+    IrsEntry CalcSeparableIrsEntry(Angles in, Angles out, double lambda) const;
+
     uint16_t m_Nr;
     uint16_t m_Nc;
     double m_dr;
@@ -188,60 +393,234 @@ class IrsSpectrumModel : public IrsModel
     double m_lambda;
     Eigen::VectorXcd m_rcoeffs;
     Eigen::MatrixX3d m_elementPos;
+    IrsArrayResponseKernel m_kernel; //!< Elements of the uncached evaluation
 
-    struct CacheKey
+    /// Direction of a cached steering vector, packed into fixed-point integers
+    struct DirectionKey
     {
-        Angles in;
-        Angles out;
-        double lambda;
-
-        bool operator==(const CacheKey& other) const
+        uint32_t angles; //!< Azimuth (high 16 bit) and inclination in whole degrees or grid steps
+        uint64_t lambda; //!< Wavelength in femtometers
+
+        /**
+         * @brief Compare two directions.
+         * @param other The other direction
+         * @return true if both directions share their steering vector
+         */
+        bool operator==(const DirectionKey& other) const
         {
-            constexpr double EPSILON = 1e-10;
-            const double RAD_TO_DEG = 180.0 / M_PI;
-            return static_cast<int>(in.GetAzimuth() * RAD_TO_DEG) ==
-                       static_cast<int>(other.in.GetAzimuth() * RAD_TO_DEG) &&
-                   static_cast<int>(in.GetInclination() * RAD_TO_DEG) ==
-                       static_cast<int>(other.in.GetInclination() * RAD_TO_DEG) &&
-                   static_cast<int>(out.GetAzimuth() * RAD_TO_DEG) ==
-                       static_cast<int>(other.out.GetAzimuth() * RAD_TO_DEG) &&
-                   static_cast<int>(out.GetInclination() * RAD_TO_DEG) ==
-                       static_cast<int>(other.out.GetInclination() * RAD_TO_DEG) &&
-                   std::abs(lambda - other.lambda) < EPSILON;
+            return angles == other.angles && lambda == other.lambda;
         }
     };
 
-    struct CacheKeyHash
+    /// Hash of a \c DirectionKey
+    struct DirectionKeyHash
     {
-        size_t operator()(const CacheKey& key) const
+        /**
+         * @brief Hash a direction.
+         * @param key The direction
+         * @return The hash value
+         */
+        size_t operator()(const DirectionKey& key) const
         {
-            const double RAD_TO_DEG = 180.0 / M_PI;
-            // Convert angles to integers in degrees
-            auto inAzimuthDeg = static_cast<uint16_t>(key.in.GetAzimuth() * RAD_TO_DEG);
-            auto inInclinationDeg = static_cast<uint16_t>(key.in.GetInclination() * RAD_TO_DEG);
-            auto outAzimuthDeg = static_cast<uint16_t>(key.out.GetAzimuth() * RAD_TO_DEG);
-            auto outInclinationDeg = static_cast<uint16_t>(key.out.GetInclination() * RAD_TO_DEG);
-
-            // Hash individual components
-            size_t h1 = std::hash<uint16_t>()(inAzimuthDeg);
-            size_t h2 = std::hash<uint16_t>()(inInclinationDeg);
-            size_t h3 = std::hash<uint16_t>()(outAzimuthDeg);
-            size_t h4 = std::hash<uint16_t>()(outInclinationDeg);
-            size_t h5 = std::hash<double>()(key.lambda);
-
-            // Combine hashes
-            size_t seed = h1;
-            seed ^= h2 + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-            seed ^= h3 + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-            seed ^= h4 + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-            seed ^= h5 + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-
-            return seed;
+            uint64_t h = (key.lambda ^ (static_cast<uint64_t>(key.angles) << 32)) *
+                         0x9e3779b97f4a7c15ULL;
+            return static_cast<size_t>(h ^ (h >> 29));
         }
     };
 
-    // Cache storage
-    mutable std::unordered_map<CacheKey, IrsEntry, CacheKeyHash> m_cache;
+    /**
+     * @brief Bounded cache of steering vectors with least recently used eviction.
+     *
+     * All slots are kept in one array (slab) and linked in LRU order by index. Every slot is
+     * tagged with the epoch it was filled in, \c Invalidate starts a new epoch in O(1) and the
+     * slots of older epochs are refilled in place on their next use. \c SetCapacity allocates
+     * the slots and index nodes up front and each slot allocates its vector when first filled, so
+     * a miss into a filled slot reuses its memory and does not allocate.
+     */
+    class SteeringCache
+    {
+      public:
+        SteeringCache();
+
+        /**
+         * @brief Set the number of slots, dropping all cached vectors.
+         * @param capacity Number of slots
+         * @param size Number of elements of each vector, allocated when a slot is first filled
+         */
+        void SetCapacity(uint32_t capacity, uint32_t size);
+
+        /**
+         * @brief Set the number of elements of the vectors.
+         * @param size Number of elements of each vector
+         *
+         * Resizes the vectors of filled slots if the size changes, empty slots stay empty.
+         * The cached vectors are not invalidated, see \c Invalidate.
+         */
+        void SetVectorSize(uint32_t size);
+
+        /**
+         * @brief Get the number of slots.
+         * @return Number of slots
+         */
+        uint32_t GetCapacity() const;
+
+        /**
+         * @brief Get the number of vectors of the current epoch.
+         * @return Number of valid slots
+         */
+        uint32_t GetSize() const;
+
+        /**
+         * @brief Drop all cached vectors in O(1).
+         */
+        void Invalidate();
+
+        /**
+         * @brief Look up a vector and mark it as most recently used.
+         * @param key The direction
+         * @return The vector, null on a miss
+         */
+        const Eigen::VectorXcd* Find(const DirectionKey& key);
+
+        /**
+         * @brief Get the slot for a direction that missed, to be filled by the caller.
+         * @param key The direction
+         * @param evicted Set to true if a vector of the current epoch was evicted
+         * @return The vector of the slot, holding stale data
+         */
+        Eigen::VectorXcd& Insert(const DirectionKey& key, bool& evicted);
+
+      private:
+        /// A cached vector
+        struct Slot
+        {
+            DirectionKey key;       //!< Direction of the vector
+            uint64_t epoch;         //!< Epoch the vector was computed in
+            uint32_t prev;          //!< Next more recently used slot
+            uint32_t next;          //!< Next less recently used slot
+            Eigen::VectorXcd value; //!< The vector
+        };
+
+        /**
+         * @brief Remove a slot from the LRU list.
+         * @param slot Index of the slot
+         */
+        void Unlink(uint32_t slot);
+
+        /**
+         * @brief Insert a slot at the most recently used end of the LRU list.
+         * @param slot Index of the slot
+         */
+        void PushFront(uint32_t slot);
+
+        std::vector<Slot> m_slots; //!< The slab
+        /// Slot of every key, including the slots of older epochs and of unused slots
+        std::unordered_map<DirectionKey, uint32_t, DirectionKeyHash> m_index;
+        uint32_t m_capacity;   //!< Maximum number of slots
+        uint32_t m_vectorSize; //!< Number of elements of each vector
+        uint32_t m_head;       //!< Most recently used slot
+        uint32_t m_tail;       //!< Least recently used slot
+        uint64_t m_epoch;      //!< Current epoch
+        uint32_t m_size;       //!< Number of slots filled in the current epoch
+    };
+
+    /// A grid point next to a direction, see \c GetGridCorners
+    struct GridCorner
+    {
+        DirectionKey key; //!< Cache key of the grid point
+        Angles angle;     //!< Angles of the grid point
+        double weight;    //!< Bilinear weight of the grid point
+    };
+
+    /**
+     * @brief Pack a direction into a cache key.
+     * @param azimuth Azimuth in whole degrees or grid steps
+     * @param inclination Inclination in whole degrees or grid steps
+     * @param lambda Wavelength in meters
+     * @return The cache key
+     */
+    static DirectionKey MakeKey(int32_t azimuth, int32_t inclination, double lambda);
+
+    /**
+     * @brief Get the cache key of a direction.
+     * @param angle Incident or reflection angles
+     * @param lambda Wavelength in meters
+     * @return The direction, truncated to whole degrees
+     */
+    static DirectionKey MakeKey(Angles angle, double lambda);
+
+    /**
+     * @brief Get the four grid points around a direction.
+     * @param angle Incident or reflection angles
+     * @param lambda Wavelength in meters
+     * @param corners Set to the grid points, with azimuth major order
+     */
+    void GetGridCorners(Angles angle, double lambda, GridCorner corners[4]) const;
+
+    /**
+     * @brief Calculate an IRS entry from the steering vectors of the surrounding grid points.
+     * @param in Input angles
+     * @param out Output angles
+     * @param lambda Wavelength in meters
+     * @return The IRS entry of the interpolated complex response
+     */
+    IrsEntry GetGridIrsEntry(Angles in, Angles out, double lambda) const;
+
+    /**
+     * @brief Get the steering vector of a direction from the cache, computing it on a miss.
+     * @param key The direction
+     * @param angle Incident or reflection angles of the direction
+     * @param lambda Wavelength in meters
+     * @return The steering vector, valid until the next insertion into the cache
+     */
+    const Eigen::VectorXcd& GetSteeringvector(const DirectionKey& key,
+                                              Angles angle,
+                                              double lambda) const;
+
+    /**
+     * @brief Get the steering vector of an incoming direction weighted by the reflection
+     * coefficients, from the cache or computed on a miss.
+     * @param key The direction
+     * @param angle Incident angles of the direction
+     * @param lambda Wavelength in meters
+     * @return The weighted steering vector, valid until the next insertion into the cache
+     */
+    const Eigen::VectorXcd& GetWeightedSteeringvector(const DirectionKey& key,
+                                                      Angles angle,
+                                                      double lambda) const;
+
+    /**
+     * @brief Count a cache lookup.
+     * @param hit Whether the lookup hit
+     * @param evicted Whether a miss evicted a valid vector
+     */
+    void CountLookup(bool hit, bool evicted) const;
+
+    /// Level two: steering vectors of incoming and outgoing directions
+    mutable SteeringCache m_steeringCache;
+    /// Level one: incoming steering vectors weighted by the reflection coefficients
+    mutable SteeringCache m_weightedCache;
+    uint32_t m_cacheCapacity;                    //!< Number of directions each cache level holds
+    double m_gridResolution;                     //!< Cached grid step in degrees, 0 for none
+    bool m_separableEvaluation;                  //!< Whether separable coefficients skip the cache
+    bool m_separable;                            //!< Whether the coefficients factor
+    bool m_gridLayout;                           //!< Whether the elements form a grid
+    bool m_uniformGrid;                          //!< Whether the grid is equally spaced
+    Eigen::VectorXcd m_rowCoeffs;                //!< Row term of the factored coefficients
+    Eigen::VectorXcd m_columnCoeffs;             //!< Column term of the factored coefficients
+    Eigen::VectorXd m_rowPos;                    //!< y coordinate of each row of elements
+    Eigen::VectorXd m_columnPos;                 //!< z coordinate of each column of elements
+    double m_depth;                              //!< x coordinate shared by all elements
+    double m_rowStep;                            //!< y distance between consecutive rows
+    double m_columnStep;                         //!< z distance between consecutive columns
+    mutable Eigen::VectorXcd m_uncached;         //!< Steering vector computed without the cache
+    mutable Eigen::VectorXcd m_uncachedWeighted; //!< Weighted vector computed without the cache
+    mutable Eigen::VectorXcd m_blendIn;          //!< Weighted incoming grid blend
+    mutable Eigen::VectorXcd m_blendOut;         //!< Outgoing grid blend
+
+    mutable TracedValue<uint64_t> m_cacheHits;      //!< Lookups served by a cache level
+    mutable TracedValue<uint64_t> m_cacheMisses;    //!< Lookups that computed a vector
+    mutable TracedValue<uint64_t> m_cacheEvictions; //!< Valid vectors dropped for space
 };
 
 } // namespace ns3
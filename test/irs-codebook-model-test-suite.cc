@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "ns3/angles.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/irs-codebook-model.h"
+#include "ns3/irs-lookup-model.h"
+#include "ns3/irs-lookup-table-atlas.h"
+#include "ns3/irs-lookup-table.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cstdint>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("IrsCodebookModelTest");
+
+/**
+ * @brief Create a lookup model whose table holds the same entry for all angles.
+ * @param gain Gain of all entries in dB
+ * @param phaseShift Phase shift of all entries in radians
+ * @return The lookup model
+ */
+static Ptr<IrsLookupModel>
+CreateConstantLookupModel(double gain, double phaseShift)
+{
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+    {
+        for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+        {
+            table->Insert(in, out, gain, phaseShift);
+        }
+    }
+    Ptr<IrsLookupModel> model = CreateObject<IrsLookupModel>();
+    model->SetLookupTable(table);
+    return model;
+}
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check that lookups follow the active configuration of an IrsCodebookModel.
+ */
+class IrsCodebookModelSwitchTestCase : public TestCase
+{
+  public:
+    IrsCodebookModelSwitchTestCase()
+        : TestCase("Check that an IrsCodebookModel forwards lookups to the active configuration")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsCodebookModel> codebook = CreateObject<IrsCodebookModel>();
+        NS_TEST_ASSERT_MSG_EQ(codebook->GetN(), 0u, "New codebook should be empty");
+
+        Ptr<IrsLookupModel> first = CreateConstantLookupModel(3, 0.5);
+        Ptr<IrsLookupModel> second = CreateConstantLookupModel(-7, 1.5);
+        NS_TEST_ASSERT_MSG_EQ(codebook->AddConfiguration(first), 0u, "Index of the first");
+        NS_TEST_ASSERT_MSG_EQ(codebook->AddConfiguration(second), 1u, "Index of the second");
+        NS_TEST_ASSERT_MSG_EQ(codebook->GetN(), 2u, "Codebook should hold two configurations");
+        NS_TEST_ASSERT_MSG_EQ(codebook->GetActiveConfiguration(),
+                              0u,
+                              "First configuration should be active");
+        NS_TEST_ASSERT_MSG_EQ(codebook->GetActiveModel(), first, "Active model");
+
+        Angles in(DegreesToRadians(30), DegreesToRadians(90));
+        Angles out(DegreesToRadians(120), DegreesToRadians(90));
+        NS_TEST_EXPECT_MSG_EQ_TOL(codebook->GetIrsEntry(40, 100).gain, 3, 1e-9, "Gain");
+        NS_TEST_EXPECT_MSG_EQ_TOL(codebook->GetIrsEntry(in, out, 0.06).phase_shift,
+                                  0.5,
+                                  1e-9,
+                                  "Phase shift");
+        NS_TEST_EXPECT_MSG_EQ(codebook->GetMaxGain(), 3, "Bound of the first configuration");
+
+        codebook->SetActiveConfiguration(1);
+        NS_TEST_ASSERT_MSG_EQ(codebook->GetActiveConfiguration(), 1u, "Switch to the second");
+        NS_TEST_ASSERT_MSG_EQ(codebook->GetActiveModel(), second, "Active model");
+        NS_TEST_EXPECT_MSG_EQ_TOL(codebook->GetIrsEntry(40, 100).gain, -7, 1e-9, "Gain");
+        NS_TEST_EXPECT_MSG_EQ_TOL(codebook->GetIrsEntry(in, out, 0.06).phase_shift,
+                                  1.5,
+                                  1e-9,
+                                  "Phase shift");
+        NS_TEST_EXPECT_MSG_EQ(codebook->GetMaxGain(), -7, "Bound of the second configuration");
+
+        // switching back does not touch the tables
+        const IrsEntry* entries = first->GetLookupTable()->GetEntries();
+        codebook->SetActiveConfiguration(0);
+        NS_TEST_EXPECT_MSG_EQ(first->GetLookupTable()->GetEntries(),
+                              entries,
+                              "Switching should not rebuild the table");
+        NS_TEST_EXPECT_MSG_EQ_TOL(codebook->GetIrsEntry(40, 100).gain, 3, 1e-9, "Gain");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check that an atlas configuration follows the node of its IrsCodebookModel.
+ */
+class IrsCodebookModelAtlasTestCase : public TestCase
+{
+  public:
+    IrsCodebookModelAtlasTestCase()
+        : TestCase("Check that an atlas configuration of an IrsCodebookModel follows its node")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsLookupTableAtlas> atlas = CreateObject<IrsLookupTableAtlas>();
+        atlas->AddSlice(Vector(0, 0, 0),
+                        atlas->AddTable(CreateConstantLookupModel(0, 0)->GetLookupTable()));
+        atlas->AddSlice(Vector(10, 0, 0),
+                        atlas->AddTable(CreateConstantLookupModel(20, 0)->GetLookupTable()));
+        Ptr<IrsLookupModel> model = CreateObject<IrsLookupModel>();
+        model->SetAtlas(atlas);
+
+        // the configuration itself is never aggregated to the node
+        Ptr<IrsCodebookModel> codebook = CreateObject<IrsCodebookModel>();
+        codebook->AddConfiguration(model);
+        Ptr<Node> node = CreateObject<Node>();
+        Ptr<ConstantPositionMobilityModel> mobility =
+            CreateObject<ConstantPositionMobilityModel>();
+        node->AggregateObject(mobility);
+        node->AggregateObject(codebook);
+
+        NS_TEST_EXPECT_MSG_EQ(codebook->GetIrsEntry(40, 100).gain, 0, "Slice of the origin");
+        mobility->SetPosition(Vector(9, 0, 0));
+        NS_TEST_EXPECT_MSG_EQ(codebook->GetIrsEntry(40, 100).gain, 20, "Slice after moving");
+        NS_TEST_EXPECT_MSG_EQ(codebook->GetMaxGain(), 20, "Bound after moving");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check switches scheduled with IrsCodebookModel::ScheduleSwitch.
+ */
+class IrsCodebookModelScheduleTestCase : public TestCase
+{
+  public:
+    IrsCodebookModelScheduleTestCase()
+        : TestCase("Check scheduled switches of an IrsCodebookModel")
+    {
+    }
+
+  private:
+    /**
+     * @brief Record the gain of the codebook.
+     * @param codebook The codebook
+     * @param index Where to store the gain
+     */
+    void RecordGain(Ptr<IrsCodebookModel> codebook, uint32_t index)
+    {
+        m_gains[index] = codebook->GetIrsEntry(90, 90).gain;
+    }
+
+    void DoRun() override
+    {
+        Ptr<IrsCodebookModel> codebook = CreateObject<IrsCodebookModel>();
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            codebook->AddConfiguration(CreateConstantLookupModel(i, 0));
+        }
+
+        // switch every TXOP of 2 ms, sample the gain in the middle of each
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            codebook->ScheduleSwitch(MilliSeconds(2 * i), 2 - i);
+            Simulator::Schedule(MilliSeconds(2 * i + 1),
+                                &IrsCodebookModelScheduleTestCase::RecordGain,
+                                this,
+                                codebook,
+                                i);
+        }
+        EventId cancelled = codebook->ScheduleSwitch(MilliSeconds(7), 1);
+        cancelled.Cancel();
+        Simulator::Run();
+        Simulator::Destroy();
+
+        NS_TEST_EXPECT_MSG_EQ(m_gains[0], 2, "Gain of the first TXOP");
+        NS_TEST_EXPECT_MSG_EQ(m_gains[1], 1, "Gain of the second TXOP");
+        NS_TEST_EXPECT_MSG_EQ(m_gains[2], 0, "Gain of the third TXOP");
+        NS_TEST_EXPECT_MSG_EQ(codebook->GetActiveConfiguration(),
+                              0u,
+                              "Cancelled switch should not be applied");
+    }
+
+    double m_gains[3] = {-1, -1, -1}; //!< Gain sampled in each TXOP
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief IrsCodebookModel TestSuite
+ */
+class IrsCodebookModelTestSuite : public TestSuite
+{
+  public:
+    IrsCodebookModelTestSuite();
+};
+
+IrsCodebookModelTestSuite::IrsCodebookModelTestSuite()
+    : TestSuite("irs-codebook-model", Type::UNIT)
+{
+    AddTestCase(new IrsCodebookModelSwitchTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsCodebookModelAtlasTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsCodebookModelScheduleTestCase, TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static IrsCodebookModelTestSuite g_irsCodebookModelTestSuite;
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "ns3/example-as-test.h"
+
+using namespace ns3;
+
+/**
+ * @ingroup irs-tests
+ *
+ * The allocation check replaces the allocation functions of its process, so it runs as an
+ * example of its own instead of a test case of the test-runner.
+ */
+static ExampleAsTestSuite g_irsAllocationCheck("irs-allocation-check",
+                                               "irs-allocation-check",
+                                               NS_TEST_SOURCEDIR);
@@ -0,0 +1,995 @@
+/*
+ * Copyright (c) 2024 Jakob Rühlow
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Author: Jakob Rühlow <ruehlow@tu-berlin.de>
+ *
+ */
+
+#include "ns3/angles.h"
+#include "ns3/irs-lookup-table-4d.h"
+#include "ns3/irs-lookup-table-atlas.h"
+#include "ns3/irs-lookup-table-io.h"
+#include "ns3/irs-lookup-table-registry.h"
+#include "ns3/irs-lookup-model.h"
+#include "ns3/irs-lookup-table.h"
+#include "ns3/irs-multi-frequency-lookup-table.h"
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("IrsLookupTableTest");
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Write a lookup table in binary format, map it again and compare all entries.
+ */
+class IrsLookupTableBinaryTestCase : public TestCase
+{
+  public:
+    IrsLookupTableBinaryTestCase()
+        : TestCase("Check that binary lookup tables round trip through IrsLookupTableIo")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+        table->SetFrequency(5.21e9);
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                // leave a few entries out, like the destructive tables do
+                if ((in + out) % 97 != 0)
+                {
+                    table->Insert(in, out, std::sin(in) * 40, std::cos(out) * M_PI);
+                }
+            }
+        }
+
+        std::string filename = CreateTempDirFilename("irs-lookup-table.irslut");
+        IrsLookupTableIo::WriteBinary(table, filename);
+        NS_TEST_ASSERT_MSG_EQ(IrsLookupTableIo::IsBinary(filename),
+                              true,
+                              "Binary table not detected");
+
+        Ptr<IrsLookupTable> mapped = IrsLookupTableIo::Read(filename);
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetFrequency(), 5.21e9, "Frequency not stored");
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                if ((in + out) % 97 != 0)
+                {
+                    IrsEntry expected = table->GetIrsEntry(in, out);
+                    IrsEntry entry = mapped->GetIrsEntry(in, out);
+                    NS_TEST_EXPECT_MSG_EQ(entry.gain, expected.gain, "Unexpected gain");
+                    NS_TEST_EXPECT_MSG_EQ(entry.phase_shift,
+                                          expected.phase_shift,
+                                          "Unexpected phase shift");
+                }
+            }
+        }
+
+        // modifying a mapped table works on a private copy
+        mapped->Insert(0, 0, 1.0, 2.0);
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetIrsEntry(0, 0).gain, 1.0, "Insert into mapped table");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetIrsEntry(1, 1).gain,
+                              table->GetIrsEntry(1, 1).gain,
+                              "Copy of mapped table");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check that the registry shares tables, reloads changed files and bounds its memory.
+ */
+class IrsLookupTableRegistryTestCase : public TestCase
+{
+  public:
+    IrsLookupTableRegistryTestCase()
+        : TestCase("Check sharing, reloading and eviction of the IrsLookupTableRegistry")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+        table->Insert(10, 20, -3.0, 1.0);
+        std::string first = CreateTempDirFilename("irs-registry-1.irslut");
+        std::string second = CreateTempDirFilename("irs-registry-2.irslut");
+        IrsLookupTableIo::WriteBinary(table, first);
+        IrsLookupTableIo::WriteBinary(table, second);
+
+        Ptr<IrsLookupTableRegistry> registry = CreateObject<IrsLookupTableRegistry>();
+        registry->SetMaxMemory(16 * table->GetMemoryUsage());
+        Ptr<IrsLookupTable> a = registry->GetLookupTable(first);
+        Ptr<IrsLookupTable> b = registry->GetLookupTable(first);
+        NS_TEST_EXPECT_MSG_EQ(a, b, "Same file not shared");
+        NS_TEST_EXPECT_MSG_EQ(a->IsReadOnly(), true, "Shared table not read-only");
+        NS_TEST_EXPECT_MSG_EQ(registry->GetN(), 1U, "Unexpected number of tables");
+
+        // a changed file is loaded again
+        table->Insert(10, 20, -6.0, 1.0);
+        IrsLookupTableIo::WriteBinary(table, first);
+        std::filesystem::last_write_time(first,
+                                         std::filesystem::last_write_time(first) +
+                                             std::chrono::seconds(1));
+        Ptr<IrsLookupTable> c = registry->GetLookupTable(first);
+        NS_TEST_EXPECT_MSG_NE(a, c, "Changed file not reloaded");
+        NS_TEST_EXPECT_MSG_EQ(c->GetIrsEntry(10, 20).gain, -6.0, "Stale table");
+        NS_TEST_EXPECT_MSG_EQ(a->GetIrsEntry(10, 20).gain, -3.0, "Old table modified");
+
+        // only room for one table, the unreferenced one is dropped first
+        a = nullptr;
+        b = nullptr;
+        registry->SetMaxMemory(table->GetMemoryUsage());
+        NS_TEST_EXPECT_MSG_EQ(registry->GetN(), 1U, "Memory bound not enforced");
+        NS_TEST_EXPECT_MSG_EQ(registry->GetLookupTable(first), c, "Referenced table dropped");
+        Ptr<IrsLookupTable> d = registry->GetLookupTable(second);
+        NS_TEST_EXPECT_MSG_EQ(registry->GetN(), 1U, "Memory bound not enforced");
+        NS_TEST_EXPECT_MSG_EQ(registry->GetMemoryUsage(),
+                              table->GetMemoryUsage(),
+                              "Unexpected memory usage");
+        NS_TEST_EXPECT_MSG_EQ(c->GetIrsEntry(10, 20).gain, -6.0, "Evicted table destroyed");
+
+        // disabled registry does not share
+        registry->SetMaxMemory(0);
+        NS_TEST_EXPECT_MSG_EQ(registry->GetN(), 0U, "Registry not emptied");
+        NS_TEST_EXPECT_MSG_NE(registry->GetLookupTable(second),
+                              registry->GetLookupTable(second),
+                              "Disabled registry shares tables");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the lookup tables embedded in the library, without any file access.
+ */
+class IrsLookupTableEmbeddedTestCase : public TestCase
+{
+  public:
+    IrsLookupTableEmbeddedTestCase()
+        : TestCase("Check lookup tables embedded in the library")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        std::string constructive = "IRS_400_IN135_OUT89_FREQ5.15GHz_constructive";
+        std::string destructive = "IRS_400_IN110_OUT69_FREQ5.21GHz_destructive";
+        std::vector<std::string> names = IrsLookupTableIo::GetEmbeddedNames();
+        NS_TEST_ASSERT_MSG_NE(std::count(names.begin(), names.end(), constructive),
+                              0,
+                              "Validation table not embedded");
+        NS_TEST_ASSERT_MSG_NE(std::count(names.begin(), names.end(), destructive),
+                              0,
+                              "Test table not embedded");
+        NS_TEST_EXPECT_MSG_EQ(IrsLookupTableIo::GetEmbeddedName("contrib/irs/examples/"
+                                                                "lookuptables/validation/" +
+                                                                constructive + ".csv"),
+                              constructive,
+                              "Directory and extension not ignored");
+        NS_TEST_EXPECT_MSG_EQ(IrsLookupTableIo::GetEmbeddedName("IRS_unknown"),
+                              "",
+                              "Unknown table found");
+
+        const IrsEmbeddedLookupTable* embedded = g_irsEmbeddedLookupTables;
+        while (embedded->name != constructive)
+        {
+            ++embedded;
+        }
+
+        // a complete table in grid order is used in place
+        Ptr<IrsLookupTable> table = IrsLookupTableIo::ReadEmbedded(constructive);
+        NS_TEST_ASSERT_MSG_EQ(table->GetNumAngles(), 181U, "Unexpected resolution");
+        NS_TEST_EXPECT_MSG_EQ(table->GetEntries(), embedded->entries, "Embedded data copied");
+        NS_TEST_EXPECT_MSG_EQ(table->GetFrequency(), 5.15e9, "Frequency not taken from name");
+        for (uint32_t i = 0; i < embedded->numRows; i += 97)
+        {
+            auto in = static_cast<uint8_t>(embedded->angles[i][0]);
+            auto out = static_cast<uint8_t>(embedded->angles[i][1]);
+            NS_TEST_EXPECT_MSG_EQ(table->GetIrsEntry(in, out).gain,
+                                  embedded->entries[i].gain,
+                                  "Gain of row " << i);
+            NS_TEST_EXPECT_MSG_EQ(table->GetIrsEntry(in, out).phase_shift,
+                                  embedded->entries[i].phase_shift,
+                                  "Phase shift of row " << i);
+        }
+
+        // the destructive table lacks the 0 and 180 degree rows, it is inserted instead
+        Ptr<IrsLookupTable> partial = IrsLookupTableIo::ReadEmbedded(destructive + ".csv");
+        NS_TEST_ASSERT_MSG_EQ(partial->GetNumAngles(), 181U, "Unexpected resolution");
+        NS_TEST_EXPECT_MSG_NE(partial->GetEntries(), embedded->entries, "Partial table in place");
+        NS_TEST_EXPECT_MSG_EQ(partial->GetFrequency(), 5.21e9, "Frequency not taken from name");
+        NS_TEST_EXPECT_MSG_EQ(std::isnan(partial->GetEntries()[0].gain),
+                              true,
+                              "Missing entry present");
+        NS_TEST_EXPECT_MSG_EQ_TOL(partial->GetIrsEntry(1, 1).gain,
+                                  37.427869939829,
+                                  1e-12,
+                                  "First row of the table");
+
+        // the registry shares embedded tables under any spelling of their name
+        Ptr<IrsLookupTableRegistry> registry = CreateObject<IrsLookupTableRegistry>();
+        registry->SetMaxMemory(16 * table->GetMemoryUsage());
+        Ptr<IrsLookupTable> a = registry->GetEmbeddedLookupTable(constructive);
+        Ptr<IrsLookupTable> b = registry->GetEmbeddedLookupTable(constructive + ".csv");
+        NS_TEST_EXPECT_MSG_EQ(a, b, "Same table not shared");
+        NS_TEST_EXPECT_MSG_EQ(a->IsReadOnly(), true, "Shared table not read-only");
+        Ptr<IrsLookupTable> quantized =
+            registry->GetEmbeddedLookupTable(constructive, IrsLookupTable::QUANTIZED);
+        NS_TEST_EXPECT_MSG_NE(a, quantized, "Storage modes not held separately");
+        NS_TEST_EXPECT_MSG_EQ(quantized->GetStorageMode(),
+                              IrsLookupTable::QUANTIZED,
+                              "Table not converted");
+        NS_TEST_EXPECT_MSG_EQ(registry->GetN(), 2U, "Unexpected number of tables");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check sub-degree tables, nearest and interpolated lookups and the resolution in files.
+ */
+class IrsLookupTableInterpolationTestCase : public TestCase
+{
+  public:
+    IrsLookupTableInterpolationTestCase()
+        : TestCase("Check sub-degree lookup tables and bilinear interpolation")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+        table->SetResolution(0.5);
+        NS_TEST_ASSERT_MSG_EQ(table->GetNumAngles(), 361U, "Unexpected grid size");
+        // corners on both sides of the phase wrap
+        table->InsertAt(10, 10, 0, M_PI - 0.1);
+        table->InsertAt(10, 10.5, 10, -M_PI + 0.1);
+        table->InsertAt(10.5, 10, 20, M_PI - 0.1);
+        table->InsertAt(10.5, 10.5, 30, -M_PI + 0.1);
+
+        NS_TEST_EXPECT_MSG_EQ(table->GetIrsEntry(10, 10).gain, 0, "Whole degree lookup");
+        NS_TEST_EXPECT_MSG_EQ(table->GetNearestIrsEntry(10.2, 10.3).gain,
+                              10,
+                              "Nearest grid point");
+
+        IrsEntry center = table->GetInterpolatedIrsEntry(10.25, 10.25);
+        NS_TEST_EXPECT_MSG_EQ_TOL(center.gain, 15, 1e-9, "Interpolated gain");
+        NS_TEST_EXPECT_MSG_EQ_TOL(std::cos(center.phase_shift),
+                                  -1,
+                                  1e-9,
+                                  "Phase not interpolated across the wrap");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(std::abs(center.phase_shift), M_PI, "Phase not wrapped");
+        // weight 0.2 at pi - 0.1 and 0.8 at pi + 0.1, wrapped
+        NS_TEST_EXPECT_MSG_EQ_TOL(table->GetInterpolatedIrsEntry(10.4, 10.4).phase_shift,
+                                  -M_PI + 0.06,
+                                  1e-9,
+                                  "Blended phase");
+
+        // blending across the wrap stays in [-pi, pi]
+        IrsEntry blended = BlendIrsEntries({0, 3}, {10, -3}, 0.9);
+        NS_TEST_EXPECT_MSG_EQ_TOL(blended.gain, 9, 1e-12, "Blended gain");
+        NS_TEST_EXPECT_MSG_EQ_TOL(blended.phase_shift,
+                                  3 + 0.9 * (2 * M_PI - 6) - 2 * M_PI,
+                                  1e-12,
+                                  "Blended phase not wrapped");
+        NS_TEST_EXPECT_MSG_EQ_TOL(table->GetInterpolatedIrsEntry(10, 10.5).gain,
+                                  10,
+                                  1e-9,
+                                  "Interpolation on a grid point");
+        // the corners at 11 degrees are missing and left out
+        NS_TEST_EXPECT_MSG_EQ_TOL(table->GetInterpolatedIrsEntry(10.25, 10.75).gain,
+                                  20,
+                                  1e-9,
+                                  "Missing corners not skipped");
+
+        // the resolution is inferred from csv files and kept in binary files
+        std::string csv = CreateTempDirFilename("irs-lookup-table-0.25.csv");
+        {
+            std::ofstream file(csv);
+            file << "in_angle,out_angle,gain_dB,phase_shift\n"
+                 << "90,90,1,0.5\n"
+                 << "90.25,90,2,0.5\n"
+                 << "90.5,90.75,3,0.5\n";
+        }
+        Ptr<IrsLookupTable> read = IrsLookupTableIo::ReadCsv(csv);
+        NS_TEST_EXPECT_MSG_EQ(read->GetResolution(), 0.25, "Resolution not inferred");
+        NS_TEST_EXPECT_MSG_EQ(read->GetNearestIrsEntry(90.5, 90.75).gain, 3, "Csv entry");
+
+        std::string binary = CreateTempDirFilename("irs-lookup-table-0.25.irslut");
+        IrsLookupTableIo::WriteBinary(read, binary);
+        Ptr<IrsLookupTable> mapped = IrsLookupTableIo::Read(binary);
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetResolution(), 0.25, "Resolution not stored");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetNearestIrsEntry(90.25, 90).gain, 2, "Binary entry");
+
+        // writing csv keeps the grid and leaves out missing entries
+        std::string written = CreateTempDirFilename("irs-lookup-table-0.25-written.csv");
+        IrsLookupTableIo::WriteCsv(mapped, written);
+        Ptr<IrsLookupTable> reread = IrsLookupTableIo::ReadCsv(written);
+        NS_TEST_EXPECT_MSG_EQ(reread->GetResolution(), 0.25, "Resolution not written");
+        NS_TEST_EXPECT_MSG_EQ(reread->GetNearestIrsEntry(90.5, 90.75).gain, 3, "Csv entry");
+        NS_TEST_EXPECT_MSG_EQ(reread->GetNearestIrsEntry(90.5, 90.75).phase_shift,
+                              0.5,
+                              "Csv phase shift");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check lookups, quantization and file formats of the 4D lookup table.
+ */
+class IrsLookupTable4DTestCase : public TestCase
+{
+  public:
+    IrsLookupTable4DTestCase()
+        : TestCase("Check the elevation-aware 4D lookup table")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsLookupTable4D> table = CreateObject<IrsLookupTable4D>();
+        table->SetAzimuthResolution(30);
+        table->SetInclinationResolution(30);
+        NS_TEST_ASSERT_MSG_EQ(table->GetNumDirections(), 48U, "Unexpected grid size");
+
+        auto gain = [](double inAz, double inIncl, double outAz, double outIncl) {
+            return inAz / 10 + inIncl - outAz / 7 - outIncl / 3;
+        };
+        auto phase = [](double inAz, double inIncl, double outAz, double outIncl) {
+            return DegreesToRadians(inAz + outAz) + DegreesToRadians(inIncl - outIncl);
+        };
+        for (double inAz = -180; inAz < 180; inAz += 30)
+        {
+            for (double inIncl = 0; inIncl <= 90; inIncl += 30)
+            {
+                for (double outAz = -180; outAz < 180; outAz += 30)
+                {
+                    for (double outIncl = 0; outIncl <= 90; outIncl += 30)
+                    {
+                        table->Insert(inAz,
+                                      inIncl,
+                                      outAz,
+                                      outIncl,
+                                      gain(inAz, inIncl, outAz, outIncl),
+                                      phase(inAz, inIncl, outAz, outIncl));
+                    }
+                }
+            }
+        }
+        NS_TEST_EXPECT_MSG_EQ(table->GetMemoryUsage(),
+                              48 * 48 * sizeof(IrsQuantizedEntry),
+                              "Unexpected memory usage");
+
+        // nearest grid point, azimuth wraps around and inclination behind the IRS is clamped
+        IrsEntry entry = table->GetIrsEntry(Angles(DegreesToRadians(62), DegreesToRadians(28)),
+                                            Angles(DegreesToRadians(179), DegreesToRadians(95)));
+        NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain,
+                                  gain(60, 30, -180, 90),
+                                  IrsQuantizedEntry::GAIN_STEP / 2,
+                                  "Unexpected gain");
+        NS_TEST_EXPECT_MSG_EQ_TOL(std::cos(entry.phase_shift),
+                                  std::cos(phase(60, 30, -180, 90)),
+                                  1e-4,
+                                  "Unexpected phase shift");
+
+        std::string binary = CreateTempDirFilename("irs-lookup-table-4d.irslut");
+        IrsLookupTableIo::WriteBinary4D(table, binary);
+        NS_TEST_EXPECT_MSG_EQ(IrsLookupTableIo::IsBinary(binary), false, "Detected as 2D table");
+        Ptr<IrsLookupTable4D> mapped = IrsLookupTableIo::Read4D(binary);
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetAzimuthResolution(), 30, "Resolution not stored");
+        IrsEntry mappedEntry =
+            mapped->GetIrsEntry(Angles(DegreesToRadians(62), DegreesToRadians(28)),
+                                Angles(DegreesToRadians(179), DegreesToRadians(95)));
+        NS_TEST_EXPECT_MSG_EQ(mappedEntry.gain, entry.gain, "Binary gain");
+        NS_TEST_EXPECT_MSG_EQ(mappedEntry.phase_shift, entry.phase_shift, "Binary phase shift");
+
+        std::string csv = CreateTempDirFilename("irs-lookup-table-4d.csv");
+        {
+            std::ofstream file(csv);
+            file << "in_azimuth,in_inclination,out_azimuth,out_inclination,gain_dB,phase_shift\n"
+                 << "-90,45,90,0,12.5,1\n"
+                 << "0,0,45,45,-3,-1\n";
+        }
+        NS_TEST_EXPECT_MSG_EQ(IrsLookupTableIo::IsCsv4D(csv), true, "4D csv not detected");
+        Ptr<IrsLookupTable4D> read = IrsLookupTableIo::ReadCsv4D(csv);
+        NS_TEST_EXPECT_MSG_EQ(read->GetAzimuthResolution(), 45, "Azimuth resolution");
+        NS_TEST_EXPECT_MSG_EQ(read->GetInclinationResolution(), 45, "Inclination resolution");
+        NS_TEST_EXPECT_MSG_EQ_TOL(read->GetIrsEntry(Angles(DegreesToRadians(-90),
+                                                           DegreesToRadians(45)),
+                                                    Angles(DegreesToRadians(90), 0))
+                                      .gain,
+                                  12.5,
+                                  IrsQuantizedEntry::GAIN_STEP / 2,
+                                  "Csv entry");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check frequency interpolation of the multi-frequency lookup table.
+ */
+class IrsMultiFrequencyLookupTableTestCase : public TestCase
+{
+  public:
+    IrsMultiFrequencyLookupTableTestCase()
+        : TestCase("Check interpolation between the slices of a multi-frequency lookup table")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        auto slice = [](double frequency, double gain, double phase) {
+            Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+            table->SetFrequency(frequency);
+            table->Insert(45, 60, gain, phase);
+            table->Insert(45, 61, gain + 1, phase);
+            return table;
+        };
+        Ptr<IrsMultiFrequencyLookupTable> table = CreateObject<IrsMultiFrequencyLookupTable>();
+        // added out of order, on both sides of the phase wrap
+        table->AddSlice(slice(6e9, 20, -M_PI + 0.2));
+        table->AddSlice(slice(5e9, 10, M_PI - 0.2));
+        NS_TEST_ASSERT_MSG_EQ(table->GetN(), 2U, "Unexpected number of slices");
+        NS_TEST_EXPECT_MSG_EQ(table->GetSlice(0)->GetFrequency(), 5e9, "Slices not ordered");
+
+        IrsEntry mid = table->GetIrsEntry(45, 60, 5.5e9, false);
+        NS_TEST_EXPECT_MSG_EQ_TOL(mid.gain, 15, 1e-9, "Gain not interpolated");
+        NS_TEST_EXPECT_MSG_EQ_TOL(std::cos(mid.phase_shift),
+                                  -1,
+                                  1e-9,
+                                  "Phase not interpolated across the wrap");
+        NS_TEST_EXPECT_MSG_EQ(table->GetIrsEntry(45, 60, 1e9, false).gain,
+                              10,
+                              "Not clamped to the lowest slice");
+        NS_TEST_EXPECT_MSG_EQ(table->GetIrsEntry(45, 60, 7e9, false).gain,
+                              20,
+                              "Not clamped to the highest slice");
+        NS_TEST_EXPECT_MSG_EQ_TOL(table->GetIrsEntry(45, 60.5, 5.25e9, true).gain,
+                                  13,
+                                  1e-9,
+                                  "Angle and frequency interpolation");
+
+        // the wavelength selects the slices of the model
+        Ptr<IrsLookupModel> model = CreateObject<IrsLookupModel>();
+        model->SetMultiFrequencyLookupTable(table);
+        NS_TEST_EXPECT_MSG_EQ_TOL(model->LookupIrsEntry(45, 60, 299792458.0 / 5.75e9).gain,
+                                  17.5,
+                                  1e-9,
+                                  "Wavelength not used");
+        NS_TEST_EXPECT_MSG_EQ(table->GetIrsEntry(45, 60, 6e9, false).gain,
+                              20,
+                              "Slice not used at its frequency");
+
+        // lookups without a wavelength use the model frequency, also with a 2D table set
+        model->SetLookupTable(slice(1e9, -50, 0));
+        model->SetFrequency(5.5e9);
+        NS_TEST_EXPECT_MSG_EQ_TOL(model->GetIrsEntry(45, 60).gain,
+                                  15,
+                                  1e-9,
+                                  "Model frequency not used");
+        NS_TEST_EXPECT_MSG_EQ_TOL(model->LookupIrsEntry(45, 60).gain,
+                                  15,
+                                  1e-9,
+                                  "Dispatch differs from the uint8 lookup");
+        NS_TEST_EXPECT_MSG_EQ(model->GetMaxGain(), 21, "Bound not over the slices");
+
+        NS_TEST_EXPECT_MSG_EQ(
+            IrsLookupTableIo::FrequencyFromFilename("tables/IRS_400_IN135_OUT6_FREQ5.21GHz.csv"),
+            5.21e9,
+            "Frequency not parsed from the file name");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the error bounds and file round trip of quantized lookup tables.
+ */
+class IrsLookupTableQuantizedTestCase : public TestCase
+{
+  public:
+    IrsLookupTableQuantizedTestCase()
+        : TestCase("Check quantized storage of lookup tables")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsLookupTable> dense = CreateObject<IrsLookupTable>();
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                dense->Insert(in, out, std::sin(in * 0.37) * 60, std::cos(out * 0.53) * 4);
+            }
+        }
+        Ptr<IrsLookupTable> quantized = dense->Convert(IrsLookupTable::QUANTIZED);
+        NS_TEST_ASSERT_MSG_EQ(quantized->GetStorageMode(),
+                              IrsLookupTable::QUANTIZED,
+                              "Table not converted");
+        NS_TEST_EXPECT_MSG_EQ(4 * quantized->GetMemoryUsage(),
+                              dense->GetMemoryUsage(),
+                              "Unexpected memory usage");
+
+        double maxGainError = 0;
+        double maxPhaseError = 0;
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                IrsEntry expected = dense->GetIrsEntry(in, out);
+                IrsEntry entry = quantized->GetIrsEntry(in, out);
+                maxGainError = std::max(maxGainError, std::abs(entry.gain - expected.gain));
+                maxPhaseError =
+                    std::max(maxPhaseError,
+                             std::abs(std::remainder(entry.phase_shift - expected.phase_shift,
+                                                     2 * M_PI)));
+            }
+        }
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(maxGainError,
+                                    IrsQuantizedEntry::GAIN_STEP / 2 + 1e-12,
+                                    "Gain error above the documented bound");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(maxPhaseError,
+                                    M_PI / 65536 + 1e-12,
+                                    "Phase error above the documented bound");
+
+        // quantized tables are written and mapped without conversion
+        std::string filename = CreateTempDirFilename("irs-lookup-table-quantized.irslut");
+        IrsLookupTableIo::WriteBinary(quantized, filename);
+        Ptr<IrsLookupTable> mapped = IrsLookupTableIo::Read(filename);
+        NS_TEST_ASSERT_MSG_EQ(mapped->GetStorageMode(),
+                              IrsLookupTable::QUANTIZED,
+                              "Storage mode not stored");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetIrsEntry(17, 93).gain,
+                              quantized->GetIrsEntry(17, 93).gain,
+                              "Mapped entry");
+        NS_TEST_EXPECT_MSG_EQ_TOL(mapped->GetInterpolatedIrsEntry(17.5, 93).gain,
+                                  dense->GetInterpolatedIrsEntry(17.5, 93).gain,
+                                  IrsQuantizedEntry::GAIN_STEP / 2,
+                                  "Interpolated entry");
+
+        // insert into a quantized table, the mapped file stays untouched
+        mapped->Insert(17, 93, -12.345, 1.0);
+        NS_TEST_EXPECT_MSG_EQ_TOL(mapped->GetIrsEntry(17, 93).gain,
+                                  -12.345,
+                                  IrsQuantizedEntry::GAIN_STEP / 2,
+                                  "Insert into quantized table");
+
+        // the registry converts file tables on request
+        std::string denseFilename = CreateTempDirFilename("irs-lookup-table-dense.irslut");
+        IrsLookupTableIo::WriteBinary(dense, denseFilename);
+        Ptr<IrsLookupTableRegistry> registry = CreateObject<IrsLookupTableRegistry>();
+        registry->SetMaxMemory(16 * dense->GetMemoryUsage());
+        Ptr<IrsLookupTable> shared =
+            registry->GetLookupTable(denseFilename, IrsLookupTable::QUANTIZED);
+        NS_TEST_EXPECT_MSG_EQ(shared->GetStorageMode(),
+                              IrsLookupTable::QUANTIZED,
+                              "Registry did not convert the table");
+        NS_TEST_EXPECT_MSG_EQ(shared->IsReadOnly(), true, "Converted table not read-only");
+        NS_TEST_EXPECT_MSG_EQ(registry->GetLookupTable(denseFilename)->GetStorageMode(),
+                              IrsLookupTable::DENSE,
+                              "Storage modes not held separately");
+        NS_TEST_EXPECT_MSG_EQ(registry->GetN(), 2U, "Unexpected number of tables");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the rank selection, accuracy and file round trip of low-rank lookup tables.
+ */
+class IrsLookupTableLowRankTestCase : public TestCase
+{
+  public:
+    IrsLookupTableLowRankTestCase()
+        : TestCase("Check low-rank storage of lookup tables")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        // complex response of rank two
+        Ptr<IrsLookupTable> dense = CreateObject<IrsLookupTable>();
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                std::complex<double> h = std::polar(2 + std::sin(in * 0.05), in * 0.1) *
+                                             std::polar(1.5, out * -0.07) +
+                                         std::polar(0.5, in * 0.02) * std::cos(out * 0.03);
+                dense->Insert(in, out, 20 * std::log10(std::abs(h)), std::arg(h));
+            }
+        }
+
+        dense->SetTolerance(1e-6);
+        Ptr<IrsLookupTable> lowRank = dense->Convert(IrsLookupTable::LOW_RANK);
+        NS_TEST_ASSERT_MSG_EQ(lowRank->GetStorageMode(),
+                              IrsLookupTable::LOW_RANK,
+                              "Table not converted");
+        NS_TEST_EXPECT_MSG_EQ(lowRank->GetFactorRank(), 2U, "Rank not chosen by the tolerance");
+        NS_TEST_EXPECT_MSG_LT(lowRank->GetMemoryUsage(),
+                              dense->GetMemoryUsage() / 40,
+                              "Low-rank table not smaller");
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; in += 7)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; out += 5)
+            {
+                IrsEntry expected = dense->GetIrsEntry(in, out);
+                IrsEntry entry = lowRank->GetIrsEntry(in, out);
+                NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain, expected.gain, 1e-3, "Unexpected gain");
+                NS_TEST_EXPECT_MSG_EQ_TOL(
+                    std::remainder(entry.phase_shift - expected.phase_shift, 2 * M_PI),
+                    0,
+                    1e-4,
+                    "Unexpected phase shift");
+            }
+        }
+
+        // entries that were never inserted stay missing
+        Ptr<IrsLookupTable> single = CreateObject<IrsLookupTable>();
+        single->Insert(10, 20, -3.0, 1.0);
+        single->SetStorageMode(IrsLookupTable::LOW_RANK);
+        NS_TEST_EXPECT_MSG_EQ(single->GetFactorRank(), 1U, "Unexpected rank");
+        NS_TEST_EXPECT_MSG_EQ_TOL(single->GetIrsEntry(10, 20).gain, -3.0, 1e-4, "Single entry");
+        Ptr<IrsLookupTable> decoded = single->Convert(IrsLookupTable::DENSE);
+        NS_TEST_EXPECT_MSG_EQ(
+            std::isnan(decoded->GetEntries()[10 * IrsLookupTable::N_ANGLES + 21].gain),
+            true,
+            "Missing entry not kept");
+
+        dense->SetRank(1);
+        NS_TEST_EXPECT_MSG_EQ(dense->Convert(IrsLookupTable::LOW_RANK)->GetFactorRank(),
+                              1U,
+                              "Rank not fixed by the attribute");
+
+        std::string filename = CreateTempDirFilename("irs-lookup-table-low-rank.irslut");
+        IrsLookupTableIo::WriteBinary(lowRank, filename);
+        Ptr<IrsLookupTable> mapped = IrsLookupTableIo::Read(filename);
+        NS_TEST_ASSERT_MSG_EQ(mapped->GetStorageMode(),
+                              IrsLookupTable::LOW_RANK,
+                              "Storage mode not stored");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetFactorRank(), 2U, "Rank not stored");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetIrsEntry(100, 42).gain,
+                              lowRank->GetIrsEntry(100, 42).gain,
+                              "Mapped entry");
+        NS_TEST_EXPECT_MSG_EQ_TOL(mapped->GetInterpolatedIrsEntry(100.5, 42.5).gain,
+                                  dense->GetInterpolatedIrsEntry(100.5, 42.5).gain,
+                                  1e-3,
+                                  "Interpolated entry");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Test the sparse storage mode of IrsLookupTable
+ */
+class IrsLookupTableSparseTestCase : public TestCase
+{
+  public:
+    IrsLookupTableSparseTestCase()
+        : TestCase("Check sparse storage of lookup tables")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        // a beam of 40 dB around (60, 120) falling off by 1 dB per degree
+        Ptr<IrsLookupTable> dense = CreateObject<IrsLookupTable>();
+        uint32_t expected = 0;
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                double gain = 40 - std::abs(in - 60) - std::abs(out - 120);
+                dense->Insert(in, out, gain, 0.01 * out);
+                expected += gain >= 40 - 25;
+            }
+        }
+
+        dense->SetSparseThreshold(25);
+        dense->SetFloorGain(-80);
+        Ptr<IrsLookupTable> sparse = dense->Convert(IrsLookupTable::SPARSE);
+        NS_TEST_ASSERT_MSG_EQ(sparse->GetStorageMode(),
+                              IrsLookupTable::SPARSE,
+                              "Table not converted");
+        NS_TEST_EXPECT_MSG_EQ(sparse->GetNumSparseEntries(), expected, "Unexpected entry count");
+        NS_TEST_EXPECT_MSG_LT(sparse->GetMemoryUsage(),
+                              dense->GetMemoryUsage() / 15,
+                              "Sparse table not smaller");
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; in += 3)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                IrsEntry entry = sparse->GetIrsEntry(in, out);
+                IrsEntry stored = dense->GetIrsEntry(in, out);
+                bool kept = stored.gain >= 15;
+                NS_TEST_EXPECT_MSG_EQ(entry.gain, kept ? stored.gain : -80, "Unexpected gain");
+                NS_TEST_EXPECT_MSG_EQ(entry.phase_shift,
+                                      kept ? stored.phase_shift : 0,
+                                      "Unexpected phase shift");
+            }
+        }
+        sparse->SetFloorGain(-90);
+        NS_TEST_EXPECT_MSG_EQ(sparse->GetNearestIrsEntry(0.2, 0.4).gain, -90, "Floor not set");
+
+        // an empty table stores nothing
+        Ptr<IrsLookupTable> empty = CreateObject<IrsLookupTable>();
+        empty->SetStorageMode(IrsLookupTable::SPARSE);
+        NS_TEST_EXPECT_MSG_EQ(empty->GetNumSparseEntries(), 0U, "Entries in empty table");
+        NS_TEST_EXPECT_MSG_EQ(empty->GetIrsEntry(90, 90).gain, -100, "Default floor gain");
+
+        std::string filename = CreateTempDirFilename("irs-lookup-table-sparse.irslut");
+        IrsLookupTableIo::WriteBinary(sparse, filename);
+        Ptr<IrsLookupTable> mapped = IrsLookupTableIo::Read(filename);
+        NS_TEST_ASSERT_MSG_EQ(mapped->GetStorageMode(),
+                              IrsLookupTable::SPARSE,
+                              "Storage mode not stored");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetNumSparseEntries(), expected, "Entries not stored");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetFloorGain(), -90, "Floor gain not stored");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetIrsEntry(60, 120).gain, 40, "Mapped entry");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetIrsEntry(180, 0).gain, -90, "Mapped floor");
+        Ptr<IrsLookupTable> decoded = mapped->Convert(IrsLookupTable::DENSE);
+        NS_TEST_EXPECT_MSG_EQ(decoded->GetIrsEntry(70, 125).gain, 25, "Decoded entry");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Test the gain bounds of IrsLookupTable
+ */
+class IrsLookupTableGainBoundsTestCase : public TestCase
+{
+  public:
+    IrsLookupTableGainBoundsTestCase()
+        : TestCase("Check the gain bounds of lookup tables")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(),
+                              -std::numeric_limits<double>::infinity(),
+                              "Bound of an empty table");
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                table->Insert(in, out, -0.5 * in - 0.25 * out, 0);
+            }
+        }
+        table->Insert(95, 33, 12.5, 0);
+
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(), 12.5, "Table bound");
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(95), 12.5, "Row bound");
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(94.5), 12.5, "Row bound between rows");
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(10), -5, "Row bound");
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(95.2, 33.7), 12.5, "Sector bound");
+        // sectors of 10 degrees, the bound is the corner of lowest angles
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(125, 145), -0.5 * 120 - 0.25 * 140, "Sector");
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(129.5, 145),
+                              -0.5 * 120 - 0.25 * 140,
+                              "Sector bound within a sector");
+        NS_TEST_EXPECT_MSG_EQ(table->GetMaxGain(129.5, 139.5),
+                              -0.5 * 120 - 0.25 * 130,
+                              "Sector bound across sectors");
+
+        // every lookup stays within the bounds
+        for (double in = 0; in <= 180; in += 3.7)
+        {
+            for (double out = 0; out <= 180; out += 2.9)
+            {
+                double gain = table->GetInterpolatedIrsEntry(in, out).gain;
+                NS_TEST_EXPECT_MSG_LT_OR_EQ(gain, table->GetMaxGain(in, out), "Sector bound");
+                NS_TEST_EXPECT_MSG_LT_OR_EQ(gain, table->GetMaxGain(in), "Row bound");
+            }
+        }
+
+        // bounds are rebuilt with the storage
+        Ptr<IrsLookupTable> quantized = table->Convert(IrsLookupTable::QUANTIZED);
+        NS_TEST_EXPECT_MSG_EQ(quantized->GetMaxGain(), 12.5, "Quantized bound");
+        table->SetSparseThreshold(20);
+        table->SetFloorGain(-20);
+        Ptr<IrsLookupTable> sparse = table->Convert(IrsLookupTable::SPARSE);
+        NS_TEST_EXPECT_MSG_EQ(sparse->GetMaxGain(10), -5, "Sparse row bound");
+        NS_TEST_EXPECT_MSG_EQ(sparse->GetMaxGain(170), -20, "Sparse floor bound");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check slice selection, lazy loading and the file formats of IrsLookupTableAtlas.
+ */
+class IrsLookupTableAtlasTestCase : public TestCase
+{
+  public:
+    IrsLookupTableAtlasTestCase()
+        : TestCase("Check lookup table atlases indexed by IRS position")
+    {
+    }
+
+  private:
+    /**
+     * @brief Create a table with the same entry for all angles.
+     * @param gain Gain of all entries in dB
+     * @param phaseShift Phase shift of all entries in radians
+     * @return The table
+     */
+    static Ptr<IrsLookupTable> CreateConstantTable(double gain, double phaseShift)
+    {
+        Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                table->Insert(in, out, gain, phaseShift);
+            }
+        }
+        return table;
+    }
+
+    void DoRun() override
+    {
+        Ptr<IrsLookupTableAtlas> atlas = CreateObject<IrsLookupTableAtlas>();
+        Ptr<IrsLookupTable> first = CreateConstantTable(-10, 3);
+        uint32_t a = atlas->AddTable(first);
+        uint32_t b = atlas->AddTable(CreateConstantTable(-20, -3));
+        uint32_t c = atlas->AddTable(CreateConstantTable(-30, 0));
+        NS_TEST_EXPECT_MSG_EQ(atlas->AddTable(first), a, "Same table not shared");
+        // same content as the first table, stored once in atlas files
+        uint32_t d = atlas->AddTable(CreateConstantTable(-10, 3));
+        atlas->AddSlice(Vector(0, 0, 0), a);
+        atlas->AddSlice(Vector(1, 0, 0), b);
+        atlas->AddSlice(Vector(2, 0, 0), c);
+        atlas->AddSlice(Vector(3, 0, 0), d);
+        atlas->AddSlice(Vector(1, 0, 0), Vector(0, 2, 0), c);
+        NS_TEST_ASSERT_MSG_EQ(atlas->GetN(), 5U, "Unexpected number of slices");
+        NS_TEST_EXPECT_MSG_EQ(atlas->GetNTables(), 4U, "Unexpected number of tables");
+        NS_TEST_EXPECT_MSG_EQ(atlas->GetSliceDirection(4), Vector(0, 1, 0), "Not normalized");
+
+        // nearest slice of the best matching orientation
+        IrsLookupTableAtlas::Selection selection = atlas->Select(Vector(0.9, 0.2, 0), Vector());
+        NS_TEST_EXPECT_MSG_EQ(selection.lower, 1U, "Unexpected nearest slice");
+        NS_TEST_EXPECT_MSG_EQ(selection.weight, 0, "Nearest slice blended");
+        NS_TEST_EXPECT_MSG_EQ(atlas->GetIrsEntry(selection, 40, 50, false).gain,
+                              -20,
+                              "Unexpected gain");
+        selection = atlas->Select(Vector(0.9, 0.2, 0), Vector(0, 1, 0));
+        NS_TEST_EXPECT_MSG_EQ(selection.lower, 4U, "Orientation not matched");
+        selection = atlas->Select(Vector(0.9, 0.2, 0), Vector(1, 0, 0));
+        NS_TEST_EXPECT_MSG_EQ(selection.lower, 1U, "Orientation not matched");
+
+        // blending between the two nearest slices
+        atlas->SetInterpolate(true);
+        selection = atlas->Select(Vector(0.25, 0, 0), Vector(1, 0, 0));
+        NS_TEST_EXPECT_MSG_EQ(selection.lower, 0U, "Unexpected lower slice");
+        NS_TEST_EXPECT_MSG_EQ(selection.upper, 1U, "Unexpected upper slice");
+        NS_TEST_EXPECT_MSG_EQ_TOL(selection.weight, 0.25, 1e-12, "Unexpected weight");
+        IrsEntry blended = atlas->GetIrsEntry(selection, 40, 50, false);
+        NS_TEST_EXPECT_MSG_EQ_TOL(blended.gain, -12.5, 1e-12, "Gain not blended");
+        // the phase shift is unwrapped from 3 to -3 + 2 pi
+        NS_TEST_EXPECT_MSG_EQ_TOL(blended.phase_shift,
+                                  3 + 0.25 * (2 * M_PI - 6),
+                                  1e-12,
+                                  "Phase shift not unwrapped");
+        NS_TEST_EXPECT_MSG_EQ(atlas->GetMaxGain(selection), -10, "Unexpected bound");
+        selection = atlas->Select(Vector(-1, 0, 0), Vector(1, 0, 0));
+        NS_TEST_EXPECT_MSG_EQ(selection.weight, 0, "Blended outside of the slices");
+        atlas->SetInterpolate(false);
+
+        // binary atlas files store identical tables once and load them lazily
+        std::string filename = CreateTempDirFilename("irs-atlas.irsatlas");
+        IrsLookupTableIo::WriteAtlas(atlas, filename);
+        NS_TEST_ASSERT_MSG_EQ(IrsLookupTableIo::IsBinaryAtlas(filename),
+                              true,
+                              "Binary atlas not detected");
+        Ptr<IrsLookupTableAtlas> mapped = IrsLookupTableIo::ReadAtlas(filename);
+        NS_TEST_ASSERT_MSG_EQ(mapped->GetN(), 5U, "Unexpected number of slices");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetNTables(), 3U, "Identical tables not merged");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetSliceTable(3), mapped->GetSliceTable(0), "Not shared");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetNLoadedTables(), 0U, "Tables not loaded lazily");
+        selection = mapped->Select(Vector(2.2, 0, 0), Vector(1, 0, 0));
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetIrsEntry(selection, 40, 50, true).gain,
+                              -30,
+                              "Unexpected gain");
+        NS_TEST_EXPECT_MSG_EQ(mapped->GetNLoadedTables(), 1U, "Unused tables loaded");
+        for (uint32_t i = 0; i < atlas->GetN(); ++i)
+        {
+            NS_TEST_EXPECT_MSG_EQ(mapped->GetSlicePosition(i),
+                                  atlas->GetSlicePosition(i),
+                                  "Unexpected position");
+            IrsEntry expected = atlas->GetSliceLookupTable(i)->GetIrsEntry(90, 90);
+            IrsEntry entry = mapped->GetSliceLookupTable(i)->GetIrsEntry(90, 90);
+            NS_TEST_EXPECT_MSG_EQ(entry.gain, expected.gain, "Unexpected gain");
+            NS_TEST_EXPECT_MSG_EQ(entry.phase_shift, expected.phase_shift, "Unexpected phase");
+        }
+
+        // csv index naming table files relative to the index
+        std::string table = CreateTempDirFilename("irs-atlas-table.irslut");
+        IrsLookupTableIo::WriteBinary(first, table);
+        std::string index = CreateTempDirFilename("irs-atlas.csv");
+        {
+            std::ofstream file(index);
+            file << "x,y,z,table\n"
+                 << "0,0,0," << std::filesystem::path(table).filename().string() << "\n"
+                 << "1.5,0,0," << table << "\n";
+        }
+        NS_TEST_EXPECT_MSG_EQ(IrsLookupTableIo::IsBinaryAtlas(index), false, "Not an index");
+        Ptr<IrsLookupTableAtlas> indexed = IrsLookupTableIo::ReadAtlas(index);
+        NS_TEST_ASSERT_MSG_EQ(indexed->GetN(), 2U, "Unexpected number of slices");
+        NS_TEST_EXPECT_MSG_EQ(indexed->GetSlicePosition(1), Vector(1.5, 0, 0), "Position");
+        NS_TEST_EXPECT_MSG_EQ(indexed->GetNLoadedTables(), 0U, "Tables not loaded lazily");
+        NS_TEST_EXPECT_MSG_EQ(indexed->GetSliceLookupTable(0)->GetIrsEntry(5, 6).gain,
+                              -10,
+                              "Unexpected gain");
+        NS_TEST_EXPECT_MSG_EQ(indexed->GetSliceLookupTable(0),
+                              indexed->GetSliceLookupTable(1),
+                              "Same file not shared");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief IrsLookupTable TestSuite
+ */
+class IrsLookupTableTestSuite : public TestSuite
+{
+  public:
+    IrsLookupTableTestSuite();
+};
+
+IrsLookupTableTestSuite::IrsLookupTableTestSuite()
+    : TestSuite("irs-lookup-table", Type::UNIT)
+{
+    AddTestCase(new IrsLookupTableBinaryTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableRegistryTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableEmbeddedTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableInterpolationTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTable4DTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsMultiFrequencyLookupTableTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableQuantizedTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableLowRankTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableSparseTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableGainBoundsTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableAtlasTestCase, TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static IrsLookupTableTestSuite g_irsLookupTableTestSuite;
@@ -12,6 +12,9 @@
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/irs-lookup-helper.h"
+#include "ns3/irs-lookup-table-atlas.h"
+#include "ns3/irs-lookup-table.h"
+#include "ns3/irs-model.h"
 #include "ns3/irs-propagation-loss-model.h"
 #include "ns3/irs-spectrum-model.h"
 #include "ns3/log.h"
@@ -22,10 +25,12 @@
 #include "ns3/tuple.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <optional>
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -359,6 +364,254 @@ IrsPropagationLossModelHelperFunctionsTestCase::DoRun()
     TestAngle3DCalculation();
 }
 
+/**
+ * @brief Create a node with an IRS facing +y.
+ * @param nodes Container the node is created in
+ * @param helper Helper holding the table or atlas of the IRS
+ * @param position Position of the IRS
+ * @return Mobility model of the IRS
+ */
+static Ptr<MobilityModel>
+CreateIrsNode(NodeContainer& nodes, IrsLookupHelper& helper, Vector position)
+{
+    nodes.Create(1);
+    Ptr<Node> node = nodes.Get(nodes.GetN() - 1);
+    Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetPosition(position);
+    node->AggregateObject(mobility);
+    helper.SetDirection({0, 1, 0});
+    helper.Install(node);
+    return mobility;
+}
+
+/**
+ * @brief Create a Friis propagation loss model.
+ * @param frequency Carrier frequency in Hz
+ * @return The loss model
+ */
+static Ptr<FriisPropagationLossModel>
+CreateFriisModel(double frequency)
+{
+    Ptr<FriisPropagationLossModel> model = CreateObject<FriisPropagationLossModel>();
+    model->SetFrequency(frequency);
+    return model;
+}
+
+/**
+ * @brief Create an IrsPropagationLossModel.
+ * @param frequency Carrier frequency in Hz
+ * @param irsNodes The IRS nodes
+ * @param irsLossModel Loss model of the segments of the IRS paths
+ * @param losLossModel Loss model of the line-of-sight path, none if null
+ * @return The loss model
+ */
+static Ptr<IrsPropagationLossModel>
+CreateIrsLossModel(double frequency,
+                   NodeContainer& irsNodes,
+                   Ptr<PropagationLossModel> irsLossModel,
+                   Ptr<PropagationLossModel> losLossModel = nullptr)
+{
+    Ptr<IrsPropagationLossModel> lossModel = CreateObject<IrsPropagationLossModel>();
+    lossModel->SetFrequency(frequency);
+    lossModel->SetIrsNodes(&irsNodes);
+    lossModel->SetIrsPropagationModel(irsLossModel);
+    if (losLossModel)
+    {
+        lossModel->SetLosPropagationModel(losLossModel);
+    }
+    return lossModel;
+}
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Test that IRS paths are pruned by their gain bound
+ */
+class IrsPropagationLossModelPruningTestCase : public TestCase
+{
+  public:
+    IrsPropagationLossModelPruningTestCase();
+    ~IrsPropagationLossModelPruningTestCase() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Check that a path over a single IRS is kept above and dropped below a bound.
+     * @param table Lookup table of the IRS
+     * @param expectedGainBound Expected gain bound of the IRS at the angles of the path in dB
+     */
+    void CheckPruning(Ptr<IrsLookupTable> table, double expectedGainBound);
+};
+
+IrsPropagationLossModelPruningTestCase::IrsPropagationLossModelPruningTestCase()
+    : TestCase("Check that IRS paths below the pruning threshold are dropped")
+{
+}
+
+IrsPropagationLossModelPruningTestCase::~IrsPropagationLossModelPruningTestCase()
+{
+}
+
+void
+IrsPropagationLossModelPruningTestCase::CheckPruning(Ptr<IrsLookupTable> table,
+                                                     double expectedGainBound)
+{
+    double frequency = 5.21e9;
+    double txPowerDbm = 17;
+
+    NodeContainer irsNode;
+    IrsLookupHelper irsHelper;
+    irsHelper.SetLookupTable(table);
+    Ptr<MobilityModel> irs = CreateIrsNode(irsNode, irsHelper, {0, 0, 0});
+    Ptr<FriisPropagationLossModel> irsLossModel = CreateFriisModel(frequency);
+    Ptr<FriisPropagationLossModel> losLossModel = CreateFriisModel(frequency);
+    Ptr<IrsPropagationLossModel> lossModel =
+        CreateIrsLossModel(frequency, irsNode, irsLossModel, losLossModel);
+
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition({-10, 5, 0});
+    b->SetPosition({10, 5, 0});
+
+    // bound of the IRS path: both segments with the largest gain of the sectors around the angles
+    auto angles = IrsPropagationLossModel::CalcAngles(a->GetPosition(),
+                                                      b->GetPosition(),
+                                                      irs->GetPosition(),
+                                                      {0, 1, 0});
+    NS_TEST_ASSERT_MSG_EQ(angles.has_value(), true, "Path not valid");
+    double gainBound =
+        irsNode.Get(0)->GetObject<IrsModel>()->GetMaxGain(angles->first, angles->second);
+    NS_TEST_ASSERT_MSG_EQ_TOL(gainBound, expectedGainBound, 1e-9, "Unexpected gain bound");
+    double segments =
+        irsLossModel->CalcRxPower(0, a, irs) + irsLossModel->CalcRxPower(0, irs, b);
+    double bound = txPowerDbm + segments + gainBound;
+    double unpruned = lossModel->CalcRxPower(txPowerDbm, a, b);
+    double losOnly = losLossModel->CalcRxPower(txPowerDbm, a, b);
+    NS_TEST_ASSERT_MSG_NE(unpruned, losOnly, "IRS path does not contribute");
+
+    lossModel->SetAttribute("PruningThreshold", DoubleValue(bound - 1));
+    NS_TEST_EXPECT_MSG_EQ_TOL(lossModel->CalcRxPower(txPowerDbm, a, b),
+                              unpruned,
+                              1e-9,
+                              "Path above the threshold pruned");
+    lossModel->SetAttribute("PruningThreshold", DoubleValue(bound + 1));
+    NS_TEST_EXPECT_MSG_EQ_TOL(lossModel->CalcRxPower(txPowerDbm, a, b),
+                              losOnly,
+                              1e-9,
+                              "Path below the threshold not pruned");
+}
+
+void
+IrsPropagationLossModelPruningTestCase::DoRun()
+{
+    // the path hits the IRS at about 116.6 and leaves at about 63.4 degrees, so the bound reads
+    // the sectors of 110 to 120 and 60 to 70 degrees
+    Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+    for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+    {
+        for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+        {
+            table->Insert(in, out, 20 - 0.1 * in, 0.02 * out);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(table->GetMaxGain(), 20, "Unexpected table bound");
+    CheckPruning(table, 9);
+
+    // a gain peak at grazing incidence only raises the global bound, a threshold between both
+    // bounds drops the path by its sector bound alone
+    Ptr<IrsLookupTable> peakTable = CreateObject<IrsLookupTable>();
+    for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+    {
+        for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+        {
+            peakTable->Insert(in, out, in < 30 ? 30 : -10, 0.02 * out);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(peakTable->GetMaxGain(), 30, "Unexpected table bound");
+    CheckPruning(peakTable, -10);
+}
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Test that a moving IRS with an atlas uses the table of its current position
+ */
+class IrsPropagationLossModelAtlasTestCase : public TestCase
+{
+  public:
+    IrsPropagationLossModelAtlasTestCase();
+    ~IrsPropagationLossModelAtlasTestCase() override;
+
+  private:
+    void DoRun() override;
+};
+
+IrsPropagationLossModelAtlasTestCase::IrsPropagationLossModelAtlasTestCase()
+    : TestCase("Check that an IRS with an atlas follows its position")
+{
+}
+
+IrsPropagationLossModelAtlasTestCase::~IrsPropagationLossModelAtlasTestCase()
+{
+}
+
+void
+IrsPropagationLossModelAtlasTestCase::DoRun()
+{
+    double frequency = 5.21e9;
+    double txPowerDbm = 17;
+
+    // one table per IRS position along the x axis
+    Ptr<IrsLookupTableAtlas> atlas = CreateObject<IrsLookupTableAtlas>();
+    std::vector<Ptr<IrsLookupTable>> tables;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        Ptr<IrsLookupTable> table = CreateObject<IrsLookupTable>();
+        for (uint8_t in = 0; in < IrsLookupTable::N_ANGLES; ++in)
+        {
+            for (uint8_t out = 0; out < IrsLookupTable::N_ANGLES; ++out)
+            {
+                table->Insert(in, out, 10.0 * i - 0.05 * in, 0.5 * i + 0.01 * out);
+            }
+        }
+        atlas->AddSlice(Vector(5.0 * i, 0, 0), atlas->AddTable(table));
+        tables.push_back(table);
+    }
+
+    NodeContainer irsNode;
+    IrsLookupHelper irsHelper;
+    irsHelper.SetAtlas(atlas);
+    Ptr<MobilityModel> irs = CreateIrsNode(irsNode, irsHelper, {0, 0, 0});
+
+    // the same IRS with a single table, set for every position
+    NodeContainer referenceNode;
+    IrsLookupHelper referenceHelper;
+    referenceHelper.SetLookupTable(tables[0]);
+    Ptr<MobilityModel> reference = CreateIrsNode(referenceNode, referenceHelper, {0, 0, 0});
+
+    Ptr<FriisPropagationLossModel> irsLossModel = CreateFriisModel(frequency);
+    Ptr<IrsPropagationLossModel> lossModel = CreateIrsLossModel(frequency, irsNode, irsLossModel);
+    Ptr<IrsPropagationLossModel> referenceLossModel =
+        CreateIrsLossModel(frequency, referenceNode, irsLossModel);
+
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition({-10, 5, 0});
+    b->SetPosition({20, 5, 0});
+    for (double x : {0.0, 4.0, 6.0, 10.0, 12.0})
+    {
+        irs->SetPosition({x, 0, 0});
+        reference->SetPosition({x, 0, 0});
+        referenceHelper.SetLookupTable(tables[std::min<uint32_t>(std::lround(x / 5), 2)]);
+        referenceHelper.Install(referenceNode);
+        NS_TEST_EXPECT_MSG_EQ_TOL(lossModel->CalcRxPower(txPowerDbm, a, b),
+                                  referenceLossModel->CalcRxPower(txPowerDbm, a, b),
+                                  1e-9,
+                                  "Table of the nearest slice not used at x = " << x);
+    }
+}
+
 /**
  * @ingroup irs-tests
  *
@@ -376,6 +629,8 @@ IrsPropagationLossModelsTestSuite::IrsPropagationLossModelsTestSuite()
 {
     // AddTestCase(new IrsPropagationLossModelTestCase, TestCase::Duration::QUICK);
     AddTestCase(new IrsPropagationLossModelHelperFunctionsTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsPropagationLossModelPruningTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsPropagationLossModelAtlasTestCase, TestCase::Duration::QUICK);
 }
 
 /// Static variable for test initialization
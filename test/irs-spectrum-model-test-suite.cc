@@ -10,8 +10,12 @@
 #include "ns3/abort.h"
 #include "ns3/config.h"
 #include "ns3/core-module.h"
+#include "ns3/irs-array-response-kernel.h"
 #include "ns3/irs-lookup-model.h"
+#include "ns3/irs-lookup-table-generator.h"
+#include "ns3/irs-lookup-table-io.h"
 #include "ns3/irs-lookup-table.h"
+#include "ns3/irs-reflection-pattern.h"
 #include "ns3/irs-spectrum-model.h"
 #include "ns3/log.h"
 #include "ns3/node-container.h"
@@ -19,11 +23,15 @@
 #include "ns3/tuple.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <complex>
 #include <cstdint>
 #include <iostream>
+#include <random>
 #include <string>
+#include <vector>
 
 using namespace ns3;
 using namespace std;
@@ -31,6 +39,17 @@ using namespace std::chrono;
 
 NS_LOG_COMPONENT_DEFINE("IrsSpectrumModelTest");
 
+/**
+ * @brief Get the complex response of an IRS entry.
+ * @param entry The IRS entry
+ * @return The response with the gain and phase shift of the entry
+ */
+static std::complex<double>
+Response(IrsEntry entry)
+{
+    return std::polar(std::pow(10, entry.gain / 20), -entry.phase_shift);
+}
+
 class IrsSpectrumModelTestCase : public TestCase
 {
   public:
@@ -59,46 +78,6 @@ class IrsSpectrumModelTestCase : public TestCase
     TestVectors<TestVector> m_testVectors;
 };
 
-Ptr<IrsLookupTable>
-SetLookupTable(string filename)
-{
-    // Load Lookup Table from csv file
-    ifstream file(filename);
-    NS_ABORT_MSG_IF(!file.is_open(), "IRS Lookup Table file not found.");
-
-    // Create the lookup table
-    Ptr<IrsLookupTable> irsLookupTable = CreateObject<IrsLookupTable>();
-
-    string line;
-    // Skip the header
-    getline(file, line);
-
-    // Read the data
-    while (getline(file, line))
-    {
-        stringstream ss(line);
-        string item;
-        uint8_t in_angle, out_angle;
-        double gain, phase_shift;
-
-        // Read each value separated by comma
-        getline(ss, item, ',');
-        in_angle = stoi(item);
-        getline(ss, item, ',');
-        out_angle = stoi(item);
-        getline(ss, item, ',');
-        gain = stod(item);
-        getline(ss, item, ',');
-        phase_shift = stod(item);
-
-        // Insert into the map
-        irsLookupTable->Insert(in_angle, out_angle, gain, phase_shift);
-    }
-
-    file.close();
-    return irsLookupTable;
-}
-
 void
 IrsSpectrumModelTestCase::DoRun()
 {
@@ -112,8 +91,7 @@ IrsSpectrumModelTestCase::DoRun()
     tv.in_angle = 110;
     tv.out_angle = 69;
     tv.delta = M_PI;
-    tv.lookuptable =
-        "contrib/irs/examples/lookuptables/IRS_400_IN110_OUT69_FREQ5.21GHz_destructive.csv";
+    tv.lookuptable = "IRS_400_IN110_OUT69_FREQ5.21GHz_destructive";
     m_testVectors.Add(tv);
 
     Ptr<IrsLookupModel> irsNormal = CreateObject<IrsLookupModel>();
@@ -138,7 +116,7 @@ IrsSpectrumModelTestCase::DoRun()
                          tv.delta);
 
         irsNormal->SetDirection(Vector(0, 1, 0));
-        irsNormal->SetLookupTable(SetLookupTable(tv.lookuptable));
+        irsNormal->SetLookupTable(IrsLookupTableIo::ReadEmbedded(tv.lookuptable));
 
         for (int i = 1; i < 180; i += 2)
         {
@@ -185,6 +163,8 @@ class IrsSpectrumModelTestCaching : public TestCase
             DoubleValue(5.21e9));
         irs->CalcRCoeffs(Angles(DegreesToRadians(135), DegreesToRadians(0)),
                          Angles(DegreesToRadians(45), DegreesToRadians(0)));
+        // measure the cache rather than the separable path
+        irs->SetSeparableEvaluation(false);
 
         double azimuth = 135.0;
         double elevation = 45.0;
@@ -223,6 +203,843 @@ class IrsSpectrumModelTestCaching : public TestCase
     }
 };
 
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the per-direction steering vector caches of the IrsSpectrumModel.
+ */
+class IrsSpectrumModelSteeringCacheTestCase : public TestCase
+{
+  public:
+    IrsSpectrumModelSteeringCacheTestCase()
+        : TestCase("Check the steering vector caches of the IrsSpectrumModel")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 20, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        irs->SetSeparableEvaluation(false);
+        double lambda = 299792458.0 / 5.21e9;
+
+        // every pair of a few directions, each direction is used as input and output
+        std::vector<Angles> directions;
+        for (double azimuth : {10.0, 45.0, 90.0, 135.0, 170.0})
+        {
+            directions.emplace_back(DegreesToRadians(azimuth), DegreesToRadians(20));
+        }
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (const auto& in : directions)
+            {
+                for (const auto& out : directions)
+                {
+                    IrsEntry expected = irs->CalcIrsEntry(in, out, lambda);
+                    IrsEntry entry = irs->GetIrsEntry(in, out, lambda);
+                    NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain, expected.gain, 1e-9, "Cached gain");
+                    NS_TEST_EXPECT_MSG_EQ_TOL(
+                        std::remainder(entry.phase_shift - expected.phase_shift, 2 * M_PI),
+                        0,
+                        1e-9,
+                        "Cached phase shift");
+                }
+            }
+        }
+
+        // the steering vectors of a direction are shared within a degree
+        Angles in = directions[1];
+        Angles out(DegreesToRadians(135.2), DegreesToRadians(20.3));
+        IrsEntry first =
+            irs->GetIrsEntry(in, Angles(DegreesToRadians(135.5), DegreesToRadians(20.5)), lambda);
+        NS_TEST_EXPECT_MSG_EQ(irs->GetIrsEntry(in, out, lambda).gain,
+                              first.gain,
+                              "Direction not shared within a degree");
+
+        // new reflection coefficients are used at once, the steering vectors are kept
+        irs->SetRcoeffs(-irs->GetRcoeffs());
+        IrsEntry flipped = irs->GetIrsEntry(in, directions[3], lambda);
+        IrsEntry expected = irs->CalcIrsEntry(in, directions[3], lambda);
+        NS_TEST_EXPECT_MSG_EQ_TOL(flipped.gain, expected.gain, 1e-9, "Stale gain");
+        NS_TEST_EXPECT_MSG_EQ_TOL(std::remainder(flipped.phase_shift - expected.phase_shift,
+                                                 2 * M_PI),
+                                  0,
+                                  1e-9,
+                                  "Stale phase shift");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the capacity, LRU eviction, invalidation and counters of the steering vector
+ * caches of the IrsSpectrumModel.
+ */
+class IrsSpectrumModelCacheBoundTestCase : public TestCase
+{
+  public:
+    IrsSpectrumModelCacheBoundTestCase()
+        : TestCase("Check the bounded steering vector caches of the IrsSpectrumModel")
+    {
+    }
+
+  private:
+    /**
+     * @brief Check a cached entry against the uncached one and the cache counters.
+     * @param irs The IRS
+     * @param in Input angles
+     * @param out Output angles
+     * @param hits Expected number of hits after the lookup
+     * @param misses Expected number of misses after the lookup
+     * @param evictions Expected number of evictions after the lookup
+     */
+    void Check(Ptr<IrsSpectrumModel> irs,
+               Angles in,
+               Angles out,
+               uint64_t hits,
+               uint64_t misses,
+               uint64_t evictions)
+    {
+        double lambda = 299792458.0 / irs->GetFrequency();
+        IrsEntry entry = irs->GetIrsEntry(in, out, lambda);
+        IrsEntry expected = irs->CalcIrsEntry(in, out, lambda);
+        NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain, expected.gain, 1e-9, "Cached gain");
+        NS_TEST_EXPECT_MSG_EQ_TOL(std::remainder(entry.phase_shift - expected.phase_shift,
+                                                 2 * M_PI),
+                                  0,
+                                  1e-9,
+                                  "Cached phase shift");
+        NS_TEST_EXPECT_MSG_EQ(irs->GetCacheHits(), hits, "Hits");
+        NS_TEST_EXPECT_MSG_EQ(irs->GetCacheMisses(), misses, "Misses");
+        NS_TEST_EXPECT_MSG_EQ(irs->GetCacheEvictions(), evictions, "Evictions");
+    }
+
+    void DoRun() override
+    {
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(10, 10, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        irs->SetSeparableEvaluation(false);
+        irs->SetCacheCapacity(2);
+        NS_TEST_EXPECT_MSG_EQ(irs->GetCacheCapacity(), 2U, "Capacity");
+        Angles a(DegreesToRadians(30.5), DegreesToRadians(10.5));
+        Angles b(DegreesToRadians(60.5), DegreesToRadians(10.5));
+        Angles c(DegreesToRadians(90.5), DegreesToRadians(10.5));
+
+        // weighted a, steering vectors a and b
+        Check(irs, a, b, 0, 3, 0);
+        Check(irs, a, b, 2, 3, 0);
+        // c evicts the steering vector of a, a then evicts b
+        Check(irs, c, a, 2, 6, 2);
+
+        // new coefficients invalidate the weighted vectors in place, the steering vectors stay
+        irs->SetRcoeffs(std::complex<double>(0, 1) * irs->GetRcoeffs());
+        Check(irs, a, c, 4, 7, 2);
+
+        // without capacity nothing is cached or counted
+        irs->SetCacheCapacity(0);
+        Check(irs, b, c, 4, 7, 2);
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the grid-anchored interpolation of the steering vector caches of the
+ * IrsSpectrumModel.
+ */
+class IrsSpectrumModelGridCacheTestCase : public TestCase
+{
+  public:
+    IrsSpectrumModelGridCacheTestCase()
+        : TestCase("Check the grid-anchored steering vector caches of the IrsSpectrumModel")
+    {
+    }
+
+  private:
+    /**
+     * @brief Get the largest error of the interpolated response around the main lobe.
+     * @param resolution Grid step in degrees
+     * @return Largest deviation of the complex response, relative to the largest response
+     */
+    static double MaxError(double resolution)
+    {
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 20, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        irs->SetSeparableEvaluation(false);
+        irs->SetGridResolution(resolution);
+        double lambda = 299792458.0 / 5.21e9;
+        Angles out(DegreesToRadians(45), DegreesToRadians(1));
+        double maxError = 0;
+        double maxResponse = 0;
+        for (double azimuth = 132.13; azimuth < 138; azimuth += 0.71)
+        {
+            Angles in(DegreesToRadians(azimuth), DegreesToRadians(1.37));
+            std::complex<double> expected = Response(irs->CalcIrsEntry(in, out, lambda));
+            std::complex<double> entry = Response(irs->GetIrsEntry(in, out, lambda));
+            maxError = std::max(maxError, std::abs(entry - expected));
+            maxResponse = std::max(maxResponse, std::abs(expected));
+        }
+        return maxError / maxResponse;
+    }
+
+    void DoRun() override
+    {
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 20, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        irs->SetSeparableEvaluation(false);
+        irs->SetGridResolution(1);
+        NS_TEST_EXPECT_MSG_EQ(irs->GetGridResolution(), 1, "Grid resolution");
+        double lambda = 299792458.0 / 5.21e9;
+
+        // grid points are evaluated exactly
+        Angles onGridIn(DegreesToRadians(135), DegreesToRadians(10));
+        Angles onGridOut(DegreesToRadians(45), DegreesToRadians(5));
+        IrsEntry entry = irs->GetIrsEntry(onGridIn, onGridOut, lambda);
+        IrsEntry expected = irs->CalcIrsEntry(onGridIn, onGridOut, lambda);
+        NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain, expected.gain, 1e-9, "Gain on the grid");
+        NS_TEST_EXPECT_MSG_EQ_TOL(std::remainder(entry.phase_shift - expected.phase_shift,
+                                                 2 * M_PI),
+                                  0,
+                                  1e-9,
+                                  "Phase shift on the grid");
+
+        // the result does not depend on the order of the queries
+        Ptr<IrsSpectrumModel> other = IrsLookupTableGenerator::CreateIrs(20, 20, 5.21e9);
+        IrsLookupTableGenerator::Steer(other, 135, 45);
+        other->SetSeparableEvaluation(false);
+        other->SetGridResolution(1);
+        Angles x(DegreesToRadians(135.2), DegreesToRadians(10.3));
+        Angles y(DegreesToRadians(135.8), DegreesToRadians(10.6));
+        IrsEntry xFirst = irs->GetIrsEntry(x, onGridOut, lambda);
+        IrsEntry yFirst = other->GetIrsEntry(y, onGridOut, lambda);
+        NS_TEST_EXPECT_MSG_EQ(other->GetIrsEntry(x, onGridOut, lambda).gain,
+                              xFirst.gain,
+                              "Result depends on the query order");
+        NS_TEST_EXPECT_MSG_EQ(irs->GetIrsEntry(y, onGridOut, lambda).gain,
+                              yFirst.gain,
+                              "Result depends on the query order");
+
+        // evaluations are bounded by the grid points: 3 x 3 around the inputs, both as weighted
+        // and as steering vector, and the output on the grid
+        uint64_t misses = irs->GetCacheMisses();
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            Angles in(DegreesToRadians(135 + 0.0199 * i), DegreesToRadians(10 + 0.0173 * i));
+            irs->GetIrsEntry(in, onGridOut, lambda);
+        }
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(irs->GetCacheMisses() - misses,
+                                    uint64_t(2 * 9 + 1),
+                                    "Evaluations not bounded by the grid");
+
+        // a finer grid interpolates more accurately
+        double coarse = MaxError(1);
+        double fine = MaxError(0.25);
+        NS_TEST_EXPECT_MSG_LT(coarse, 0.1, "Interpolation error of the 1 degree grid");
+        NS_TEST_EXPECT_MSG_LT(fine, coarse / 4, "Finer grid not more accurate");
+
+        // the grid takes precedence over the separable path of a steered IRS
+        Ptr<IrsSpectrumModel> steered = IrsLookupTableGenerator::CreateIrs(20, 20, 5.21e9);
+        IrsLookupTableGenerator::Steer(steered, 135, 45);
+        NS_TEST_ASSERT_MSG_EQ(steered->IsSeparable(), true, "Steered IRS not separable");
+        steered->SetGridResolution(1);
+        IrsEntry gridEntry = steered->GetIrsEntry(x, onGridOut, lambda);
+        NS_TEST_EXPECT_MSG_GT(steered->GetCacheMisses(), 0U, "Grid ignored by separable IRS");
+        NS_TEST_EXPECT_MSG_EQ_TOL(gridEntry.gain, xFirst.gain, 1e-9, "Grid entry of separable IRS");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the separable evaluation of the IrsSpectrumModel and its fallback to the cache.
+ */
+class IrsSpectrumModelSeparableTestCase : public TestCase
+{
+  public:
+    IrsSpectrumModelSeparableTestCase()
+        : TestCase("Check the separable evaluation of the IrsSpectrumModel")
+    {
+    }
+
+  private:
+    /**
+     * @brief Get the largest error of the cached or separable path over a set of directions.
+     * @param irs The IRS
+     * @return Largest deviation of the complex response from \c CalcIrsEntry
+     */
+    static double MaxError(Ptr<IrsSpectrumModel> irs)
+    {
+        double lambda = 299792458.0 / irs->GetFrequency();
+        double maxError = 0;
+        for (double inAzimuth = 95.5; inAzimuth < 180; inAzimuth += 20)
+        {
+            for (double outAzimuth = 0.5; outAzimuth < 90; outAzimuth += 10)
+            {
+                for (double inclination : {0.5, 20.5, 60.5})
+                {
+                    Angles in(DegreesToRadians(inAzimuth), DegreesToRadians(inclination));
+                    Angles out(DegreesToRadians(outAzimuth), DegreesToRadians(inclination / 2));
+                    std::complex<double> expected = Response(irs->CalcIrsEntry(in, out, lambda));
+                    std::complex<double> entry = Response(irs->GetIrsEntry(in, out, lambda));
+                    maxError = std::max(maxError, std::abs(entry - expected));
+                }
+            }
+        }
+        return maxError;
+    }
+
+    void DoRun() override
+    {
+        // a single beam, with and without phase control, factors into rows and columns
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 12, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        NS_TEST_EXPECT_MSG_EQ(irs->IsSeparable(), true, "Steered IRS not separable");
+        NS_TEST_EXPECT_MSG_LT(MaxError(irs), 1e-9 * 20 * 12, "Separable response");
+        NS_TEST_EXPECT_MSG_EQ(irs->GetCacheMisses(), 0U, "Separable path used the cache");
+        IrsLookupTableGenerator::Steer(irs, 120, 70, 50, 50.5, M_PI, 0.5);
+        NS_TEST_EXPECT_MSG_EQ(irs->IsSeparable(), true, "Phase controlled IRS not separable");
+        NS_TEST_EXPECT_MSG_LT(MaxError(irs), 1e-9 * 20 * 12, "Phase controlled response");
+
+        // tiles steered towards different users do not factor and use the cache
+        Ptr<IrsSpectrumModel> other = IrsLookupTableGenerator::CreateIrs(20, 12, 5.21e9);
+        IrsLookupTableGenerator::Steer(other, 100, 30);
+        Eigen::VectorXcd tiled = irs->GetRcoeffs();
+        for (uint32_t i = 0; i < 20; ++i)
+        {
+            tiled.segment(i * 12 + 6, 6) = other->GetRcoeffs().segment(i * 12 + 6, 6);
+        }
+        irs->SetRcoeffs(tiled);
+        NS_TEST_EXPECT_MSG_EQ(irs->IsSeparable(), false, "Tiled IRS separable");
+        NS_TEST_EXPECT_MSG_LT(MaxError(irs), 1e-9 * 20 * 12, "Tiled response");
+        NS_TEST_EXPECT_MSG_GT(irs->GetCacheMisses(), 0U, "Tiled IRS did not use the cache");
+
+        // elements off the grid do not factor either
+        irs->SetRcoeffs(other->GetRcoeffs());
+        NS_TEST_EXPECT_MSG_EQ(irs->IsSeparable(), true, "Steered coefficients not separable");
+        Eigen::MatrixX3d positions = irs->GetElementPos();
+        positions(5, 1) += 1e-3;
+        irs->SetElementPos(positions);
+        NS_TEST_EXPECT_MSG_EQ(irs->IsSeparable(), false, "IRS off the grid separable");
+        NS_TEST_EXPECT_MSG_LT(MaxError(irs), 1e-9 * 20 * 12, "Off-grid response");
+
+        // the separable path can be disabled
+        other->SetSeparableEvaluation(false);
+        NS_TEST_EXPECT_MSG_LT(MaxError(other), 1e-9 * 20 * 12, "Cached response");
+        NS_TEST_EXPECT_MSG_GT(other->GetCacheMisses(), 0U, "Disabled separable path");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the steering vectors built by phasor recurrence against the element-wise
+ * exponential.
+ */
+class IrsSpectrumModelPhasorRecurrenceTestCase : public TestCase
+{
+  public:
+    IrsSpectrumModelPhasorRecurrenceTestCase()
+        : TestCase("Check the phasor recurrence of the IrsSpectrumModel steering vectors")
+    {
+    }
+
+  private:
+    /**
+     * @brief Get the largest deviation of the recurrence from the element-wise exponential.
+     * @param irs The IRS
+     * @return Largest deviation over a set of directions
+     */
+    static double MaxError(Ptr<IrsSpectrumModel> irs)
+    {
+        double lambda = 299792458.0 / irs->GetFrequency();
+        Eigen::MatrixX3d elementPos = irs->GetElementPos();
+        double maxError = 0;
+        for (double azimuth = -179.5; azimuth < 180; azimuth += 23)
+        {
+            for (double inclination = 0; inclination <= 90; inclination += 15)
+            {
+                Angles angle(DegreesToRadians(azimuth), DegreesToRadians(inclination));
+                Eigen::VectorXcd expected = irs->CalcSteeringvector(angle, lambda, elementPos);
+                Eigen::VectorXcd stv = irs->CalcSteeringvector(angle, lambda);
+                maxError = std::max(maxError, (stv - expected).cwiseAbs().maxCoeff());
+            }
+        }
+        return maxError;
+    }
+
+    void DoRun() override
+    {
+        // even, odd and long rows and columns, at half wavelength and wider spacing
+        for (auto [nr, nc] : std::vector<std::pair<uint16_t, uint16_t>>{{20, 20},
+                                                                        {7, 33},
+                                                                        {64, 64},
+                                                                        {1, 1024},
+                                                                        {256, 256}})
+        {
+            Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(nr, nc, 5.21e9);
+            IrsLookupTableGenerator::Steer(irs, 135, 45);
+            NS_TEST_EXPECT_MSG_LT(MaxError(irs), 1e-11, "Recurrence of " << nr << "x" << nc);
+            irs->SetSpacing({0.07, 0.11});
+            irs->CalcRCoeffs(Angles(DegreesToRadians(135), 0), Angles(DegreesToRadians(45), 0));
+            NS_TEST_EXPECT_MSG_LT(MaxError(irs), 1e-11, "Recurrence with wide spacing");
+        }
+
+        // the phasors keep unit magnitude along a long row
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(1, 4096, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        Eigen::VectorXcd stv =
+            irs->CalcSteeringvector(Angles(DegreesToRadians(10), DegreesToRadians(70)),
+                                    299792458.0 / 5.21e9);
+        NS_TEST_EXPECT_MSG_LT((stv.cwiseAbs().array() - 1).abs().maxCoeff(),
+                              1e-14,
+                              "Magnitude drift");
+
+        // elements off the grid use the element-wise exponential
+        Eigen::MatrixX3d positions = irs->GetElementPos();
+        positions(7, 2) += 1e-3;
+        irs->SetElementPos(positions);
+        NS_TEST_EXPECT_MSG_EQ(MaxError(irs), 0, "Layout off the grid not exact");
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the vectorized array response kernel against the scalar loop and the
+ * element-wise exponential.
+ */
+class IrsArrayResponseKernelTestCase : public TestCase
+{
+  public:
+    IrsArrayResponseKernelTestCase()
+        : TestCase("Check the SIMD array response kernel of the IrsSpectrumModel")
+    {
+    }
+
+  private:
+    /**
+     * @brief Get the instruction sets this CPU supports.
+     * @return The instruction sets, the scalar loop first
+     */
+    static std::vector<IrsArrayResponseKernel::Isa> GetIsas()
+    {
+        std::vector<IrsArrayResponseKernel::Isa> isas;
+        for (auto isa : {IrsArrayResponseKernel::SCALAR,
+                         IrsArrayResponseKernel::AVX2,
+                         IrsArrayResponseKernel::AVX512})
+        {
+            if (IrsArrayResponseKernel::IsSupported(isa))
+            {
+                isas.push_back(isa);
+            }
+        }
+        return isas;
+    }
+
+    void DoRun() override
+    {
+        std::vector<IrsArrayResponseKernel::Isa> isas = GetIsas();
+        NS_TEST_ASSERT_MSG_EQ(isas.front(), IrsArrayResponseKernel::SCALAR, "Scalar loop missing");
+        IrsArrayResponseKernel kernel;
+        NS_TEST_EXPECT_MSG_EQ(kernel.GetIsa(),
+                              IrsArrayResponseKernel::GetBestIsa(),
+                              "Kernel not on the widest instruction set");
+
+        // a single element at x = 1 gives exp(-j phase), across all quarter turns
+        Eigen::MatrixX3d unit = Eigen::MatrixX3d::Zero(1, 3);
+        unit(0, 0) = 1;
+        kernel.SetElements(unit, Eigen::VectorXcd::Ones(1));
+        for (auto isa : isas)
+        {
+            kernel.SetIsa(isa);
+            double maxError = 0;
+            for (double phase = -1000; phase <= 1000; phase += 0.0731)
+            {
+                std::complex<double> response = kernel.Evaluate(Eigen::Vector3d(phase, 0, 0));
+                maxError = std::max(maxError, std::abs(response - std::polar(1.0, -phase)));
+            }
+            for (int32_t quarter = -8; quarter <= 8; ++quarter)
+            {
+                double phase = quarter * M_PI / 2;
+                std::complex<double> response = kernel.Evaluate(Eigen::Vector3d(phase, 0, 0));
+                maxError = std::max(maxError, std::abs(response - std::polar(1.0, -phase)));
+            }
+            NS_TEST_EXPECT_MSG_LT(maxError,
+                                  1e-13,
+                                  "Phase error of " << IrsArrayResponseKernel::GetIsaName(isa));
+        }
+
+        // random surfaces, with sizes that do not fill the last vector
+        std::mt19937 rng(2024);
+        std::uniform_real_distribution<double> uniform(-1, 1);
+        for (uint32_t n : {1U, 3U, 7U, 9U, 100U, 400U, 4096U})
+        {
+            Eigen::MatrixX3d positions(n, 3);
+            Eigen::VectorXcd rcoeffs(n);
+            for (uint32_t e = 0; e < n; ++e)
+            {
+                positions.row(e) = 0.5 * Eigen::Vector3d(uniform(rng), uniform(rng), uniform(rng));
+                rcoeffs[e] = {uniform(rng), uniform(rng)};
+            }
+            kernel.SetElements(positions, rcoeffs);
+            NS_TEST_EXPECT_MSG_EQ(kernel.GetSize(), n, "Kernel size");
+            double scale = rcoeffs.cwiseAbs().sum();
+            for (uint32_t trial = 0; trial < 20; ++trial)
+            {
+                Eigen::Vector3d k(200 * uniform(rng), 200 * uniform(rng), 200 * uniform(rng));
+                std::complex<double> expected =
+                    (rcoeffs.array() *
+                     (std::complex<double>(0, -1) * (positions * k).cast<std::complex<double>>())
+                         .array()
+                         .exp())
+                        .sum();
+                kernel.SetIsa(IrsArrayResponseKernel::SCALAR);
+                std::complex<double> scalar = kernel.Evaluate(k);
+                NS_TEST_EXPECT_MSG_LT(std::abs(scalar - expected),
+                                      1e-13 * scale,
+                                      "Scalar loop of " << n << " elements");
+                // the vector kernels only sum in a different order
+                for (auto isa : isas)
+                {
+                    kernel.SetIsa(isa);
+                    NS_TEST_EXPECT_MSG_LT(std::abs(kernel.Evaluate(k) - scalar),
+                                          1e-14 * scale,
+                                          IrsArrayResponseKernel::GetIsaName(isa) << " of " << n
+                                                                                  << " elements");
+                }
+            }
+        }
+
+        // positions and coefficients of different size leave the kernel empty
+        kernel.SetElements(Eigen::MatrixX3d::Zero(3, 3), Eigen::VectorXcd::Ones(4));
+        NS_TEST_EXPECT_MSG_EQ(kernel.GetSize(), 0U, "Mismatched sizes");
+
+        // the uncached evaluation of the IRS matches the steering vectors, on every kernel
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 20, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        irs->SetRcoeffs(irs->GetRcoeffs().cwiseProduct(Eigen::VectorXcd::Random(400)));
+        irs->SetCacheCapacity(0);
+        double lambda = 299792458.0 / 5.21e9;
+        for (bool simd : {false, true})
+        {
+            irs->SetSimdKernel(simd);
+            NS_TEST_EXPECT_MSG_EQ(irs->GetSimdKernel(),
+                                  simd && IrsArrayResponseKernel::GetBestIsa() !=
+                                              IrsArrayResponseKernel::SCALAR,
+                                  "SimdKernel");
+            for (double azimuth = -175; azimuth < 180; azimuth += 35)
+            {
+                Angles in(DegreesToRadians(azimuth), DegreesToRadians(20));
+                Angles out(DegreesToRadians(90 - azimuth / 2), DegreesToRadians(-10));
+                IrsEntry expected = irs->CalcIrsEntry(irs->CalcSteeringvector(in, lambda),
+                                                      irs->CalcSteeringvector(out, lambda));
+                std::complex<double> reference = Response(expected);
+                NS_TEST_EXPECT_MSG_LT(
+                    std::abs(Response(irs->CalcIrsEntry(in, out, lambda)) - reference),
+                    1e-10,
+                    "CalcIrsEntry with SimdKernel " << simd);
+                NS_TEST_EXPECT_MSG_LT(
+                    std::abs(Response(irs->GetIrsEntry(in, out, lambda)) - reference),
+                    1e-10,
+                    "Uncached GetIrsEntry with SimdKernel " << simd);
+            }
+        }
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check the FFT reflection pattern against the direct evaluation of the IrsSpectrumModel.
+ */
+class IrsReflectionPatternTestCase : public TestCase
+{
+  public:
+    IrsReflectionPatternTestCase()
+        : TestCase("Check the FFT reflection pattern of the IrsSpectrumModel")
+    {
+    }
+
+  private:
+    /**
+     * @brief Get the largest error of a pattern between its grid points.
+     * @param irs The IRS
+     * @param in Incoming direction
+     * @param oversampling Oversampling of the pattern
+     * @return Largest deviation of the complex response, relative to the largest response
+     */
+    static double MaxError(Ptr<IrsSpectrumModel> irs, Angles in, uint32_t oversampling)
+    {
+        double lambda = 299792458.0 / irs->GetFrequency();
+        IrsReflectionPattern pattern(oversampling);
+        pattern.Compute(*irs, in, lambda);
+        double maxError = 0;
+        double maxResponse = 0;
+        for (double azimuth = -179.3; azimuth < 180; azimuth += 3.7)
+        {
+            for (double inclination = 0.4; inclination < 90; inclination += 6.1)
+            {
+                Angles out(DegreesToRadians(azimuth), DegreesToRadians(inclination));
+                std::complex<double> expected = Response(irs->CalcIrsEntry(in, out, lambda));
+                maxError = std::max(maxError, std::abs(pattern.GetResponse(out) - expected));
+                maxResponse = std::max(maxResponse, std::abs(expected));
+            }
+        }
+        return maxError / maxResponse;
+    }
+
+    void DoRun() override
+    {
+        // an even and an odd number of elements, as the phase center differs
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(16, 11, 5.21e9);
+        IrsLookupTableGenerator::Steer(irs, 135, 45);
+        double lambda = 299792458.0 / 5.21e9;
+        Angles in(DegreesToRadians(135), DegreesToRadians(10));
+        IrsReflectionPattern pattern(4);
+        pattern.Compute(*irs, in, lambda);
+        NS_TEST_EXPECT_MSG_EQ(pattern.GetNumRows(), 64U, "Rows rounded to a power of two");
+        NS_TEST_EXPECT_MSG_EQ(pattern.GetNumColumns(), 64U, "Columns rounded to a power of two");
+
+        // the grid points are exact; with half wavelength spacing the phase steps of the visible
+        // directions span [-pi, pi]
+        double maxError = 0;
+        for (int32_t q = 0; q < 32; q += 3)
+        {
+            double inclination = std::asin(q / 32.0);
+            for (int32_t p = -31; p < 32; p += 3)
+            {
+                double sinAzimuth = p / 32.0 / std::cos(inclination);
+                if (std::abs(sinAzimuth) > 1)
+                {
+                    continue;
+                }
+                Angles out(std::asin(sinAzimuth), inclination);
+                std::complex<double> expected = Response(irs->CalcIrsEntry(in, out, lambda));
+                maxError = std::max(maxError, std::abs(pattern.GetResponse(out) - expected));
+            }
+        }
+        NS_TEST_EXPECT_MSG_LT(maxError, 1e-9 * 16 * 11, "Pattern not exact on the grid");
+
+        // between the grid points the error shrinks with the oversampling
+        double coarse = MaxError(irs, in, 4);
+        double fine = MaxError(irs, in, 16);
+        NS_TEST_EXPECT_MSG_LT(coarse, std::pow(M_PI / 4, 2) / 4, "Error of the coarse pattern");
+        NS_TEST_EXPECT_MSG_LT(fine, coarse / 8, "Finer pattern not more accurate");
+
+        // tables generated from patterns match the direct evaluation within the error bound
+        Ptr<IrsLookupTableGenerator> generator = CreateObject<IrsLookupTableGenerator>();
+        generator->SetThreads(2);
+        generator->SetResolution(5);
+        Ptr<IrsLookupTable> direct = generator->Generate(irs);
+        generator->SetPatternOversampling(16);
+        Ptr<IrsLookupTable> fft = generator->Generate(irs);
+        double floor = direct->GetMaxGain() - 20;
+        for (uint32_t i = 0; i < direct->GetNumAngles(); ++i)
+        {
+            for (uint32_t o = 0; o < direct->GetNumAngles(); ++o)
+            {
+                IrsEntry expected = direct->GetNearestIrsEntry(i * 5.0, o * 5.0);
+                if (expected.gain < floor)
+                {
+                    continue;
+                }
+                IrsEntry entry = fft->GetNearestIrsEntry(i * 5.0, o * 5.0);
+                NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain, expected.gain, 0.5, "FFT table gain");
+            }
+        }
+    }
+};
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Compare the tables of the IrsLookupTableGenerator to the validation tables generated in
+ * Matlab.
+ */
+class IrsLookupTableGeneratorTestCase : public TestCase
+{
+  public:
+    IrsLookupTableGeneratorTestCase()
+        : TestCase("Compare tables of the IrsLookupTableGenerator to lookup tables generated in "
+                   "Matlab.")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// Test vector
+    struct TestVector
+    {
+        string lookuptable; //!< Embedded validation table generated in Matlab
+        double in_angle;    //!< Optimal input azimuth in degrees
+        double out_angle;   //!< Optimal output azimuth in degrees
+        double dApIrsSta;   //!< Length of the path over the IRS in meters
+        double delta;       //!< Phase shift to the LOS path
+        uint32_t numIrs;    //!< Number of IRS sharing the phase shift
+    };
+
+    /// Test vectors
+    TestVectors<TestVector> m_testVectors;
+};
+
+void
+IrsLookupTableGeneratorTestCase::DoRun()
+{
+    // scenarios of matlab/validationDifferentScenarios.m, AP at (0,0,0) and STA at (50,0,0)
+    double multiIrs = std::hypot(0.7, 0.7) + std::hypot(48.6, 1.4) + std::hypot(0.7, 0.7);
+    m_testVectors.Add({"IRS_400_IN135_OUT89_FREQ5.15GHz_constructive",
+                       135,
+                       89,
+                       std::hypot(0.7, 0.7) + std::hypot(49.3, 0.7),
+                       0,
+                       1});
+    m_testVectors.Add({"IRS_400_IN139_OUT89_FREQ5.15GHz_destructive",
+                       139,
+                       89,
+                       std::hypot(1.094, 1.2683) + std::hypot(48.906, 1.2683),
+                       M_PI,
+                       1});
+    m_testVectors.Add({"IRS_400_IN135_OUT88_FREQ5.15GHz_multiIrs1", 135, 88, multiIrs, 0, 2});
+    m_testVectors.Add({"IRS_400_IN92_OUT45_FREQ5.15GHz_multiIrs2", 92, 45, multiIrs, 0, 2});
+
+    Ptr<IrsLookupTableGenerator> generator = CreateObject<IrsLookupTableGenerator>();
+    generator->SetThreads(4);
+    for (uint32_t i = 0; i < m_testVectors.GetN(); ++i)
+    {
+        TestVector tv = m_testVectors.Get(i);
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 20, 5.15e9);
+        IrsLookupTableGenerator::Steer(irs,
+                                       tv.in_angle,
+                                       tv.out_angle,
+                                       50,
+                                       tv.dApIrsSta,
+                                       tv.delta,
+                                       1,
+                                       tv.numIrs);
+        Ptr<IrsLookupTable> table = generator->Generate(irs);
+        Ptr<IrsLookupTable> reference = IrsLookupTableIo::ReadEmbedded(tv.lookuptable);
+        NS_TEST_ASSERT_MSG_EQ(table->GetNumAngles(), 181u, "Table should cover 0 to 180 degrees");
+
+        for (uint8_t in = 0; in <= 180; ++in)
+        {
+            for (uint8_t out = 0; out <= 180; ++out)
+            {
+                IrsEntry entry = table->GetIrsEntry(in, out);
+                IrsEntry expected = reference->GetIrsEntry(in, out);
+                NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain,
+                                          expected.gain,
+                                          1e-6,
+                                          "Unexpected gain: " << +in << " " << +out);
+                NS_TEST_EXPECT_MSG_EQ_TOL(
+                    std::remainder(entry.phase_shift - expected.phase_shift, 2 * M_PI),
+                    0,
+                    1e-6,
+                    "Unexpected phase shift: " << +in << " " << +out);
+            }
+        }
+    }
+
+    // the result does not depend on the number of threads, and matches the cached lookups
+    Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(20, 20, 5.15e9);
+    IrsLookupTableGenerator::Steer(irs, 135, 89);
+    generator->SetThreads(1);
+    Ptr<IrsLookupTable> single = generator->Generate(irs);
+    generator->SetThreads(7);
+    Ptr<IrsLookupTable> multi = generator->Generate(irs);
+    for (uint8_t in = 0; in <= 180; in += 3)
+    {
+        for (uint8_t out = 0; out <= 180; out += 3)
+        {
+            NS_TEST_EXPECT_MSG_EQ(single->GetIrsEntry(in, out).gain,
+                                  multi->GetIrsEntry(in, out).gain,
+                                  "Gain depends on the number of threads");
+            NS_TEST_EXPECT_MSG_EQ_TOL(single->GetIrsEntry(in, out).gain,
+                                      irs->GetIrsEntry(in, out).gain,
+                                      1e-9,
+                                      "Gain differs from IrsSpectrumModel::GetIrsEntry");
+        }
+    }
+}
+
+/**
+ * @ingroup irs-tests
+ *
+ * @brief Check that baking an IrsSpectrumModel yields an equivalent lookup model.
+ */
+class IrsSpectrumModelBakeTestCase : public TestCase
+{
+  public:
+    IrsSpectrumModelBakeTestCase()
+        : TestCase("Check baking an IrsSpectrumModel into a 4D lookup table")
+    {
+    }
+
+  private:
+    void DoRun() override
+    {
+        Ptr<IrsSpectrumModel> irs = IrsLookupTableGenerator::CreateIrs(10, 10, 5.15e9);
+        irs->SetDirection(Vector(0, 1, 0));
+        irs->CalcRCoeffs(Angles(DegreesToRadians(40), DegreesToRadians(30)),
+                         Angles(DegreesToRadians(-60), DegreesToRadians(20)));
+        double lambda = 299792458.0 / 5.15e9;
+
+        Ptr<IrsLookupTableGenerator> generator = CreateObject<IrsLookupTableGenerator>();
+        generator->SetAzimuthResolution(10);
+        generator->SetInclinationResolution(10);
+        IrsLookupTableGenerator::Deviation nearestDeviation;
+        IrsLookupTableGenerator::Deviation interpolatedDeviation;
+        Ptr<IrsLookupModel> nearest = generator->Bake(irs, false, &nearestDeviation);
+        Ptr<IrsLookupModel> interpolated = generator->Bake(irs, true, &interpolatedDeviation);
+        NS_TEST_ASSERT_MSG_EQ(nearest->HasLookupTable4D(), true, "Baked model uses a 4D table");
+        NS_TEST_EXPECT_MSG_EQ(nearest->GetDirection(), irs->GetDirection(), "Direction copied");
+
+        // on the grid, both models return the entries of the IRS up to the quantization
+        for (double inAz : {-180.0, -90.0, 40.0, 170.0})
+        {
+            for (double outIncl : {0.0, 20.0, 90.0})
+            {
+                Angles in(DegreesToRadians(inAz), DegreesToRadians(30));
+                Angles out(DegreesToRadians(-60), DegreesToRadians(outIncl));
+                IrsEntry expected = irs->CalcIrsEntry(in, out, lambda);
+                for (const auto& model : {nearest, interpolated})
+                {
+                    IrsEntry entry = model->GetIrsEntry(in, out, lambda);
+                    NS_TEST_EXPECT_MSG_EQ_TOL(entry.gain,
+                                              std::max(expected.gain, -300.0),
+                                              0.005 + 1e-9,
+                                              "Gain on the grid " << inAz << " " << outIncl);
+                    NS_TEST_EXPECT_MSG_EQ_TOL(
+                        std::remainder(entry.phase_shift - expected.phase_shift, 2 * M_PI),
+                        0,
+                        1e-4,
+                        "Phase shift on the grid " << inAz << " " << outIncl);
+                }
+            }
+        }
+
+        // the report covers the strong directions, interpolation reduces the deviation
+        NS_TEST_EXPECT_MSG_GT(nearestDeviation.samples, 0u, "No directions compared");
+        NS_TEST_EXPECT_MSG_EQ(nearestDeviation.samples,
+                              interpolatedDeviation.samples,
+                              "Both reports should compare the same directions");
+        NS_TEST_EXPECT_MSG_GT(nearestDeviation.gain, 0, "Nearest lookups deviate between grid");
+        NS_TEST_EXPECT_MSG_LT(interpolatedDeviation.gain,
+                              nearestDeviation.gain,
+                              "Interpolation should reduce the deviation");
+        Angles worstIn(DegreesToRadians(nearestDeviation.inAzimuth),
+                       DegreesToRadians(nearestDeviation.inInclination));
+        Angles worstOut(DegreesToRadians(nearestDeviation.outAzimuth),
+                        DegreesToRadians(nearestDeviation.outInclination));
+        NS_TEST_EXPECT_MSG_EQ_TOL(std::abs(nearest->GetIrsEntry(worstIn, worstOut, lambda).gain -
+                                           irs->CalcIrsEntry(worstIn, worstOut, lambda).gain),
+                                  nearestDeviation.gain,
+                                  1e-3,
+                                  "Reported direction should have the reported deviation");
+    }
+};
+
 class IrsSpectrumModelTestSuite : public TestSuite
 {
   public:
@@ -234,6 +1051,15 @@ IrsSpectrumModelTestSuite::IrsSpectrumModelTestSuite()
 {
     AddTestCase(new IrsSpectrumModelTestCase, TestCase::Duration::EXTENSIVE);
     AddTestCase(new IrsSpectrumModelTestCaching, TestCase::Duration::QUICK);
+    AddTestCase(new IrsSpectrumModelSteeringCacheTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsSpectrumModelCacheBoundTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsSpectrumModelGridCacheTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsSpectrumModelSeparableTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsSpectrumModelPhasorRecurrenceTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsArrayResponseKernelTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsReflectionPatternTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsLookupTableGeneratorTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new IrsSpectrumModelBakeTestCase, TestCase::Duration::QUICK);
 }
 
 /// Static variable for test initialization